@@ -5,6 +5,7 @@
 #ifndef UNI_HID_PARSER_H
 #define UNI_HID_PARSER_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 // Forward declarations
@@ -22,6 +23,50 @@ struct hid_globals_s {
 };
 typedef struct hid_globals_s hid_globals_t;
 
+// Input report "extraction plan": the HID descriptor compiled once into a flat
+// list of fields per report ID, so that parsing a report doesn't have to walk
+// the descriptor again. Descriptors that don't fit fall back to the walk.
+//
+// The plan lives in uni_hid_device_t, so it costs ~950 bytes of DRAM per
+// device (x CONFIG_BLUEPAD32_MAX_DEVICES, ~3.8 KB with the default 4). The
+// limits cover gamepads with room to spare (8BitDo: 23 fields, 2 report IDs,
+// 5 globals); keyboards with a bit per key don't fit and use the walk.
+#define UNI_HID_REPORT_PLAN_MAX_OPS 64
+#define UNI_HID_REPORT_PLAN_MAX_GLOBALS 16
+#define UNI_HID_REPORT_PLAN_MAX_IDS 8
+
+#define UNI_HID_REPORT_OP_VARIABLE (1 << 0)  // Variable item. Otherwise "array": value is the usage.
+#define UNI_HID_REPORT_OP_SIGNED (1 << 1)    // Logical minimum < 0: sign-extend the value.
+
+// One field to extract from an input report
+typedef struct {
+    uint16_t bit_pos;     // First bit in the report, report ID byte included
+    uint16_t usage_page;  // Usage page passed to "parse_usage"
+    uint16_t usage;       // Usage passed to "parse_usage" (variable items only)
+    uint8_t size;         // Field size in bits
+    uint8_t flags;        // UNI_HID_REPORT_OP_*
+    uint8_t globals_idx;  // Entry in uni_hid_report_plan_t.globals
+} uni_hid_report_op_t;
+
+// Fields of one report ID: ops[first_op .. first_op + op_count)
+typedef struct {
+    uint16_t report_id;  // 8-bit report ID, or HID_REPORT_ID_UNDEFINED (0xffff)
+    uint16_t first_op;
+    uint16_t op_count;
+} uni_hid_report_plan_entry_t;
+
+typedef struct {
+    bool valid;
+    uint8_t entry_count;
+    uint8_t globals_count;
+    uint16_t op_count;
+    // In descriptor order. Fields without a report ID, if any, come first.
+    uni_hid_report_plan_entry_t entries[UNI_HID_REPORT_PLAN_MAX_IDS];
+    // Globals passed to "parse_usage". Shared by the ops of the same main item.
+    hid_globals_t globals[UNI_HID_REPORT_PLAN_MAX_GLOBALS];
+    uni_hid_report_op_t ops[UNI_HID_REPORT_PLAN_MAX_OPS];
+} uni_hid_report_plan_t;
+
 typedef void (*report_setup_fn_t)(struct uni_hid_device_s* d);
 typedef void (*report_init_report_fn_t)(struct uni_hid_device_s* d);
 typedef void (*report_parse_usage_fn_t)(struct uni_hid_device_s* d,
@@ -73,6 +118,7 @@ typedef struct {
 } uni_report_parser_t;
 
 void uni_hid_parse_input_report(struct uni_hid_device_s* d, const uint8_t* report, uint16_t report_len);
+void uni_hid_parser_compile_plan(uni_hid_report_plan_t* plan, const uint8_t* descriptor, uint16_t descriptor_len);
 int32_t uni_hid_parser_process_axis(const hid_globals_t* globals, uint32_t value);
 int32_t uni_hid_parser_process_pedal(const hid_globals_t* globals, uint32_t value);
 uint8_t uni_hid_parser_process_hat(const hid_globals_t* globals, uint32_t value);
@@ -29,6 +29,12 @@ typedef enum {
     SDP_QUERY_NOT_NEEDED,      // Because the Controller type was inferred by other means.
 } uni_sdp_query_type_t;
 
+// Input report counters, see uni_hid_device_process_controller()
+typedef struct {
+    uint32_t received;  // Controller reports processed while the device was ready
+    uint32_t deduped;   // ...of which dropped because they didn't change the gamepad state
+} uni_hid_report_stats_t;
+
 struct uni_hid_device_s {
     uint32_t cod;  // Class of Device.
     uint16_t vendor_id;
@@ -46,6 +52,8 @@ struct uni_hid_device_s {
     // SDP
     uint8_t hid_descriptor[HID_MAX_DESCRIPTOR_LEN];
     uint16_t hid_descriptor_len;
+    // hid_descriptor precompiled for input reports. See uni_hid_parser_compile_plan().
+    uni_hid_report_plan_t report_plan;
     // DualShock4 1st gen requires to do the SDP query before l2cap connect,
     // otherwise it won't work.
     // And Nintendo Switch Pro gamepad requires to do the SDP query after l2cap
@@ -66,6 +74,13 @@ struct uni_hid_device_s {
     uni_controller_subtype_t controller_subtype;  // sub-type of controller attached, used for Wii mostly
     uni_controller_t controller;                  // Data
 
+    // Last gamepad state (before remapping) sent to the platform. Reports that match it
+    // don't reach uni_gamepad_remap() nor the platform.
+    uni_gamepad_t dedup_gamepad;
+    uint8_t dedup_battery;
+    bool dedup_valid;
+    uni_hid_report_stats_t report_stats;
+
     // Functions used to parse the usage page/usage.
     uni_report_parser_t report_parser;
 
@@ -171,6 +186,8 @@ void uni_hid_device_guess_controller_type_from_pid_vid(uni_hid_device_t* d);
 bool uni_hid_device_has_controller_type(const uni_hid_device_t* d);
 
 void uni_hid_device_process_controller(uni_hid_device_t* d);
+// Safe to call from another task: each counter is a single aligned word.
+void uni_hid_device_get_report_stats(const uni_hid_device_t* d, uni_hid_report_stats_t* out);
 
 void uni_hid_device_set_connection_handle(uni_hid_device_t* d, hci_con_handle_t handle);
 
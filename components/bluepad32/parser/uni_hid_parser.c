@@ -4,8 +4,11 @@
 
 #include "parser/uni_hid_parser.h"
 
+#include <string.h>
+
 #include "hid_usage.h"
 #include "uni_btstack_version_compat.h"
+#include "uni_common.h"
 #include "uni_hid_device.h"
 #include "uni_log.h"
 #include "uni_version.h"
@@ -20,6 +23,184 @@
 #define USE_NEW_PARSER_API 0
 #endif
 
+// Index of "globals" in the plan's globals table, adding it if needed.
+// Returns -1 if the table is full.
+static int plan_globals_index(uni_hid_report_plan_t* plan, const hid_globals_t* globals) {
+    // Consecutive fields usually share the globals of the same main item
+    for (int i = plan->globals_count - 1; i >= 0; i--) {
+        if (memcmp(&plan->globals[i], globals, sizeof(*globals)) == 0)
+            return i;
+    }
+    if (plan->globals_count == UNI_HID_REPORT_PLAN_MAX_GLOBALS)
+        return -1;
+    plan->globals[plan->globals_count] = *globals;
+    return plan->globals_count++;
+}
+
+static int plan_entry_index(const uni_hid_report_plan_t* plan, uint16_t report_id) {
+    for (int i = 0; i < plan->entry_count; i++) {
+        if (plan->entries[i].report_id == report_id)
+            return i;
+    }
+    return -1;
+}
+
+// Compiles the input fields of "descriptor" into "plan", using the same BTstack usage iterator that
+// btstack_hid_parser_has_more() uses, so the fields, their order and their globals are the same ones the
+// per-report walk produces. Two passes: the first one counts the fields of each report ID, the second one
+// places them. Fields without a report ID can only appear before the first "Report ID" item, so they end up
+// in the first entry, and running "no ID" + "report[0]" entries preserves the descriptor order.
+void uni_hid_parser_compile_plan(uni_hid_report_plan_t* plan, const uint8_t* descriptor, uint16_t descriptor_len) {
+    memset(plan, 0, sizeof(*plan));
+
+#if USE_NEW_PARSER_API
+    btstack_hid_usage_iterator_t it;
+    btstack_hid_usage_item_t item;
+
+    // Pass 1: report IDs and number of fields for each one
+    btstack_hid_usage_iterator_init(&it, descriptor, descriptor_len, HID_REPORT_TYPE_INPUT);
+    while (btstack_hid_usage_iterator_has_more(&it)) {
+        btstack_hid_usage_iterator_get_item(&it, &item);
+        int idx = plan_entry_index(plan, item.report_id);
+        if (idx < 0) {
+            if (plan->entry_count == UNI_HID_REPORT_PLAN_MAX_IDS) {
+                logi("HID report plan: more than %d report IDs, using descriptor walk\n", UNI_HID_REPORT_PLAN_MAX_IDS);
+                return;
+            }
+            idx = plan->entry_count++;
+            plan->entries[idx].report_id = item.report_id;
+        }
+        // BTstack reads at most 32 bits per field; wider ones are garbage either way
+        if (item.size > 32) {
+            logi("HID report plan: %d-bit field, using descriptor walk\n", item.size);
+            return;
+        }
+        // Stop as soon as it doesn't fit: a bogus Report Count can make the iterator yield billions of
+        // fields, and the 16-bit counters would wrap back under the limit
+        if (plan->op_count == UNI_HID_REPORT_PLAN_MAX_OPS) {
+            logi("HID report plan: more than %d fields, using descriptor walk\n", UNI_HID_REPORT_PLAN_MAX_OPS);
+            return;
+        }
+        plan->entries[idx].op_count++;
+        plan->op_count++;
+    }
+
+    uint16_t first = 0;
+    for (int i = 0; i < plan->entry_count; i++) {
+        plan->entries[i].first_op = first;
+        first += plan->entries[i].op_count;
+        plan->entries[i].op_count = 0;
+    }
+
+    // Pass 2: fill the ops, grouped by report ID, in descriptor order
+    btstack_hid_usage_iterator_init(&it, descriptor, descriptor_len, HID_REPORT_TYPE_INPUT);
+    while (btstack_hid_usage_iterator_has_more(&it)) {
+        btstack_hid_usage_iterator_get_item(&it, &item);
+
+        // Same globals as uni_hid_parse_input_report() saves before btstack_hid_parser_get_field()
+        hid_globals_t globals;
+        memset(&globals, 0, sizeof(globals));
+        globals.logical_minimum = it.global_logical_minimum;
+        globals.logical_maximum = it.global_logical_maximum;
+        globals.report_count = it.global_report_count;
+        globals.report_id = it.global_report_id;
+        globals.report_size = it.global_report_size;
+        globals.usage_page = it.global_usage_page;
+        int globals_idx = plan_globals_index(plan, &globals);
+        if (globals_idx < 0) {
+            logi("HID report plan: more than %d main items, using descriptor walk\n",
+                 UNI_HID_REPORT_PLAN_MAX_GLOBALS);
+            memset(plan, 0, sizeof(*plan));
+            return;
+        }
+
+        uni_hid_report_plan_entry_t* entry = &plan->entries[plan_entry_index(plan, item.report_id)];
+        uni_hid_report_op_t* op = &plan->ops[entry->first_op + entry->op_count++];
+
+        op->bit_pos = item.bit_pos;
+        // Skip the optional report ID
+        if (item.report_id != HID_REPORT_ID_UNDEFINED)
+            op->bit_pos += 8;
+        op->usage_page = item.usage_page;
+        op->usage = item.usage;
+        op->size = item.size;
+        op->flags = 0;
+        if ((item.descriptor_item.item_value & 2) != 0)
+            op->flags |= UNI_HID_REPORT_OP_VARIABLE;
+        if (item.global_logical_minimum < 0)
+            op->flags |= UNI_HID_REPORT_OP_SIGNED;
+        op->globals_idx = globals_idx;
+    }
+
+    plan->valid = true;
+    logi("HID report plan: %d fields, %d report IDs, %d main items\n", plan->op_count, plan->entry_count,
+         plan->globals_count);
+#else
+    ARG_UNUSED(descriptor);
+    ARG_UNUSED(descriptor_len);
+#endif  // USE_NEW_PARSER_API
+}
+
+// Runs the fields of one report ID. Equivalent to btstack_hid_parser_get_field(), except that fields that
+// don't fit in the report are skipped instead of read past its end.
+static void parse_plan_entry(struct uni_hid_device_s* d,
+                             const uni_hid_report_plan_t* plan,
+                             const uni_hid_report_plan_entry_t* entry,
+                             const uint8_t* report,
+                             uint16_t report_len) {
+    report_parse_usage_fn_t parse_usage = d->report_parser.parse_usage;
+    const uni_hid_report_op_t* op = &plan->ops[entry->first_op];
+    const uni_hid_report_op_t* end = op + entry->op_count;
+
+    for (; op < end; op++) {
+        // Zero-size fields carry no data, but BTstack still reports them (value 0)
+        uint32_t unsigned_value = 0;
+        if (op->size > 0) {
+            int pos_start = op->bit_pos >> 3;
+            int pos_end = (op->bit_pos + op->size - 1) >> 3;
+            if (pos_end >= report_len)
+                continue;
+
+            // Up to 32 bits, like BTstack
+            uint32_t multi_byte_value = 0;
+            for (int i = 0; i <= pos_end - pos_start && i < 4; i++)
+                multi_byte_value |= (uint32_t)report[pos_start + i] << (i * 8);
+            uint32_t mask = (op->size >= 32) ? 0xffffffffu : ((1u << op->size) - 1u);
+            unsigned_value = (multi_byte_value >> (op->bit_pos & 0x07u)) & mask;
+        }
+
+        uint16_t usage;
+        int32_t value;
+        if (op->flags & UNI_HID_REPORT_OP_VARIABLE) {
+            usage = op->usage;
+            if ((op->flags & UNI_HID_REPORT_OP_SIGNED) && op->size > 0 && op->size < 32 &&
+                (unsigned_value & (1u << (op->size - 1u))))
+                value = (int32_t)(unsigned_value - (1u << op->size));
+            else
+                value = (int32_t)unsigned_value;
+        } else {
+            usage = unsigned_value;
+            value = 1;
+        }
+
+        logd("usage_page = 0x%04x, usage = 0x%04x, value = 0x%x\n", op->usage_page, usage, value);
+        parse_usage(d, &plan->globals[op->globals_idx], op->usage_page, usage, value);
+    }
+}
+
+static void parse_with_plan(struct uni_hid_device_s* d, const uint8_t* report, uint16_t report_len) {
+    const uni_hid_report_plan_t* plan = &d->report_plan;
+
+    if (report_len == 0)
+        return;
+
+    for (int i = 0; i < plan->entry_count; i++) {
+        const uni_hid_report_plan_entry_t* entry = &plan->entries[i];
+        if (entry->report_id == HID_REPORT_ID_UNDEFINED || entry->report_id == report[0])
+            parse_plan_entry(d, plan, entry, report, report_len);
+    }
+}
+
 void uni_hid_parse_input_report(struct uni_hid_device_s* d, const uint8_t* report, uint16_t report_len) {
     btstack_hid_parser_t parser;
 
@@ -38,7 +219,10 @@ void uni_hid_parse_input_report(struct uni_hid_device_s* d, const uint8_t* repor
     }
 
     // Devices that suport regular HID reports.
-    if (rp->parse_usage) {
+    // Fast path: the descriptor was compiled when it was set.
+    if (rp->parse_usage && d->report_plan.valid) {
+        parse_with_plan(d, report, report_len);
+    } else if (rp->parse_usage) {
         btstack_hid_parser_init(&parser, d->hid_descriptor, d->hid_descriptor_len, HID_REPORT_TYPE_INPUT, report,
                                 report_len);
         while (btstack_hid_parser_has_more(&parser)) {
@@ -87,6 +271,10 @@ int32_t uni_hid_parser_process_axis(const hid_globals_t* globals, uint32_t value
 
     // Get the range: how big can be the number
     int32_t range = (max - min) + 1;
+    // Bogus descriptor (max < min): nothing to normalize against, and a zero
+    // range would trap on the divide below
+    if (range <= 0)
+        return 0;
 
     // First, we "center" the value, meaning that 0 is when the axis is not used.
     int32_t centered = value - range / 2 - min;
@@ -112,6 +300,9 @@ int32_t uni_hid_parser_process_pedal(const hid_globals_t* globals, uint32_t valu
 
     // Get the range: how big can be the number
     int32_t range = (max - min) + 1;
+    // Bogus descriptor, see uni_hid_parser_process_axis()
+    if (range <= 0)
+        return 0;
     int32_t normalized = value * AXIS_NORMALIZE_RANGE / range;
     logd("original = %d, normalized = %d (range = %d, min=%d, max=%d)\n", value, normalized, range, min, max);
 
@@ -51,6 +51,8 @@ enum {
 };
 
 #define MISC_BUTTON_DELAY_MS 200
+// Axis / pedal changes up to this (out of 512 / 1024) don't count as a new report.
+#define DEDUP_AXIS_DEADBAND 2
 
 static uni_hid_device_t g_devices[CONFIG_BLUEPAD32_MAX_DEVICES];
 static const bd_addr_t zero_addr = {0, 0, 0, 0, 0, 0};
@@ -391,6 +393,9 @@ void uni_hid_device_set_hid_descriptor(uni_hid_device_t* d, const uint8_t* descr
     d->hid_descriptor_len = min;
     d->flags |= FLAGS_HAS_HID_DESCRIPTOR;
 
+    // Compile it once here, instead of walking it on every input report.
+    uni_hid_parser_compile_plan(&d->report_plan, d->hid_descriptor, d->hid_descriptor_len);
+
     //    printf_hexdump(descriptor, len);
 }
 
@@ -538,6 +543,8 @@ void uni_hid_device_dump_device(uni_hid_device_t* d) {
         d->conn.incoming);
     logi("\tmodel: vid=0x%04x, pid=0x%04x, model='%s', name='%s'\n", d->vendor_id, d->product_id,
          uni_gamepad_get_model_name(d->controller_type), d->name);
+    logi("\treports: received=%u, deduped=%u\n", (unsigned)d->report_stats.received,
+         (unsigned)d->report_stats.deduped);
     logi("\tbattery: %d / 255, type=%s\n", d->controller.battery,
          (d->controller.klass == UNI_CONTROLLER_CLASS_GAMEPAD)         ? "gamepad"
          : (d->controller.klass == UNI_CONTROLLER_CLASS_MOUSE)         ? "mouse"
@@ -770,12 +777,54 @@ void uni_hid_device_set_connection_handle(uni_hid_device_t* d, hci_con_handle_t
     d->conn.handle = handle;
 }
 
+static bool axis_within_deadband(int32_t a, int32_t b) {
+    int32_t delta = a - b;
+    return delta >= -DEDUP_AXIS_DEADBAND && delta <= DEDUP_AXIS_DEADBAND;
+}
+
+// Whether the gamepad state is the same as the one sent last time: buttons, dpad, battery and motion
+// sensors exactly, sticks and pedals within DEDUP_AXIS_DEADBAND.
+// The comparison is against the last *sent* state, so a slow drift is still sent once it exceeds the deadband.
+static bool gamepad_unchanged(const uni_hid_device_t* d) {
+    const uni_gamepad_t* gp = &d->controller.gamepad;
+    const uni_gamepad_t* last = &d->dedup_gamepad;
+
+    if (!d->dedup_valid)
+        return false;
+    if (gp->buttons != last->buttons || gp->misc_buttons != last->misc_buttons || gp->dpad != last->dpad ||
+        d->controller.battery != d->dedup_battery)
+        return false;
+    if (memcmp(gp->gyro, last->gyro, sizeof(gp->gyro)) != 0 || memcmp(gp->accel, last->accel, sizeof(gp->accel)) != 0)
+        return false;
+
+    return axis_within_deadband(gp->axis_x, last->axis_x) && axis_within_deadband(gp->axis_y, last->axis_y) &&
+           axis_within_deadband(gp->axis_rx, last->axis_rx) && axis_within_deadband(gp->axis_ry, last->axis_ry) &&
+           axis_within_deadband(gp->brake, last->brake) && axis_within_deadband(gp->throttle, last->throttle);
+}
+
 void uni_hid_device_process_controller(uni_hid_device_t* d) {
     uni_gamepad_t gp;
     if (uni_bt_conn_get_state(&d->conn) != UNI_BT_CONN_STATE_DEVICE_READY) {
         return;
     }
 
+    d->report_stats.received++;
+
+    // Many gamepads send full reports at a fixed rate even when nothing changed. Drop those before the
+    // remap and the platform callback. Only for gamepads: a repeated mouse report is a repeated movement.
+    // The misc-button processing is skipped too. It acts on changes, except for a Switch System press
+    // ignored during MISC_BUTTON_DELAY_MS: misc_button_enable_callback() re-arms the dedup so that a
+    // press still held when the delay ends is seen on the next report.
+    if (d->controller.klass == UNI_CONTROLLER_CLASS_GAMEPAD) {
+        if (gamepad_unchanged(d)) {
+            d->report_stats.deduped++;
+            return;
+        }
+        d->dedup_gamepad = d->controller.gamepad;
+        d->dedup_battery = d->controller.battery;
+        d->dedup_valid = true;
+    }
+
     if (d->controller.klass == UNI_CONTROLLER_CLASS_GAMEPAD) {
         gp = uni_gamepad_remap(&d->controller.gamepad);
         d->controller.gamepad = gp;
@@ -792,6 +841,11 @@ void uni_hid_device_process_controller(uni_hid_device_t* d) {
     process_misc_button_home(d);
 }
 
+void uni_hid_device_get_report_stats(const uni_hid_device_t* d, uni_hid_report_stats_t* out) {
+    out->received = d->report_stats.received;
+    out->deduped = d->report_stats.deduped;
+}
+
 // Try to send the report now. If it can't, queue it and send it in the next
 // event loop.
 void uni_hid_device_send_report(uni_hid_device_t* d, uint16_t cid, const uint8_t* report, uint16_t len) {
@@ -912,6 +966,9 @@ bool uni_hid_device_is_virtual_device(const uni_hid_device_t* d) {
 static void misc_button_enable_callback(btstack_timer_source_t* ts) {
     uni_hid_device_t* d = btstack_run_loop_get_timer_context(ts);
     d->misc_button_wait_delay &= ~MISC_BUTTON_SYSTEM;
+    // A System press made during the delay was ignored. If it is still held, the reports repeat it
+    // and would be deduped: let the next one through so that process_misc_button_system() sees it.
+    d->dedup_valid = false;
 }
 
 // process_mic_button_system
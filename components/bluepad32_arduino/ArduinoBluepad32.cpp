@@ -10,7 +10,8 @@
 #include <uni_version.h>
 #include <uni_virtual_device.h>
 
-Bluepad32::Bluepad32() : _prevConnectedControllers(0), _controllers(), _onConnect(), _onDisconnect() {}
+Bluepad32::Bluepad32()
+    : _prevConnectedControllers(0), _lastGeneration(0), _controllers(), _onConnect(), _onDisconnect() {}
 
 const char* Bluepad32::firmwareVersion() const {
     return "Bluepad32 for Arduino v" UNI_VERSION_STRING;
@@ -21,6 +22,16 @@ bool Bluepad32::update() {
     int connectedControllers = 0;
     int status;
 
+    // Fast path: nothing was published, connected or disconnected since the last call.
+    // Read before the mailboxes, so anything arriving during the scan is seen next time.
+    uint32_t generation = arduino_get_update_generation();
+    if (generation == _lastGeneration) {
+        for (int i = 0; i < BP32_MAX_GAMEPADS; i++)
+            _controllers[i]._hasData = false;
+        return false;
+    }
+    _lastGeneration = generation;
+
     for (int i = 0; i < BP32_MAX_GAMEPADS; i++) {
         status = arduino_get_controller_data(i, &_controllers[i]._data);
         if (status == UNI_ARDUINO_ERROR_INVALID_DEVICE)
@@ -70,6 +81,10 @@ bool Bluepad32::update() {
     return data_updated;
 }
 
+bool Bluepad32::addDataListener(TaskHandle_t task, uint32_t bits) {
+    return arduino_add_data_listener(task, bits) == UNI_ARDUINO_ERROR_SUCCESS;
+}
+
 void Bluepad32::forgetBluetoothKeys() {
     uni_bt_del_keys_safe();
 }
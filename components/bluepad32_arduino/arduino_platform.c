@@ -14,9 +14,13 @@
 #include <esp_chip_info.h>
 #include <esp_console.h>
 #include <esp_ota_ops.h>
+#include <esp_timer.h>
 #include <freertos/queue.h>
 #include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stdatomic.h>
 
+#include "btstack_port_esp32.h"
 #include "bt/uni_bt.h"
 #include "cmd_system.h"
 #include "controller/uni_controller.h"
@@ -35,6 +39,7 @@
 // Globals
 //
 #define MAX_PENDING_REQUESTS 16
+#define MAX_DATA_LISTENERS 4
 
 // Arduino device "instance"
 typedef struct arduino_instance_s {
@@ -45,11 +50,50 @@ typedef struct arduino_instance_s {
 } arduino_instance_t;
 _Static_assert(sizeof(arduino_instance_t) < HID_DEVICE_MAX_PLATFORM_DATA, "Arduino instance too big");
 
+// Per-controller input mailbox. Lock-free, single writer (CPU0) and single
+// reader (CPU1). Double-buffered: the writer fills the slot "seq" does not
+// point at, then advances "seq" to it. The reader copies the current slot
+// and retries if "seq" moved meanwhile, so neither side ever waits.
+typedef struct {
+    arduino_controller_data_t data;
+    arduino_input_timing_t timing;
+} mailbox_entry_t;
+
+typedef struct {
+    mailbox_entry_t slots[2];
+    atomic_uint seq;
+    // For arduino_peek_controller_data(): whether a controller holds the
+    // slot, and "seq" when it connected (older data is the previous one's)
+    atomic_bool connected;
+    atomic_uint connect_seq;
+    // Copy of uni_hid_device_t.report_stats as of the last published report,
+    // so that CPU1 never reads the BTstack-owned device. "deduped" is stored
+    // last (release) and read first (acquire): received >= deduped always.
+    atomic_uint stats_received;
+    atomic_uint stats_deduped;
+} controller_mailbox_t;
+
+// Task notified (eSetBits) whenever new input or a (dis)connection arrives
+typedef struct {
+    TaskHandle_t task;
+    uint32_t bits;
+} data_listener_t;
+
 static QueueHandle_t pending_queue_ = NULL;
 static SemaphoreHandle_t controller_mutex_ = NULL;
 static arduino_controller_t controllers_[CONFIG_BLUEPAD32_MAX_DEVICES];
 static int used_controllers_ = 0;
 
+static controller_mailbox_t mailboxes_[CONFIG_BLUEPAD32_MAX_DEVICES];
+static unsigned int consumed_seq_[CONFIG_BLUEPAD32_MAX_DEVICES];  // CPU1 only
+static arduino_input_timing_t consumed_timing_[CONFIG_BLUEPAD32_MAX_DEVICES];  // CPU1 only
+static atomic_uint update_generation_;
+static data_listener_t listeners_[MAX_DATA_LISTENERS];
+static atomic_int listener_count_;
+
+// Runs process_pending_requests() on the BTstack thread
+static btstack_context_callback_registration_t pending_callback_;
+
 static arduino_instance_t* get_arduino_instance(uni_hid_device_t* d);
 static uint8_t predicate_arduino_index(uni_hid_device_t* d, void* data);
 
@@ -99,6 +143,17 @@ static void arduino_init(int argc, const char** argv) {
     }
 }
 
+// Bump the generation and wake every listener. Called from CPU 0 after the
+// mailbox (or the connection state) has been updated.
+static void notify_listeners(void) {
+    atomic_fetch_add_explicit(&update_generation_, 1, memory_order_release);
+
+    int count = atomic_load_explicit(&listener_count_, memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        xTaskNotify(listeners_[i].task, listeners_[i].bits, eSetBits);
+    }
+}
+
 static uint8_t predicate_arduino_index(uni_hid_device_t* d, void* data) {
     int wanted_idx = (int)data;
     arduino_instance_t* ins = get_arduino_instance(d);
@@ -150,6 +205,20 @@ static void process_pending_requests(void) {
     }
 }
 
+static void pending_requests_callback(void* context) {
+    ARG_UNUSED(context);
+    process_pending_requests();
+}
+
+// Called from CPU 1. Besides being picked up before the next controller data, the request is run
+// on the BTstack thread right away: unchanged reports are dropped before reaching the platform, so
+// on_controller_data() may not be called while the controller is idle.
+static void queue_pending_request(const pending_request_t* request) {
+    xQueueSendToBack(pending_queue_, request, (TickType_t)0);
+    // No-op if it is already scheduled
+    btstack_run_loop_execute_on_main_thread(&pending_callback_);
+}
+
 //
 // Platform Overrides
 //
@@ -159,6 +228,7 @@ static void arduino_on_init_complete(void) {
 
     pending_queue_ = xQueueCreate(MAX_PENDING_REQUESTS, sizeof(pending_request_t));
     assert(pending_queue_ != NULL);
+    pending_callback_.callback = &pending_requests_callback;
 
 #if !CONFIG_AUTOSTART_ARDUINO
     arduino_bootstrap();
@@ -184,8 +254,10 @@ static void arduino_on_device_disconnected(uni_hid_device_t* d) {
 
         memset(&controllers_[ins->controller_idx], 0, sizeof(controllers_[0]));
         controllers_[ins->controller_idx].idx = UNI_ARDUINO_GAMEPAD_INVALID;
+        atomic_store_explicit(&mailboxes_[ins->controller_idx].connected, false, memory_order_release);
 
         ins->controller_idx = UNI_ARDUINO_GAMEPAD_INVALID;
+        notify_listeners();
     }
 }
 
@@ -206,6 +278,12 @@ static uni_error_t arduino_on_device_ready(uni_hid_device_t* d) {
     for (int i = 0; i < CONFIG_BLUEPAD32_MAX_DEVICES; i++) {
         if (controllers_[i].idx == UNI_ARDUINO_GAMEPAD_INVALID) {
             controllers_[i].idx = i;
+            atomic_store_explicit(&mailboxes_[i].stats_received, 0, memory_order_relaxed);
+            atomic_store_explicit(&mailboxes_[i].stats_deduped, 0, memory_order_release);
+            atomic_store_explicit(&mailboxes_[i].connect_seq,
+                                  atomic_load_explicit(&mailboxes_[i].seq, memory_order_relaxed),
+                                  memory_order_relaxed);
+            atomic_store_explicit(&mailboxes_[i].connected, true, memory_order_release);
 
             memcpy(controllers_[i].properties.btaddr, d->conn.btaddr, sizeof(controllers_[0].properties.btaddr));
             controllers_[i].properties.type = d->controller_type;
@@ -228,6 +306,7 @@ static uni_error_t arduino_on_device_ready(uni_hid_device_t* d) {
     if (d->report_parser.set_player_leds != NULL) {
         d->report_parser.set_player_leds(d, ins->controller_idx + 1);
     }
+    notify_listeners();
     return UNI_ERROR_SUCCESS;
 }
 
@@ -241,11 +320,23 @@ static void arduino_on_controller_data(uni_hid_device_t* d, uni_controller_t* ct
         return;
     }
 
-    // Populate gamepad data on shared struct.
-    xSemaphoreTake(controller_mutex_, portMAX_DELAY);
-    controllers_[ins->controller_idx].data = *ctl;
-    controllers_[ins->controller_idx].data_updated = true;
-    xSemaphoreGive(controller_mutex_);
+    // Publish into the mailbox: fill the back slot, then flip to it.
+    controller_mailbox_t* mb = &mailboxes_[ins->controller_idx];
+    unsigned int seq = atomic_load_explicit(&mb->seq, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    mailbox_entry_t* entry = &mb->slots[(seq + 1) & 1];
+    entry->data = *ctl;
+    // We are still handling the HCI packet that carried this report
+    btstack_port_esp32_get_packet_times(&entry->timing.received_us, &entry->timing.delivered_us);
+    entry->timing.published_us = (uint32_t)esp_timer_get_time();
+    atomic_store_explicit(&mb->seq, seq + 1, memory_order_release);
+
+    uni_hid_report_stats_t stats;
+    uni_hid_device_get_report_stats(d, &stats);
+    atomic_store_explicit(&mb->stats_received, stats.received, memory_order_relaxed);
+    atomic_store_explicit(&mb->stats_deduped, stats.deduped, memory_order_release);
+
+    notify_listeners();
 }
 
 static void arduino_on_device_oob_event(uni_platform_oob_event_t event, void* data) {
@@ -280,44 +371,113 @@ uni_hid_device_t* arduino_get_internal_hid_device(int controller_idx) {
 //
 // CPU 1 - Application (Arduino) process
 //
-int arduino_get_gamepad_data(int idx, arduino_gamepad_data_t* out_data) {
-    int ret;
 
+// Copy the latest mailbox entry if it hasn't been consumed yet
+static int read_mailbox(int idx, arduino_controller_data_t* out_data) {
+    controller_mailbox_t* mb = &mailboxes_[idx];
+    unsigned int before = atomic_load_explicit(&mb->seq, memory_order_acquire);
+    if (before == consumed_seq_[idx])
+        return UNI_ARDUINO_ERROR_NO_DATA;
+
+    unsigned int after;
+    do {
+        before = atomic_load_explicit(&mb->seq, memory_order_acquire);
+        *out_data = mb->slots[before & 1].data;
+        consumed_timing_[idx] = mb->slots[before & 1].timing;
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&mb->seq, memory_order_relaxed);
+    } while (before != after);
+
+    consumed_seq_[idx] = before;
+    return UNI_ARDUINO_ERROR_SUCCESS;
+}
+
+int arduino_get_gamepad_data(int idx, arduino_gamepad_data_t* out_data) {
     if (idx < 0 || idx >= CONFIG_BLUEPAD32_MAX_DEVICES)
         return UNI_ARDUINO_ERROR_INVALID_DEVICE;
     if (controllers_[idx].idx == UNI_ARDUINO_GAMEPAD_INVALID)
         return UNI_ARDUINO_ERROR_INVALID_DEVICE;
 
-    ret = UNI_ARDUINO_ERROR_NO_DATA;
-    xSemaphoreTake(controller_mutex_, portMAX_DELAY);
-    if (controllers_[idx].data_updated) {
-        *out_data = controllers_[idx].data.gamepad;
-        controllers_[idx].data_updated = false;
-        ret = UNI_ARDUINO_ERROR_SUCCESS;
-    }
-    xSemaphoreGive(controller_mutex_);
-
+    arduino_controller_data_t data;
+    int ret = read_mailbox(idx, &data);
+    if (ret == UNI_ARDUINO_ERROR_SUCCESS)
+        *out_data = data.gamepad;
     return ret;
 }
 
 int arduino_get_controller_data(int idx, arduino_controller_data_t* out_data) {
-    int ret;
+    if (idx < 0 || idx >= CONFIG_BLUEPAD32_MAX_DEVICES)
+        return UNI_ARDUINO_ERROR_INVALID_DEVICE;
+    if (controllers_[idx].idx == UNI_ARDUINO_GAMEPAD_INVALID)
+        return UNI_ARDUINO_ERROR_INVALID_DEVICE;
+
+    return read_mailbox(idx, out_data);
+}
+
+// Any task: same copy loop as read_mailbox(), without the CPU1-only
+// consumed state
+int arduino_peek_controller_data(int idx,
+                                 arduino_controller_data_t* out_data,
+                                 arduino_input_timing_t* out_timing,
+                                 uint32_t* out_seq) {
+    if (idx < 0 || idx >= CONFIG_BLUEPAD32_MAX_DEVICES)
+        return UNI_ARDUINO_ERROR_INVALID_DEVICE;
+    controller_mailbox_t* mb = &mailboxes_[idx];
+    if (!atomic_load_explicit(&mb->connected, memory_order_acquire))
+        return UNI_ARDUINO_ERROR_INVALID_DEVICE;
+
+    unsigned int before;
+    unsigned int after;
+    do {
+        before = atomic_load_explicit(&mb->seq, memory_order_acquire);
+        *out_data = mb->slots[before & 1].data;
+        if (out_timing != NULL)
+            *out_timing = mb->slots[before & 1].timing;
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&mb->seq, memory_order_relaxed);
+    } while (before != after);
+
+    if (before == atomic_load_explicit(&mb->connect_seq, memory_order_relaxed))
+        return UNI_ARDUINO_ERROR_NO_DATA;
+    if (out_seq != NULL)
+        *out_seq = before;
+    return UNI_ARDUINO_ERROR_SUCCESS;
+}
+
+uint32_t arduino_get_update_generation(void) {
+    return atomic_load_explicit(&update_generation_, memory_order_acquire);
+}
+
+int arduino_get_controller_timing(int idx, arduino_input_timing_t* out) {
+    if (idx < 0 || idx >= CONFIG_BLUEPAD32_MAX_DEVICES)
+        return UNI_ARDUINO_ERROR_INVALID_DEVICE;
 
+    *out = consumed_timing_[idx];
+    return UNI_ARDUINO_ERROR_SUCCESS;
+}
+
+int arduino_get_report_stats(int idx, uint32_t* received, uint32_t* deduped) {
     if (idx < 0 || idx >= CONFIG_BLUEPAD32_MAX_DEVICES)
         return UNI_ARDUINO_ERROR_INVALID_DEVICE;
     if (controllers_[idx].idx == UNI_ARDUINO_GAMEPAD_INVALID)
         return UNI_ARDUINO_ERROR_INVALID_DEVICE;
 
-    ret = UNI_ARDUINO_ERROR_NO_DATA;
-    xSemaphoreTake(controller_mutex_, portMAX_DELAY);
-    if (controllers_[idx].data_updated) {
-        *out_data = controllers_[idx].data;
-        controllers_[idx].data_updated = false;
-        ret = UNI_ARDUINO_ERROR_SUCCESS;
-    }
-    xSemaphoreGive(controller_mutex_);
+    controller_mailbox_t* mb = &mailboxes_[idx];
+    *deduped = atomic_load_explicit(&mb->stats_deduped, memory_order_acquire);
+    *received = atomic_load_explicit(&mb->stats_received, memory_order_relaxed);
+    return UNI_ARDUINO_ERROR_SUCCESS;
+}
 
-    return ret;
+int arduino_add_data_listener(TaskHandle_t task, uint32_t bits) {
+    int count = atomic_load_explicit(&listener_count_, memory_order_relaxed);
+    if (task == NULL || count >= MAX_DATA_LISTENERS)
+        return UNI_ARDUINO_ERROR_INVALID_DEVICE;
+
+    // Fill the entry before publishing the new count to CPU 0
+    listeners_[count].task = task;
+    listeners_[count].bits = bits;
+    atomic_store_explicit(&listener_count_, count + 1, memory_order_release);
+    return UNI_ARDUINO_ERROR_SUCCESS;
 }
 
 int arduino_get_gamepad_properties(int idx, arduino_gamepad_properties_t* out_properties) {
@@ -348,7 +508,7 @@ int arduino_set_player_leds(int idx, uint8_t leds) {
         .cmd = PENDING_REQUEST_CMD_PLAYER_LEDS,
         .args.player_led = leds,
     };
-    xQueueSendToBack(pending_queue_, &request, (TickType_t)0);
+    queue_pending_request(&request);
 
     return UNI_ARDUINO_ERROR_SUCCESS;
 }
@@ -366,7 +526,7 @@ int arduino_set_lightbar_color(int idx, uint8_t r, uint8_t g, uint8_t b) {
         .args.leds[1] = g,
         .args.leds[2] = b,
     };
-    xQueueSendToBack(pending_queue_, &request, (TickType_t)0);
+    queue_pending_request(&request);
 
     return UNI_ARDUINO_ERROR_SUCCESS;
 }
@@ -389,7 +549,7 @@ int arduino_play_dual_rumble(int idx,
         .args.rumble_weak_magnitude = weak_magnitude,
         .args.rumble_strong_magnitude = strong_magnitude,
     };
-    xQueueSendToBack(pending_queue_, &request, (TickType_t)0);
+    queue_pending_request(&request);
 
     return UNI_ARDUINO_ERROR_SUCCESS;
 }
@@ -404,7 +564,7 @@ int arduino_disconnect_controller(int idx) {
         .controller_idx = idx,
         .cmd = PENDING_REQUEST_CMD_DISCONNECT,
     };
-    xQueueSendToBack(pending_queue_, &request, (TickType_t)0);
+    queue_pending_request(&request);
 
     return UNI_ARDUINO_ERROR_SUCCESS;
 }
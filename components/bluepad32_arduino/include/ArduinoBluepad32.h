@@ -23,6 +23,9 @@ class Bluepad32 {
     // each controller
     int _prevConnectedControllers;
 
+    // arduino_get_update_generation() value seen by the last update()
+    uint32_t _lastGeneration;
+
     // This is what the user receives
     Controller _controllers[BP32_MAX_CONTROLLERS];
 
@@ -42,6 +45,11 @@ class Bluepad32 {
     // False otherwise.
     bool update();
 
+    // Wake "task" with xTaskNotify(task, bits, eSetBits) whenever a controller sends new data,
+    // connects or disconnects, so it can block in xTaskNotifyWait() instead of polling update().
+    // Returns false if the listener table is full.
+    bool addDataListener(TaskHandle_t task, uint32_t bits);
+
     // When a controller is paired to the ESP32, the ESP32 stores keys to enable reconnection.
     // If you want to "forget" (delete) the keys from ESP32, you should call this
     // function.
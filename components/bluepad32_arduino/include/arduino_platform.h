@@ -25,6 +25,9 @@ extern "C" {
 
 #include <stdint.h>
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
 #include "controller/uni_controller.h"
 #include "platform/uni_platform.h"
 #include "uni_common.h"
@@ -59,10 +62,10 @@ typedef struct {
 } arduino_controller_properties_t;
 typedef arduino_controller_properties_t arduino_gamepad_properties_t;
 
+// Controller data itself travels through a lock-free per-slot mailbox in
+// arduino_platform.c, not through this struct.
 typedef struct {
     int8_t idx;  // Gamepad index
-    arduino_controller_data_t data;
-    bool data_updated;
 
     // TODO: To reduce RAM, the properties should be calculated at "request time", and
     // not store them "forever".
@@ -87,6 +90,42 @@ int arduino_play_dual_rumble(int idx,
 int arduino_disconnect_controller(int idx);
 int arduino_forget_bluetooth_keys(void);
 
+// Counter bumped (on CPU 0) every time a controller publishes new data, connects or disconnects.
+// Comparing it with a previously read value is a cheap "anything new?" check that takes no lock.
+uint32_t arduino_get_update_generation(void);
+
+// When the controller data last returned by arduino_get_controller_data() / arduino_get_gamepad_data()
+// for a given index went through each stage. esp_timer_get_time() values truncated to 32 bits.
+typedef struct {
+    uint32_t received_us;   // HCI packet handed to the host by the BT controller (VHCI callback)
+    uint32_t delivered_us;  // ...taken by the BTstack thread from the receive ring buffer
+    uint32_t published_us;  // Parsed report published into the mailbox
+} arduino_input_timing_t;
+
+// Timing of the data last read for controller "idx". CPU 1 only, like the data itself.
+int arduino_get_controller_timing(int idx, arduino_input_timing_t* out);
+
+// Latest data published for controller "idx", from any task, without consuming it: BP32.update()
+// still sees every report. For a second reader woken by arduino_add_data_listener(), e.g. a control
+// task on CPU 0. "out_timing" and "out_seq" may be NULL; the sequence advances with every report.
+// Returns UNI_ARDUINO_ERROR_INVALID_DEVICE if no controller holds "idx", UNI_ARDUINO_ERROR_NO_DATA
+// if it hasn't sent a report since it connected.
+int arduino_peek_controller_data(int idx,
+                                 arduino_controller_data_t* out_data,
+                                 arduino_input_timing_t* out_timing,
+                                 uint32_t* out_seq);
+
+// Reports received from controller "idx", and how many of them were dropped because they didn't
+// change the gamepad state (see uni_hid_device_process_controller()). Safe from CPU 1: the counts
+// are copied into the mailbox with each published report, so they are as of the last one and
+// don't move while every report is being dropped.
+int arduino_get_report_stats(int idx, uint32_t* received, uint32_t* deduped);
+
+// Registers a task to be notified with xTaskNotify(task, bits, eSetBits) on the same events as
+// arduino_get_update_generation(). Lets consumers block on xTaskNotifyWait() instead of polling.
+// Call before the first controller connects (e.g. from setup()). Up to 4 listeners.
+int arduino_add_data_listener(TaskHandle_t task, uint32_t bits);
+
 // Returns a uni_hid_device_t* for a giving Controller index. Must be called from the BP32/BTstack thread.
 // Any function that manipulates "uni_hid_device_t" MUST be called from the BTP32/BTstack thread.
 // This function is ONLY for advanced users!
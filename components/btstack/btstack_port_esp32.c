@@ -60,6 +60,7 @@
 #include "hci.h"
 #include "hci_dump.h"
 #include "esp_bt.h"
+#include "esp_timer.h"
 #include "btstack_debug.h"
 #include "btstack_audio.h"
 #include "btstack_port_esp32.h"
@@ -93,11 +94,17 @@ uint32_t hal_time_ms(void) {
 
 static void (*transport_packet_handler)(uint8_t packet_type, uint8_t *packet, uint16_t size);
 
-// ring buffer for incoming HCI packets. Each packet has 2 byte len tag + H4 packet type + packet itself
+// ring buffer for incoming HCI packets. Each packet has a 6 byte tag (2 byte len + 4 byte receive
+// timestamp) + H4 packet type + packet itself
 #define MAX_NR_HOST_EVENT_PACKETS 4
-static uint8_t hci_ringbuffer_storage[HCI_HOST_ACL_PACKET_NUM   * (2 + 1 + HCI_ACL_HEADER_SIZE + HCI_HOST_ACL_PACKET_LEN) +
-                                      HCI_HOST_SCO_PACKET_NUM   * (2 + 1 + HCI_SCO_HEADER_SIZE + HCI_HOST_SCO_PACKET_LEN) +
-                                      MAX_NR_HOST_EVENT_PACKETS * (2 + 1 + HCI_EVENT_BUFFER_SIZE)];
+#define PACKET_TAG_SIZE 6
+static uint8_t hci_ringbuffer_storage[HCI_HOST_ACL_PACKET_NUM   * (PACKET_TAG_SIZE + 1 + HCI_ACL_HEADER_SIZE + HCI_HOST_ACL_PACKET_LEN) +
+                                      HCI_HOST_SCO_PACKET_NUM   * (PACKET_TAG_SIZE + 1 + HCI_SCO_HEADER_SIZE + HCI_HOST_SCO_PACKET_LEN) +
+                                      MAX_NR_HOST_EVENT_PACKETS * (PACKET_TAG_SIZE + 1 + HCI_EVENT_BUFFER_SIZE)];
+
+// esp_timer timestamps of the packet being delivered (main thread only)
+static uint32_t packet_received_us;
+static uint32_t packet_delivered_us;
 
 static btstack_ring_buffer_t hci_ringbuffer;
 
@@ -149,20 +156,23 @@ static int host_recv_pkt_cb(uint8_t *data, uint16_t len){
         return 0;
     }
 
+    uint32_t received_us = (uint32_t) esp_timer_get_time();
+
     xSemaphoreTake(ring_buffer_mutex, portMAX_DELAY);
 
     // check space
     uint16_t space = btstack_ring_buffer_bytes_free(&hci_ringbuffer);
-    if (space < len){
+    if (space < PACKET_TAG_SIZE + len){
         xSemaphoreGive(ring_buffer_mutex);
         log_error("transport_recv_pkt_cb packet %u, space %u -> dropping packet", len, space);
         return 0;
     }
 
-    // store size in ringbuffer
-    uint8_t len_tag[2];
-    little_endian_store_16(len_tag, 0, len);
-    btstack_ring_buffer_write(&hci_ringbuffer, len_tag, sizeof(len_tag));
+    // store size and receive time in ringbuffer
+    uint8_t tag[PACKET_TAG_SIZE];
+    little_endian_store_16(tag, 0, len);
+    little_endian_store_32(tag, 2, received_us);
+    btstack_ring_buffer_write(&hci_ringbuffer, tag, sizeof(tag));
 
     // store in ringbuffer
     btstack_ring_buffer_write(&hci_ringbuffer, data, len);
@@ -192,11 +202,13 @@ static void transport_deliver_packets(void *context){
     xSemaphoreTake(ring_buffer_mutex, portMAX_DELAY);
     while (btstack_ring_buffer_bytes_available(&hci_ringbuffer)){
         uint32_t number_read;
-        uint8_t len_tag[2];
-        btstack_ring_buffer_read(&hci_ringbuffer, len_tag, 2, &number_read);
-        uint32_t len = little_endian_read_16(len_tag, 0);
+        uint8_t tag[PACKET_TAG_SIZE];
+        btstack_ring_buffer_read(&hci_ringbuffer, tag, PACKET_TAG_SIZE, &number_read);
+        uint32_t len = little_endian_read_16(tag, 0);
+        packet_received_us = little_endian_read_32(tag, 2);
         btstack_ring_buffer_read(&hci_ringbuffer, hci_receive_buffer, len, &number_read);
         xSemaphoreGive(ring_buffer_mutex);
+        packet_delivered_us = (uint32_t) esp_timer_get_time();
         transport_packet_handler(hci_receive_buffer[0], &hci_receive_buffer[1], len-1);
         xSemaphoreTake(ring_buffer_mutex, portMAX_DELAY);
     }
@@ -204,6 +216,11 @@ static void transport_deliver_packets(void *context){
 }
 
 
+void btstack_port_esp32_get_packet_times(uint32_t * received_us, uint32_t * delivered_us){
+    *received_us  = packet_received_us;
+    *delivered_us = packet_delivered_us;
+}
+
 /**
  * init transport
  * @param transport_config
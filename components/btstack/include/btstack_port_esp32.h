@@ -53,6 +53,14 @@ extern "C" {
 
 uint8_t btstack_init(void);
 
+/**
+ * Timestamps (esp_timer_get_time(), truncated to 32 bit) of the HCI packet currently being
+ * processed: when the controller handed it to the host (VHCI callback), and when the BTstack
+ * main thread took it from the receive ring buffer. Only meaningful on the main thread, while
+ * handling that packet.
+ */
+void btstack_port_esp32_get_packet_times(uint32_t * received_us, uint32_t * delivered_us);
+
 #if defined __cplusplus
 }
 #endif
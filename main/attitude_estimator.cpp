@@ -0,0 +1,106 @@
+// =============================================================================
+// Attitude Estimator Module - Implementation
+// =============================================================================
+
+#include "attitude_estimator.h"
+#include "config.h"
+#include "debug_log.h"
+
+#include <cmath>
+
+static const char* TAG = "Attitude";
+
+static const float DEG_TO_RAD_F = 3.14159265f / 180.0f;
+static const float TWO_PI_F = 6.28318531f;
+
+// Wrap an angle into (-pi, pi]. Pitch crosses +-pi when the robot is
+// upside-down, so differences must be taken the short way round.
+static float wrapAngle(float a) {
+    while (a > 3.14159265f) { a -= TWO_PI_F; }
+    while (a <= -3.14159265f) { a += TWO_PI_F; }
+    return a;
+}
+
+// =============================================================================
+// Calibration
+// =============================================================================
+
+void AttitudeEstimator::addCalibrationSample(float gyroPitchDps) {
+    if (_calCount == 0) {
+        _calMin = gyroPitchDps;
+        _calMax = gyroPitchDps;
+    } else {
+        if (gyroPitchDps < _calMin) { _calMin = gyroPitchDps; }
+        if (gyroPitchDps > _calMax) { _calMax = gyroPitchDps; }
+    }
+    _calSum += gyroPitchDps;
+    _calCount++;
+}
+
+bool AttitudeEstimator::finishCalibration() {
+    if (_calCount == 0) {
+        LOG_WARN(TAG, "Gyro calibration: no samples, bias left at %.2f deg/s",
+                 _gyroBias / DEG_TO_RAD_F);
+        return false;
+    }
+
+    float meanDps = _calSum / (float)_calCount;
+    float spreadDps = _calMax - _calMin;
+    _gyroBias = meanDps * DEG_TO_RAD_F;
+
+    bool ok = (_calCount >= ATTITUDE_GYRO_CAL_SAMPLES / 2) &&
+              (spreadDps <= ATTITUDE_GYRO_CAL_MAX_SPREAD_DPS);
+    if (ok) {
+        LOG_INFO(TAG, "Gyro bias %.2f deg/s (%lu samples, spread %.2f)",
+                 meanDps, (unsigned long)_calCount, spreadDps);
+    } else {
+        LOG_WARN(TAG, "Gyro calibration noisy (%lu samples, spread %.2f deg/s) -- "
+                 "using %.2f deg/s and refining online",
+                 (unsigned long)_calCount, spreadDps, meanDps);
+    }
+
+    _calCount = 0;
+    _calSum = 0.0f;
+    return ok;
+}
+
+// =============================================================================
+// Filter
+// =============================================================================
+
+float AttitudeEstimator::update(float ax, float ay, float az, float gyroPitchDps, float dt) {
+    // Axis mapping (see BalanceManager::readImu):
+    //   X = vertical (gravity), Y = forward, Z = lateral; pitch rotates about Z
+    _accelPitch = atan2f(-ay, ax);
+    _pitchRate = gyroPitchDps * DEG_TO_RAD_F - _gyroBias;
+
+    if (!_initialized) {
+        _pitch = _accelPitch;
+        _initialized = true;
+        return _pitch;
+    }
+
+    // Gyro prediction
+    float pitch = _pitch + _pitchRate * dt;
+
+    // Accelerometer correction, only when the vector is plausibly gravity
+    float norm = sqrtf(ax * ax + ay * ay + az * az);
+    _accelTrusted = fabsf(norm - 1.0f) < ATTITUDE_ACCEL_GATE_G;
+    if (_accelTrusted) {
+        float err = wrapAngle(_accelPitch - pitch);
+        float alpha = dt / (ATTITUDE_TAU_S + dt);
+        pitch += alpha * err;
+
+        // Persistent error means the gyro is reading high or low: nudge
+        // the bias so the gyro alone would have tracked the accelerometer
+        _gyroBias -= ATTITUDE_BIAS_GAIN * err * dt;
+    }
+
+    _pitch = wrapAngle(pitch);
+    return _pitch;
+}
+
+void AttitudeEstimator::reset() {
+    _initialized = false;
+    _accelTrusted = false;
+}
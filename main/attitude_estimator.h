@@ -0,0 +1,77 @@
+#pragma once
+
+// =============================================================================
+// Attitude Estimator Module
+// =============================================================================
+// Fused pitch estimate from the 6-axis IMU, run at the full IMU rate by the
+// balance task.
+//
+// The accelerometer alone (atan2 of the gravity vector) is corrupted every
+// time the arms swing -- their reaction accelerations show up as tens of
+// degrees of fake pitch. The gyro is clean over short windows but drifts.
+// A complementary filter integrates the gyro and pulls slowly toward the
+// accelerometer pitch with time constant ATTITUDE_TAU_S:
+//
+//   pitch += rate * dt
+//   pitch += (accelPitch - pitch) * dt / (tau + dt)     [only if |a| ~ 1 g]
+//
+// Accelerometer corrections are skipped while |a| is further than
+// ATTITUDE_ACCEL_GATE_G from 1 g (the robot is being shaken, so the vector
+// isn't gravity). The gyro bias is measured at boot while the robot sits
+// still and then tracked slowly from the same accelerometer error.
+//
+// Pure math -- no hardware access, no FreeRTOS -- so it can be fed samples
+// from any source. Not thread-safe; owned by the balance task.
+//
+// Usage:
+//   AttitudeEstimator est;
+//   for (...) est.addCalibrationSample(gz);   // Robot still, at boot
+//   est.finishCalibration();
+//   float pitch = est.update(ax, ay, az, gz, dt);
+// =============================================================================
+
+#include <stdint.h>
+
+class AttitudeEstimator {
+public:
+    // ---- Gyro bias calibration (boot, robot still) ----
+
+    // Accumulate one raw pitch-axis gyro sample (deg/s)
+    void addCalibrationSample(float gyroPitchDps);
+
+    // Compute the bias from the accumulated samples. Returns false if there
+    // were too few samples or the spread shows the robot was moving; the
+    // mean is still used as a starting point and refined online.
+    bool finishCalibration();
+
+    // ---- Filter ----
+
+    // Fuse one IMU sample. accel in g, gyro in deg/s (raw, bias is removed
+    // here), dt in seconds. Returns the fused pitch (rad).
+    float update(float ax, float ay, float az, float gyroPitchDps, float dt);
+
+    // Drop the filter state so the next update() starts from the
+    // accelerometer pitch. Keeps the bias.
+    void reset();
+
+    float getPitch() const { return _pitch; }              // rad (0 = level, - = nose-down)
+    float getPitchRate() const { return _pitchRate; }      // rad/s, bias-corrected
+    float getAccelPitch() const { return _accelPitch; }    // rad, raw atan2 (diagnostics)
+    float getGyroBias() const { return _gyroBias; }        // rad/s
+    bool isAccelTrusted() const { return _accelTrusted; }  // Last update used the accel
+
+private:
+    // Filter state
+    bool _initialized = false;
+    float _pitch = 0.0f;
+    float _pitchRate = 0.0f;
+    float _accelPitch = 0.0f;
+    float _gyroBias = 0.0f;
+    bool _accelTrusted = false;
+
+    // Calibration accumulators
+    uint32_t _calCount = 0;
+    float _calSum = 0.0f;
+    float _calMin = 0.0f;
+    float _calMax = 0.0f;
+};
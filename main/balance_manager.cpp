@@ -0,0 +1,349 @@
+// =============================================================================
+// Balance Manager Module - Implementation
+// =============================================================================
+// IMU read + fused pitch estimate + nose-down balance PID on a pinned FreeRTOS
+// task (see balance_manager.h).
+// =============================================================================
+
+#include "balance_manager.h"
+#include "config.h"
+#include "debug_log.h"
+#include "motor_manager.h"
+#include "flight_recorder.h"
+
+#include <M5Unified.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <cmath>
+#include <cstring>
+
+static const char* TAG = "Balance";
+
+extern MotorManager g_motorManager;
+extern FlightRecorder g_flightRecorder;
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+
+void BalanceManager::begin() {
+    memset(&_state, 0, sizeof(_state));
+
+    // Robot is flat, level and still at boot: average the gyro for its
+    // bias and the accelerometer for the reference orientation.
+    // Axis mapping: X = vertical (gravity), Y = forward, Z = lateral (roll)
+    float accelXSum = 0.0f;
+    for (int i = 0; i < ATTITUDE_GYRO_CAL_SAMPLES; i++) {
+        M5.Imu.update();
+        auto imuData = M5.Imu.getImuData();
+        _attitude.addCalibrationSample(imuData.gyro.z);
+        accelXSum += imuData.accel.x;
+        delay(ATTITUDE_GYRO_CAL_INTERVAL_MS);
+    }
+    _attitude.finishCalibration();
+    _referenceAccelX = accelXSum / (float)ATTITUDE_GYRO_CAL_SAMPLES;
+    LOG_INFO(TAG, "IMU reference accelX=%.3f", _referenceAccelX);
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        balanceTaskFunc,        // Task function
+        "balance",              // Name
+        BALANCE_TASK_STACK,     // Stack size
+        this,                   // Parameter (BalanceManager instance)
+        BALANCE_TASK_PRIORITY,  // Priority
+        NULL,                   // Task handle (not needed)
+        BALANCE_TASK_CORE       // Core ID
+    );
+
+    if (result != pdPASS) {
+        LOG_ERROR(TAG, "Failed to create balance task");
+        return;
+    }
+
+    LOG_INFO(TAG, "Balance task started on CPU%d (prio %d, %d Hz)",
+             BALANCE_TASK_CORE, BALANCE_TASK_PRIORITY, 1000 / IMU_UPDATE_MS);
+}
+
+BalanceState BalanceManager::getState() const {
+    return _published.load();
+}
+
+void BalanceManager::startBalancing(uint8_t leftMotorId, uint8_t rightMotorId) {
+    _leftMotorId.store(leftMotorId, std::memory_order_relaxed);
+    _rightMotorId.store(rightMotorId, std::memory_order_relaxed);
+    _balanceRequested.store(true, std::memory_order_release);
+}
+
+void BalanceManager::stopBalancing() {
+    _balanceRequested.store(false, std::memory_order_release);
+}
+
+// ---------------------------------------------------------------------------
+// Task
+// ---------------------------------------------------------------------------
+
+void BalanceManager::balanceTaskFunc(void* param) {
+    BalanceManager* self = static_cast<BalanceManager*>(param);
+
+    LOG_INFO(TAG, "Balance task running on core %d", xPortGetCoreID());
+
+    TickType_t lastWake = xTaskGetTickCount();
+    uint32_t lastUs = (uint32_t)esp_timer_get_time();
+
+    for (;;) {
+        // Sleep until next tick (IMU_UPDATE_MS)
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(IMU_UPDATE_MS));
+
+        // Real elapsed time since the previous tick. Capped so a stall
+        // (debugger, flash write) can't dump a huge step into the integrator.
+        uint32_t nowUs = (uint32_t)esp_timer_get_time();
+        float dt = (nowUs - lastUs) * 1e-6f;
+        lastUs = nowUs;
+        if (dt > BALANCE_MAX_DT_S) {
+            dt = BALANCE_MAX_DT_S;
+        }
+
+        self->tick(nowUs, dt);
+    }
+}
+
+void BalanceManager::tick(uint32_t nowUs, float dt) {
+    readImu(nowUs, dt);
+
+    bool balancing = _balanceRequested.load(std::memory_order_acquire);
+    if (balancing && !_wasBalancing) {
+        // Fresh start: reset integrator and ramp
+        _pidIntegral = 0.0f;
+        _state.rampProgress = 0.0f;
+#if FLIGHT_REC_AUTO_ARM
+        // Each balance attempt gets a fresh capture, unless the last one
+        // (or one the user froze) has not been downloaded yet...
+        g_flightRecorder.autoArm();
+#endif
+    }
+#if FLIGHT_REC_AUTO_ARM
+    if (!balancing && _wasBalancing) {
+        // ...that ends FLIGHT_REC_POST_TRIGGER ticks after it stops
+        g_flightRecorder.trigger();
+    }
+#endif
+    _wasBalancing = balancing;
+    _state.balancing = balancing;
+
+    if (balancing) {
+        runBalance(dt);
+    }
+
+    publish();
+    recordTick();
+
+    // Periodic IMU telemetry log (every 500ms)
+    static unsigned long s_lastImuLogMs = 0;
+    unsigned long now = millis();
+    if (now - s_lastImuLogMs >= 500) {
+        s_lastImuLogMs = now;
+        float pitchDeg = _state.pitch * (180.0f / PI);
+        LOG_INFO("IMU", "pitch=%.1f deg (acc %.1f)  accel=(%.2f,%.2f,%.2f)  gyro=(%.1f,%.1f,%.1f)  bias=%.2f  flip=%s  dt=%.1f ms",
+                 pitchDeg, _state.accelPitch * (180.0f / PI),
+                 _state.accel[0], _state.accel[1], _state.accel[2],
+                 _state.gyro[0], _state.gyro[1], _state.gyro[2],
+                 _state.gyroBias * (180.0f / PI),
+                 _state.upsideDown ? "YES" : "no", dt * 1000.0f);
+    }
+}
+
+void BalanceManager::readImu(uint32_t nowUs, float dt) {
+    M5.Imu.update();
+    auto data = M5.Imu.getImuData();
+
+    _state.accel[0] = data.accel.x;
+    _state.accel[1] = data.accel.y;
+    _state.accel[2] = data.accel.z;
+    _state.gyro[0] = data.gyro.x;
+    _state.gyro[1] = data.gyro.y;
+    _state.gyro[2] = data.gyro.z;
+    _state.dt = dt;
+    _state.timestampUs = nowUs;
+    _state.tick++;
+
+    // Axis mapping (from empirical data):
+    //   X = vertical (gravity): +1g level, -1g upside-down
+    //   Y = forward:            -1g nose-up, +1g nose-down
+    //   Z = lateral (roll):     +1g left-side-down
+
+    // Pitch angle: 0 = level, negative = nose tilting down, +90 = nose up, -90 = nose down
+    // Gyro Z (pitch axis) integrated at the full tick rate, corrected
+    // toward the accelerometer only while |a| is close to 1 g
+    _state.pitch = _attitude.update(data.accel.x, data.accel.y, data.accel.z, data.gyro.z, dt);
+    _state.accelPitch = _attitude.getAccelPitch();
+    _state.gyroBias = _attitude.getGyroBias();
+
+    // Gyro pitch rate for PID D-term (rad/s, bias removed)
+    _state.gyroPitchRate = _attitude.getPitchRate();
+
+    // Upside-down detection with hysteresis using accel.x (gravity axis)
+    // If accel.x has opposite sign from reference AND exceeds threshold -> upside down
+    // If same sign AND exceeds threshold -> right side up
+    // Otherwise hold previous value
+    if ((data.accel.x * _referenceAccelX) < 0.0f && fabsf(data.accel.x) > IMU_FLIP_THRESHOLD) {
+        _state.upsideDown = true;
+    } else if ((data.accel.x * _referenceAccelX) > 0.0f && fabsf(data.accel.x) > IMU_FLIP_THRESHOLD) {
+        _state.upsideDown = false;
+    }
+    // else: hold previous value (hysteresis in the dead zone)
+}
+
+void BalanceManager::runBalance(float dt) {
+    float pitch = _state.pitch;
+
+    // Pitch-gated ramp: only advance when pitch error is small
+    float errorDeg = fabsf(ND_PITCH_SETPOINT - pitch) * (180.0f / PI);
+    if (errorDeg < ND_RAMP_ERROR_GATE_DEG) {
+        // Pitch is close to setpoint -- advance ramp
+        _state.rampProgress += dt * 1000.0f / (float)ND_ARM_RAMP_MS;
+        if (_state.rampProgress > 1.0f) { _state.rampProgress = 1.0f; }
+    }
+    // else: pitch error too large, freeze ramp and let PID stabilize
+
+    float ramp = _state.rampProgress;
+    float nominalLeft  = ND_TIP_LEFT  + (ND_BALANCE_LEFT  - ND_TIP_LEFT)  * ramp;
+    float nominalRight = ND_TIP_RIGHT + (ND_BALANCE_RIGHT - ND_TIP_RIGHT) * ramp;
+
+    // Compute world-frame angles from vertical for gain scheduling
+    float phiL = -(nominalLeft + PI);
+    float phiR = -(nominalRight + PI);
+    float sensL = -cosf(phiL);
+    float sensR = -cosf(phiR);
+    float totalSens = sensL + sensR;
+
+    // PID error
+    float error = ND_PITCH_SETPOINT - pitch;
+
+    // Integral with anti-windup (measured dt)
+    _pidIntegral += error * dt;
+    if (_pidIntegral > ND_PID_INTEGRAL_LIMIT) {
+        _pidIntegral = ND_PID_INTEGRAL_LIMIT;
+    }
+    if (_pidIntegral < -ND_PID_INTEGRAL_LIMIT) {
+        _pidIntegral = -ND_PID_INTEGRAL_LIMIT;
+    }
+
+    // Derivative from gyro pitch rate (cleaner than differentiating accel)
+    float derivative = -_state.gyroPitchRate;
+
+    // PID output
+    float pidOut = ND_PID_KP * error + ND_PID_KI * _pidIntegral + ND_PID_KD * derivative;
+    if (pidOut > ND_PID_OUTPUT_LIMIT) { pidOut = ND_PID_OUTPUT_LIMIT; }
+    if (pidOut < -ND_PID_OUTPUT_LIMIT) { pidOut = -ND_PID_OUTPUT_LIMIT; }
+
+    // Gain-scheduled offset distribution
+    float leftTarget = nominalLeft;
+    float rightTarget = nominalRight;
+
+    if (fabsf(totalSens) > ND_MIN_SENSITIVITY) {
+        // Uniform mode: both arms move same direction, scaled by total sensitivity
+        float offset = pidOut / totalSens;
+        // Hard clamp to prevent arm position explosions near low-sensitivity zones
+        if (offset > ND_MAX_ARM_OFFSET) { offset = ND_MAX_ARM_OFFSET; }
+        if (offset < -ND_MAX_ARM_OFFSET) { offset = -ND_MAX_ARM_OFFSET; }
+        leftTarget  = nominalLeft  + offset;
+        rightTarget = nominalRight + offset;
+    } else {
+        // Differential mode: arms on opposite sides of zero-crossing
+        float diffSens = sensL - sensR;
+        if (fabsf(diffSens) > ND_MIN_SENSITIVITY) {
+            float diffOffset = pidOut / diffSens;
+            // Hard clamp to prevent arm position explosions
+            if (diffOffset > ND_MAX_ARM_OFFSET) { diffOffset = ND_MAX_ARM_OFFSET; }
+            if (diffOffset < -ND_MAX_ARM_OFFSET) { diffOffset = -ND_MAX_ARM_OFFSET; }
+            leftTarget  = nominalLeft  + diffOffset;
+            rightTarget = nominalRight - diffOffset;
+        }
+        // else: both sensitivities near zero, just follow ramp
+    }
+
+    // One MIT frame per arm
+    MotorManager::MotionCommand cmds[2];
+    int count = 0;
+    uint8_t leftId = _leftMotorId.load(std::memory_order_relaxed);
+    uint8_t rightId = _rightMotorId.load(std::memory_order_relaxed);
+    if (leftId > 0) {
+        cmds[count++] = { leftId, leftTarget, 0.0f, ND_MIT_KP, ND_MIT_KD, 0.0f };
+    }
+    if (rightId > 0) {
+        // Right motor is negated
+        cmds[count++] = { rightId, -rightTarget, 0.0f, ND_MIT_KP, ND_MIT_KD, 0.0f };
+    }
+    if (count > 0) {
+        g_motorManager.sendMotionBatch(cmds, count);
+    }
+
+    _state.nominalLeft = nominalLeft;
+    _state.nominalRight = nominalRight;
+    _state.leftTarget = leftTarget;
+    _state.rightTarget = rightTarget;
+    _state.error = error;
+    _state.pidOut = pidOut;
+    _state.totalSens = totalSens;
+
+    // Periodic PID telemetry (every 250ms)
+    static unsigned long s_lastBalLogMs = 0;
+    unsigned long now = millis();
+    if (now - s_lastBalLogMs >= 250) {
+        s_lastBalLogMs = now;
+        float pitchDeg = pitch * (180.0f / PI);
+        LOG_INFO("NoseDown", "BAL: pitch=%.1f err=%.2f pid=%.2f ramp=%.0f%% nomL=%.2f nomR=%.2f armL=%.2f armR=%.2f sens=%.2f dt=%.1fms",
+                 pitchDeg, error, pidOut, ramp * 100.0f,
+                 nominalLeft, nominalRight, leftTarget, rightTarget, totalSens, dt * 1000.0f);
+    }
+}
+
+void BalanceManager::recordTick() {
+    if (g_flightRecorder.getState() != FlightRecorder::ARMED &&
+        g_flightRecorder.getState() != FlightRecorder::TRIGGERED) {
+        return;
+    }
+
+    FlightRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.timestampUs = _state.timestampUs;
+    rec.pitch = _state.pitch;
+    rec.accelPitch = _state.accelPitch;
+    rec.pitchRate = _state.gyroPitchRate;
+    rec.dt = _state.dt;
+    rec.error = _state.error;
+    rec.pidOut = _state.pidOut;
+    rec.integral = _pidIntegral;
+    rec.rampProgress = _state.rampProgress;
+    rec.leftTarget = _state.leftTarget;
+    rec.rightTarget = _state.rightTarget;
+
+    // Arm feedback straight from the CAN task's snapshot
+    RobstrideMotorStatus fb;
+    uint8_t leftId = _leftMotorId.load(std::memory_order_relaxed);
+    uint8_t rightId = _rightMotorId.load(std::memory_order_relaxed);
+    if (leftId > 0 && g_motorManager.readFeedback(leftId, &fb)) {
+        uint32_t age = _state.timestampUs - fb.lastRxUs;
+        rec.leftPos = fb.position;
+        rec.leftVel = fb.velocity;
+        rec.leftTorque = fb.torque;
+        rec.leftFbAgeUs = (uint16_t)(age > 0xFFFF ? 0xFFFF : age);
+    }
+    if (rightId > 0 && g_motorManager.readFeedback(rightId, &fb)) {
+        uint32_t age = _state.timestampUs - fb.lastRxUs;
+        rec.rightPos = fb.position;
+        rec.rightVel = fb.velocity;
+        rec.rightTorque = fb.torque;
+        rec.rightFbAgeUs = (uint16_t)(age > 0xFFFF ? 0xFFFF : age);
+    }
+
+    if (_state.balancing)           { rec.flags |= FLIGHT_REC_FLAG_BALANCING; }
+    if (_state.upsideDown)          { rec.flags |= FLIGHT_REC_FLAG_UPSIDE_DOWN; }
+    if (_attitude.isAccelTrusted()) { rec.flags |= FLIGHT_REC_FLAG_ACCEL_TRUSTED; }
+
+    g_flightRecorder.record(rec);
+}
+
+void BalanceManager::publish() {
+    _published.store(_state);
+}
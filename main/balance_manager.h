@@ -0,0 +1,104 @@
+#pragma once
+
+// =============================================================================
+// Balance Manager Module
+// =============================================================================
+// Reads the IMU, fuses pitch (AttitudeEstimator), and runs the nose-down balance PID on a
+// dedicated FreeRTOS task, paced by vTaskDelayUntil at IMU_UPDATE_MS.
+//
+// The task runs on CPU1 at a priority above the Arduino loop, so display,
+// web and WiFi work in loop() can delay neither the IMU read nor the PID.
+// The PID integrates over the measured tick interval instead of assuming a
+// fixed dt. While balancing, the task streams MIT setpoints to the arms
+// itself (MotorManager's TX ring is safe to use from any task).
+//
+// The nose-down state machine in loop() still owns the transitions: it
+// calls startBalancing()/stopBalancing() and reads the published state.
+// Outputs are published through a seqlock -- getState() never blocks and
+// never returns a torn snapshot.
+//
+// Usage:
+//   BalanceManager balance;
+//   balance.begin();                          // Calibrates gyro, captures IMU reference, spawns task
+//   BalanceState s = balance.getState();      // Latest attitude + PID outputs
+//   balance.startBalancing(leftId, rightId);  // Arms must already be in MIT mode
+//   balance.stopBalancing();
+// =============================================================================
+
+#include <Arduino.h>
+#include <atomic>
+#include "attitude_estimator.h"
+#include "seqlock.h"
+
+// Snapshot published by the balance task every tick
+struct BalanceState {
+    // ---- Attitude ----
+    float pitch;            // rad, fused (0 = level, negative = nose-down)
+    float accelPitch;       // rad, raw accelerometer atan2 (diagnostics)
+    float gyroPitchRate;    // rad/s (gyro Z, bias-corrected)
+    float gyroBias;         // rad/s, current pitch-axis gyro bias estimate
+    float accel[3];         // g (X = vertical, Y = forward, Z = lateral)
+    float gyro[3];          // deg/s
+    bool upsideDown;        // Gravity axis flipped vs boot reference (with hysteresis)
+    float dt;               // Measured interval since the previous tick (s)
+    uint32_t timestampUs;   // esp_timer time of the IMU read (low 32 bits)
+    uint32_t tick;          // Tick counter
+
+    // ---- Balance PID (valid while balancing) ----
+    bool balancing;
+    float rampProgress;     // Pitch-gated ramp tip -> balance pose [0..1]
+    float nominalLeft;      // Ramp pose (target space, rad)
+    float nominalRight;
+    float leftTarget;       // Commanded arm targets (target space, rad)
+    float rightTarget;
+    float error;            // Pitch error (rad)
+    float pidOut;           // Clamped PID output
+    float totalSens;        // Gain-scheduling sensitivity
+};
+
+class BalanceManager {
+public:
+    // Calibrate the gyro bias and capture the boot orientation (robot flat,
+    // level and still), then spawn the task. Blocks for about
+    // ATTITUDE_GYRO_CAL_SAMPLES * ATTITUDE_GYRO_CAL_INTERVAL_MS.
+    // Call once in setup() after M5.begin().
+    void begin();
+
+    // Latest published state. Lock-free; safe from any task.
+    BalanceState getState() const;
+
+    // Start the balance PID, streaming MIT setpoints to these motor IDs.
+    // Resets the integrator and the ramp. Call after the arms are in MIT mode.
+    void startBalancing(uint8_t leftMotorId, uint8_t rightMotorId);
+
+    // Stop the PID. Takes effect before the next tick; since the task
+    // preempts loop() on the same core, no setpoint goes out after this
+    // returns.
+    void stopBalancing();
+
+private:
+    float _referenceAccelX = 0.0f;
+    AttitudeEstimator _attitude;            // Owned by the balance task after begin()
+
+    // ---- Control requests (loop -> task) ----
+    std::atomic<bool> _balanceRequested{false};
+    std::atomic<uint8_t> _leftMotorId{0};
+    std::atomic<uint8_t> _rightMotorId{0};
+
+    // ---- Task-owned state ----
+    BalanceState _state;                    // Working copy
+    bool _wasBalancing = false;
+    float _pidIntegral = 0.0f;
+
+    // ---- Publication (task -> readers) ----
+    SeqLock<BalanceState> _published;
+
+    void tick(uint32_t nowUs, float dt);
+    void readImu(uint32_t nowUs, float dt);
+    void runBalance(float dt);
+    void publish();
+    void recordTick();      // Flight recorder sample (see flight_recorder.h)
+
+    // FreeRTOS task entry point
+    static void balanceTaskFunc(void* param);
+};
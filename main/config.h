@@ -34,19 +34,36 @@
 
 // -- Web Server Settings -----------------------------------------------------
 #define WEB_SERVER_PORT          80
+#define WEB_JSON_BUFFER_SIZE     6144    // Shared JSON response buffer (allocated once, PSRAM if present)
+#define WEB_LOGS_DEFAULT_LIMIT   200     // /logs lines per response unless ?limit=
+#define WEB_LOGS_MAX_LIMIT       5000    // Upper clamp for ?limit= (chunked, so only bounds handler time)
+#define WEB_WS_RATE_HZ           20      // Default /ws telemetry push rate
+#define WEB_WS_MAX_RATE_HZ       50      // Upper clamp for client "hz=<n>" requests
+#define WEB_WS_MAX_CLIENTS       3       // Concurrent /ws telemetry clients
+#define WEB_WS_TASK_CORE         1       // Telemetry push task (same core as loop)...
+#define WEB_WS_TASK_PRIORITY     1       // ...at loop priority, below balance/drive/CAN
+#define WEB_WS_TASK_STACK        4096    // Stack size in bytes
 
 // -- Controller Settings -----------------------------------------------------
 #define CONTROLLER_MAX_COUNT     4       // Bluepad32 supports up to 4
 #define CONTROLLER_DEADZONE      30      // Joystick dead zone (out of 512)
+#define CONTROLLER_NOTIFY_BIT    0x01    // Task notification bit for "new input"
+#define LOOP_IDLE_WAIT_MS        1       // Max loop() sleep waiting for input
 
 // -- Display Settings --------------------------------------------------------
 #define DISPLAY_UPDATE_MS        200     // 5Hz display refresh rate
 #define DISPLAY_WIDTH            135
 #define DISPLAY_HEIGHT           240
+#define DISPLAY_TASK_CORE        0       // Render + SPI push off the control core (CPU1)...
+#define DISPLAY_TASK_PRIORITY    1       // ...lowest priority, below drive/CAN/BT
+#define DISPLAY_TASK_STACK       4096    // Stack size in bytes
 
 // -- Drive / Servo Settings --------------------------------------------------
-// Drive control loop
-#define DRIVE_UPDATE_MS          10      // 100Hz control loop for low latency
+// Drive control loop: woken by new controller input, and otherwise once per
+// PPM period just before LEDC latches the next pulse
+#define DRIVE_NOTIFY_BIT         0x01    // Task notification bit for "new input"
+#define DRIVE_PPM_LEAD_US        3000    // Idle tick lands this long before a PPM period
+#define DRIVE_INPUT_WATCHDOG_MS  250     // Stop if controller state stops being published
 
 // Expo curve: 0.0 = linear, 1.0 = full cubic.
 // Blends linear and cubic: out = (1-expo)*in + expo*in^3
@@ -58,8 +75,10 @@
 
 // Drive output smoothing (exponential low-pass filter, alpha coefficient).
 // 0.0 = output frozen (never moves), 1.0 = instant response (no smoothing).
-// At 100Hz update rate, 0.5 gives ~33ms rise to 90%, 0.7 gives ~10ms.
+// Alpha is the step per DRIVE_SMOOTHING_STEP_MS and is scaled to the actual
+// time between ticks. 0.5 gives ~33ms rise to 90%, 0.7 gives ~10ms.
 #define DRIVE_SMOOTHING          0.50f
+#define DRIVE_SMOOTHING_STEP_MS  10
 
 // Standard RC servo PPM signal
 #define SERVO_MIN_US             1000    // Full reverse (or minimum throttle)
@@ -82,10 +101,22 @@
 // -- CAN Bus / Motor Settings -----------------------------------------------
 #define CAN_BAUD_RATE            1000000     // 1 Mbps
 #define CAN_MASTER_ID            0xFD        // Our CAN master address
-#define CAN_SCAN_TIMEOUT_MS      300         // Motor scan timeout in ms
+#define CAN_SCAN_TIMEOUT_MS      300         // Wait for late replies after the last probe (ms)
+#define CAN_SCAN_PROBES_PER_PASS 8           // GET_ID probes queued per CAN task wakeup
+#define CAN_TX_QUEUE_LEN         16          // TWAI driver TX queue depth (frames)
+#define CAN_RX_QUEUE_LEN         32          // TWAI driver RX queue depth (frames)
+#define CAN_TASK_CORE            0           // CAN RX/TX task runs on CPU0 (BTstack core)
+#define CAN_TASK_PRIORITY        6           // Above the drive task so feedback is never late
+#define CAN_TASK_STACK           4096        // Stack size in bytes
+#define CAN_TASK_IDLE_MS         5           // Max sleep between alert wakeups (periodic work)
+#define CAN_ALERT_TASK_PRIORITY  7           // Relays TWAI alerts to the CAN task; above it
+#define CAN_ALERT_TASK_STACK     2048        // Stack size in bytes
 #define MOTOR_MAX_COUNT          8           // Max motors tracked
 #define MOTOR_VBUS_POLL_MS       2000        // Voltage re-read interval in ms
-#define MOTOR_STATUS_POLL_MS     100         // Status ping interval per motor (ms)
+#define MOTOR_PARAM_READ_TIMEOUT_MS 200      // Give up on an unanswered param read (ms)
+#define MOTOR_REPORT_PERIOD_MS   10          // Default active report period per motor (ms, >= 10)
+#define MOTOR_STATUS_POLL_MS     100         // Quiet motor: re-arm reporting + fallback ping (ms)
+#define MOTOR_EXTRAPOLATE_MAX_US 20000       // Cap on feedback age used for position extrapolation
 #define MOTOR_STALE_MS           2000        // Mark motor stale after no feedback (ms)
 #define MOTOR_REMOVE_MS          10000       // Remove motor from list after no feedback (ms)
 
@@ -109,6 +140,13 @@
 // -- Motor Trim Settings -----------------------------------------------------
 #define TRIM_STEP_RAD            0.01f   // Position nudge per d-pad press (~0.6 degrees)
 
+// -- Motor Init Sequence -----------------------------------------------------
+#define MOTOR_INIT_STEP_TIMEOUT_MS 100   // Resend a step if not acknowledged within this (ms)
+#define MOTOR_INIT_MAX_ATTEMPTS  3       // Sends per step before the sequence fails
+#define MOTOR_INIT_RETRY_MS      1000    // Backoff before restarting a failed sequence (ms)
+#define MOTOR_INIT_ZERO_TOL_RAD  0.05f   // Position within this of 0 confirms a zero-set
+#define SYS_ZERO_SETTLE_MS       250     // Max wait for zero-set feedback before commanding 0 (ms)
+
 // -- Motor Stick Control Settings --------------------------------------------
 #define STICK_UPDATE_MS          20      // Position command rate (50 Hz)
 #define STICK_MAX_JOG_RAD_S      3.0f   // Max jog speed in rad/s at full stick deflection (~170 deg/s)
@@ -116,8 +154,25 @@
 
 // -- IMU Settings ------------------------------------------------------------
 #define IMU_UPDATE_MS            10      // 100Hz IMU polling (fast for PID balance)
+#define BALANCE_TASK_CORE        1       // IMU + balance task shares CPU1 with loop()...
+#define BALANCE_TASK_PRIORITY    4       // ...but preempts it (loop runs at 1)
+#define BALANCE_TASK_STACK       4096    // Stack size in bytes
+#define BALANCE_MAX_DT_S         0.05f   // Cap on measured dt fed to the PID (s)
 #define IMU_FLIP_THRESHOLD       0.5f   // Accel threshold (g) for upside-down hysteresis
 
+// Attitude estimator (complementary filter, see attitude_estimator.h)
+#define ATTITUDE_TAU_S           0.5f   // Accel correction time constant (s) -- longer = trust gyro more
+#define ATTITUDE_ACCEL_GATE_G    0.15f  // Skip accel correction when ||a| - 1g| exceeds this
+#define ATTITUDE_BIAS_GAIN       0.02f  // Online gyro bias tracking gain (1/s^2)
+#define ATTITUDE_GYRO_CAL_SAMPLES     100    // Boot gyro bias samples (robot must be still)
+#define ATTITUDE_GYRO_CAL_INTERVAL_MS 5      // Spacing between calibration samples (ms)
+#define ATTITUDE_GYRO_CAL_MAX_SPREAD_DPS 3.0f // Max min-to-max gyro spread to accept calibration
+
+// Flight recorder (PSRAM ring of per-tick FlightRecords, see flight_recorder.h)
+#define FLIGHT_REC_CAPACITY      8192    // Records (80 B each, ~82 s at 100 Hz, 640 KB)
+#define FLIGHT_REC_POST_TRIGGER  200     // Records kept after trigger() before stopping (2 s)
+#define FLIGHT_REC_AUTO_ARM      1       // Arm on balance start (keeps undownloaded captures), trigger on stop
+
 // -- Self-Righting Settings (Select button) ----------------------------------
 #define SELF_RIGHT_PREP_POS     -1.79f  // "Up" position (touches ground when inverted)
 #define SELF_RIGHT_PUSH_POS      0.5f   // Slightly past "Front" (strong push)
@@ -147,6 +202,10 @@
 #define ND_MIN_SENSITIVITY       0.2f   // Threshold to switch uniform vs differential mode
 #define ND_MAX_ARM_OFFSET        0.5f   // Hard clamp on per-arm offset (rad) to prevent position explosions
 
+// MIT (OPERATION_CONTROL) streaming while balancing -- one frame per arm per tick
+#define ND_MIT_KP                40.0f  // Arm position stiffness (Nm/rad, RS-02 max 500)
+#define ND_MIT_KD                1.5f   // Arm damping (Nm*s/rad, RS-02 max 5)
+
 // Nose-down setpoint (pitch angle in radians; 0=level, -pi/2=nose-down)
 #define ND_PITCH_SETPOINT       -1.5708f  // -pi/2
 
@@ -161,7 +220,24 @@
 #define ND_PITCH_LOST_DEG        30.0f  // If pitch drops below this during balance, re-enter tipping
 #define ND_EXIT_MS               1200   // Duration of arm sweep to Front (ms)
 
+// -- Profiler ----------------------------------------------------------------
+// Per-stage latency histograms (loop stages, drive task, HTTP) at /metrics
+#define PROFILER_ENABLED         1       // 0 compiles PROFILE_SCOPE out
+#define PROFILER_LOG_MS          2000    // Loop timing log period (per-stage avg/max)
+
 // -- Debug Logging -----------------------------------------------------------
 // Log levels: 0=NONE, 1=ERROR, 2=WARN, 3=INFO, 4=DEBUG
 #define LOG_LEVEL                3       // INFO level by default
 #define LOG_SERIAL_BAUD          115200
+#define LOG_SERIAL_TX_BUFFER     4096    // UART driver TX buffer so Serial writes don't block the drain
+#define LOG_DEFER_SLOTS          64      // Deferred record ring, 128 B each (power of two, internal RAM)
+#define LOG_DRAIN_INTERVAL_MS    10      // Drain task poll period when the ring is empty
+#define LOG_TASK_CORE            0       // Log drain task (formats + writes Serial)...
+#define LOG_TASK_PRIORITY        1       // ...lowest priority, below drive/CAN/BT
+#define LOG_TASK_STACK           4096    // Stack size in bytes
+
+// Log history served by /logs (PSRAM; falls back to a small internal ring)
+#define LOG_HISTORY_ENTRIES      16384   // Indexed lines (power of two, 20 B each)
+#define LOG_HISTORY_BYTES        (768 * 1024)  // Message text ring (~50 B per line)
+#define LOG_HISTORY_FALLBACK_ENTRIES 256         // Without PSRAM
+#define LOG_HISTORY_FALLBACK_BYTES   (16 * 1024)
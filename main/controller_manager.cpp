@@ -4,6 +4,8 @@
 
 #include "controller_manager.h"
 #include "debug_log.h"
+#include "profiler.h"
+#include "seqlock.h"
 #include <Bluepad32.h>
 
 static const char* TAG = "Controller";
@@ -11,9 +13,15 @@ static const char* TAG = "Controller";
 // Bluepad32 raw controller pointers (used in callbacks)
 static ControllerPtr s_rawControllers[BP32_MAX_GAMEPADS] = {nullptr};
 
-// Processed state for each controller slot
+// Processed state for each controller slot (loop-owned)
 static ControllerState s_states[CONTROLLER_MAX_COUNT];
 
+// Copy of s_states published for other tasks at the end of every update()
+static SeqLock<ControllerStates> s_published;
+
+// Loop task (woken by Bluepad32)
+static TaskHandle_t s_loopTask = nullptr;
+
 // Global instance
 ControllerManager g_controllerManager;
 
@@ -82,6 +90,12 @@ void ControllerManager::begin() {
     // Disable BLE service
     BP32.enableBLEService(false);
 
+    // begin() runs on the loop task: have Bluepad32 wake it on new input
+    s_loopTask = xTaskGetCurrentTaskHandle();
+    if (!BP32.addDataListener(s_loopTask, CONTROLLER_NOTIFY_BIT)) {
+        LOG_WARN(TAG, "Input listener table full -- loop will poll");
+    }
+
     LOG_INFO(TAG, "Bluepad32 firmware: %s", BP32.firmwareVersion());
 
     const uint8_t* addr = BP32.localBdAddress();
@@ -90,6 +104,22 @@ void ControllerManager::begin() {
     LOG_INFO(TAG, "Scanning for controllers...");
 }
 
+// Record how long the report just read took to get here, and stamp the
+// state with it so the drive task and loop() can finish the trace.
+static void traceInput(ControllerPtr ctl, ControllerState* state) {
+    arduino_input_timing_t timing;
+    if (arduino_get_controller_timing(ctl->index(), &timing) != UNI_ARDUINO_ERROR_SUCCESS
+        || timing.received_us == 0) {
+        return;
+    }
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    g_profiler.record(PROF_STAGE_IN_HCI, timing.delivered_us - timing.received_us);
+    g_profiler.record(PROF_STAGE_IN_PARSE, timing.published_us - timing.delivered_us);
+    g_profiler.record(PROF_STAGE_IN_LOOP, nowUs - timing.published_us);
+    state->inputRxUs = timing.received_us;
+    state->inputUpdateUs = nowUs;
+}
+
 // BT update rate tracking
 static volatile unsigned long s_btUpdateCount = 0;
 static unsigned long s_btLastLogMs = 0;
@@ -115,12 +145,18 @@ bool ControllerManager::update() {
                 s_states[i].buttons = ctl->buttons();
                 s_states[i].miscButtons = ctl->miscButtons();
                 s_states[i].dpad = ctl->dpad();
+                traceInput(ctl, &s_states[i]);
             } else if (s_rawControllers[i] == nullptr) {
                 s_states[i].connected = false;
             }
         }
     }
 
+    // Publish after BP32.update() so connect/disconnect callbacks are included
+    ControllerStates* published = s_published.beginWrite();
+    memcpy(published->slot, s_states, sizeof(s_states));
+    s_published.endWrite();
+
     // Log BT update rate and button state every 2 seconds
     unsigned long now = millis();
     if ((now - s_btLastLogMs) >= 2000) {
@@ -128,7 +164,7 @@ bool ControllerManager::update() {
         unsigned long elapsed = now - s_btLastLogMs;
         if (elapsed > 0) {
             unsigned long hz = (count * 1000) / elapsed;
-            LOG_INFO(TAG, "BT input rate: %lu Hz (%lu updates in %lu ms)",
+            LOG_INFO(TAG, "BT input rate: %lu Hz (%lu changed reports in %lu ms)",
                      hz, count, elapsed);
         }
         s_btUpdateCount = 0;
@@ -140,6 +176,17 @@ bool ControllerManager::update() {
                 LOG_INFO(TAG, "Slot%d btns=0x%04X misc=0x%04X dpad=0x%02X L2=%d R2=%d",
                          i, s_states[i].buttons, s_states[i].miscButtons,
                          s_states[i].dpad, s_states[i].l2, s_states[i].r2);
+
+                // Reports Bluepad32 dropped on CPU0 because nothing changed
+                uint32_t received = 0;
+                uint32_t deduped = 0;
+                ControllerPtr ctl = s_rawControllers[i];
+                if (ctl && arduino_get_report_stats(ctl->index(), &received, &deduped) == UNI_ARDUINO_ERROR_SUCCESS
+                    && received > 0) {
+                    LOG_INFO(TAG, "Slot%d reports=%lu unchanged=%lu (%lu%% skipped)",
+                             i, (unsigned long)received, (unsigned long)deduped,
+                             (unsigned long)((uint64_t)deduped * 100 / received));
+                }
                 break;
             }
         }
@@ -148,6 +195,42 @@ bool ControllerManager::update() {
     return dataUpdated;
 }
 
+bool ControllerManager::waitForInput(uint32_t timeoutMs) {
+    uint32_t bits = 0;
+    // Clear our bit on exit; a report that lands after this returns leaves
+    // it set, so the next wait falls straight through
+    if (xTaskNotifyWait(0, CONTROLLER_NOTIFY_BIT, &bits, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) {
+        return false;
+    }
+    return (bits & CONTROLLER_NOTIFY_BIT) != 0;
+}
+
+bool ControllerManager::peekInput(int index, ControllerState* out) const {
+    arduino_controller_data_t data;
+    arduino_input_timing_t timing;
+    if (arduino_peek_controller_data(index, &data, &timing, nullptr) != UNI_ARDUINO_ERROR_SUCCESS
+        || data.klass != UNI_CONTROLLER_CLASS_GAMEPAD) {
+        return false;
+    }
+
+    // Same fields and dead zone as update()
+    const arduino_gamepad_data_t& gp = data.gamepad;
+    memset(out, 0, sizeof(*out));
+    out->connected = true;
+    out->lx = applyDeadZone(gp.axis_x);
+    out->ly = applyDeadZone(gp.axis_y);
+    out->rx = applyDeadZone(gp.axis_rx);
+    out->ry = applyDeadZone(gp.axis_ry);
+    out->l2 = gp.brake;
+    out->r2 = gp.throttle;
+    out->buttons = gp.buttons;
+    out->miscButtons = gp.misc_buttons;
+    out->dpad = gp.dpad;
+    out->inputRxUs = timing.received_us;
+    out->inputUpdateUs = timing.published_us;
+    return true;
+}
+
 const ControllerState& ControllerManager::getState(int index) const {
     if (index < 0 || index >= CONTROLLER_MAX_COUNT) {
         static ControllerState emptyState = {};
@@ -156,6 +239,10 @@ const ControllerState& ControllerManager::getState(int index) const {
     return s_states[index];
 }
 
+uint32_t ControllerManager::readStates(ControllerStates* out) const {
+    return s_published.load(out);
+}
+
 int ControllerManager::getConnectedCount() const {
     int count = 0;
     for (int i = 0; i < CONTROLLER_MAX_COUNT; i++) {
@@ -166,7 +253,7 @@ int ControllerManager::getConnectedCount() const {
     return count;
 }
 
-int16_t ControllerManager::applyDeadZone(int16_t value) const {
+int16_t ControllerManager::applyDeadZone(int16_t value) {
     if (value > -CONTROLLER_DEADZONE && value < CONTROLLER_DEADZONE) {
         return 0;
     }
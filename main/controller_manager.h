@@ -6,12 +6,29 @@
 // Wraps Bluepad32 to provide multi-gamepad support with dead zone handling,
 // state tracking, and connection management.
 //
+// update() and the Bluepad32 callbacks run in loop(), which owns the state
+// returned by getState(). Other tasks (the web server, the drive task's
+// loop watchdog) call readStates() instead: update() publishes every slot
+// through a SeqLock, so they always see a whole update, never a half-written
+// one.
+//
+// Input is event-driven: Bluepad32 publishes each report into a lock-free
+// mailbox on CPU0 and notifies the loop task, so update() returns at once
+// when nothing arrived and loop() can sleep in waitForInput() until it does.
+// A task that must not wait for loop() registers with BP32.addDataListener()
+// itself and reads the mailbox through peekInput().
+//
 // Usage:
 //   ControllerManager controllers;
 //   controllers.begin();         // Call once in setup()
 //   controllers.update();        // Call every loop iteration
+//   controllers.waitForInput(1); // End of loop(): sleep until input or 1 ms
 //   const auto& state = controllers.getState(0);
 //   if (state.connected) { ... }
+//   ControllerStates all;
+//   controllers.readStates(&all);  // From any other task
+//   ControllerState input;
+//   controllers.peekInput(0, &input);  // Straight from the mailbox, any task
 // =============================================================================
 
 #include <Arduino.h>
@@ -43,6 +60,15 @@ struct ControllerState {
 
     // Controller info
     char modelName[32];
+
+    // Latency tracing (esp_timer us, truncated to 32 bits; 0 = no report yet)
+    uint32_t inputRxUs;        // Last report's HCI packet reached the host
+    uint32_t inputUpdateUs;    // ...and update() published it (peekInput(): the mailbox did)
+};
+
+// Every controller slot, as published for other tasks
+struct ControllerStates {
+    ControllerState slot[CONTROLLER_MAX_COUNT];
 };
 
 class ControllerManager {
@@ -55,19 +81,35 @@ public:
     // Returns true if any controller data was updated.
     bool update();
 
-    // Get the state of a specific controller (0-3).
+    // Get the state of a specific controller (0-3). loop() only.
     const ControllerState& getState(int index) const;
 
-    // Get the number of currently connected controllers.
+    // Get the number of currently connected controllers. loop() only.
     int getConnectedCount() const;
 
+    // Coherent copy of all slots as of the last update(). Safe from any task.
+    // Returns the publish sequence, which advances on every update().
+    uint32_t readStates(ControllerStates* out) const;
+
+    // Block the loop task until new controller input (or a connect /
+    // disconnect) arrives, or timeoutMs passes. Returns true if woken by
+    // input. loop() only.
+    bool waitForInput(uint32_t timeoutMs);
+
+    // Latest report of Bluepad32 controller "index" straight from its
+    // mailbox, converted as update() does (dead zone applied; modelName
+    // left empty). Lock-free and safe from any task; doesn't consume the
+    // report and doesn't wait for loop(). Returns false if no gamepad is
+    // connected there or it hasn't reported yet.
+    bool peekInput(int index, ControllerState* out) const;
+
     // Static callbacks for Bluepad32 (must be static for C callback interface)
     static void onConnected(ControllerPtr ctl);
     static void onDisconnected(ControllerPtr ctl);
 
 private:
     // Apply dead zone to an axis value
-    int16_t applyDeadZone(int16_t value) const;
+    static int16_t applyDeadZone(int16_t value);
 };
 
 // Global access (needed for Bluepad32 static callbacks)
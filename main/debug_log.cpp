@@ -1,11 +1,36 @@
 // =============================================================================
 // Debug Logging Module - Implementation
 // =============================================================================
+// Producers (any task, either core) claim a slot in a bounded MPSC ring with
+// one compare-and-swap and copy their arguments in. The drain task is the
+// only consumer: it formats each record, frees the slot, then writes the
+// line to Serial and the log history.
+//
+// The deferred ring is the classic bounded queue with a sequence word per
+// slot: a slot at ring position `pos` is free for the producer that claims
+// `pos` when its sequence equals pos, and ready for the consumer when it
+// equals pos + 1. Sequences are stored minus the slot's index, so the
+// zeroed ring in .bss already reads as "every slot free for the first lap":
+// producers can enqueue from the first instruction after boot, before
+// debugLogInit(). It lives in internal RAM -- compare-and-swap doesn't work
+// on PSRAM.
+//
+// The history (PSRAM) has a single writer, so it only needs plain atomic
+// loads/stores: a per-entry seqlock word on the index, and a reserve
+// pointer on the text ring that readers re-check after copying.
+// =============================================================================
 
 #include "debug_log.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <atomic>
+#include <new>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
 static const char* levelNames[] = {
     "NONE",   // 0
@@ -15,14 +40,86 @@ static const char* levelNames[] = {
     "DEBUG"   // 4
 };
 
+static_assert((LOG_DEFER_SLOTS & (LOG_DEFER_SLOTS - 1)) == 0, "LOG_DEFER_SLOTS must be a power of two");
+
+// ---------------------------------------------------------------------------
+// Deferred record ring (MPSC)
+// ---------------------------------------------------------------------------
+struct LogRecord {
+    std::atomic<uint32_t> seq;              // Slot sequence minus slot index (see header comment)
+    uint32_t timestampMs;
+    const char* tag;
+    const char* format;
+    uint8_t level;
+    uint8_t argCount;
+    uint8_t argTypes[LOG_DEFER_MAX_ARGS];   // LogArg::Type per argument
+    uint8_t reserved[2];
+    uint8_t payload[LOG_DEFER_PAYLOAD_BYTES]; // Values in order, strings NUL-terminated inline
+};
+
+static_assert(sizeof(LogRecord) == 128, "LogRecord should stay one 128 B slot");
+
+static LogRecord s_records[LOG_DEFER_SLOTS];
+static std::atomic<uint32_t> s_enqueuePos{0};
+static uint32_t s_dequeuePos = 0;           // Drain task only
+static std::atomic<uint32_t> s_dropped{0};
+
 // ---------------------------------------------------------------------------
-// Ring buffer for web log streaming
+// Log history (written by the drain task only)
 // ---------------------------------------------------------------------------
-static LogEntry s_ring[LOG_RING_SIZE];
-static volatile uint32_t s_ringSeq = 0;     // Next sequence number to assign
-static int s_ringWriteIdx = 0;              // Next slot to write into
+static_assert((LOG_HISTORY_ENTRIES & (LOG_HISTORY_ENTRIES - 1)) == 0, "LOG_HISTORY_ENTRIES must be a power of two");
+static_assert((LOG_HISTORY_FALLBACK_ENTRIES & (LOG_HISTORY_FALLBACK_ENTRIES - 1)) == 0,
+              "LOG_HISTORY_FALLBACK_ENTRIES must be a power of two");
+
+static const uint32_t SEQ_INVALID = 0xFFFFFFFFu;
+
+struct HistoryIndex {
+    std::atomic<uint32_t> seq;      // Seqlock word: SEQ_INVALID while rewriting
+    uint32_t textPos;               // Absolute byte position of the message
+    uint32_t timestampMs;
+    const char* tag;
+    uint16_t len;                   // Message bytes (no terminator stored)
+    uint8_t level;
+    uint8_t reserved;
+};
+
+static HistoryIndex* s_histIndex = nullptr;
+static char* s_histText = nullptr;
+static uint32_t s_histEntries = 0;          // Power of two
+static uint32_t s_histBytes = 0;
+
+static std::atomic<uint32_t> s_histHead{0};         // Next sequence number to assign
+static std::atomic<uint32_t> s_histOldest{0};       // Oldest seq whose text is intact
+static std::atomic<uint32_t> s_textReserve{0};      // Text bytes claimed so far (absolute)
+
+static void logTaskFunc(void* param);
+
+// PSRAM first, then a small internal ring. Returns false if neither fits.
+static bool allocHistory(uint32_t entries, uint32_t bytes, uint32_t caps) {
+    void* index = heap_caps_malloc(entries * sizeof(HistoryIndex), caps);
+    void* text = heap_caps_malloc(bytes, caps);
+    if (index == nullptr || text == nullptr) {
+        heap_caps_free(index);
+        heap_caps_free(text);
+        return false;
+    }
+    s_histIndex = (HistoryIndex*)index;
+    for (uint32_t i = 0; i < entries; i++) {
+        new (&s_histIndex[i].seq) std::atomic<uint32_t>(SEQ_INVALID);
+    }
+    s_histText = (char*)text;
+    s_histEntries = entries;
+    s_histBytes = bytes;
+    return true;
+}
 
 void debugLogInit() {
+    bool inPsram = allocHistory(LOG_HISTORY_ENTRIES, LOG_HISTORY_BYTES, MALLOC_CAP_SPIRAM);
+    if (!inPsram) {
+        allocHistory(LOG_HISTORY_FALLBACK_ENTRIES, LOG_HISTORY_FALLBACK_BYTES, MALLOC_CAP_8BIT);
+    }
+
+    Serial.setTxBufferSize(LOG_SERIAL_TX_BUFFER);
     Serial.begin(LOG_SERIAL_BAUD);
 
     // Wait briefly for serial to be ready
@@ -37,76 +134,499 @@ void debugLogInit() {
     Serial.println("  M5StickC Plus 2");
     Serial.println("========================================");
     Serial.printf("Log level: %s (%d)\n", levelNames[LOG_LEVEL], LOG_LEVEL);
+    Serial.printf("Log history: %lu lines / %lu KB in %s\n",
+                  (unsigned long)s_histEntries, (unsigned long)(s_histBytes / 1024),
+                  inPsram ? "PSRAM" : "internal RAM");
     Serial.println();
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        logTaskFunc,            // Task function
+        "log",                  // Name
+        LOG_TASK_STACK,         // Stack size
+        NULL,                   // Parameter
+        LOG_TASK_PRIORITY,      // Priority
+        NULL,                   // Task handle (not needed)
+        LOG_TASK_CORE           // Core ID
+    );
+    if (result != pdPASS) {
+        Serial.println("Failed to create log task -- logging disabled");
+    }
 }
 
-void debugLog(int level, const char* tag, const char* format, ...) {
-    if (level > LOG_LEVEL) {
-        return;
+// ---------------------------------------------------------------------------
+// Producer side
+// ---------------------------------------------------------------------------
+
+// Append one argument value to the payload. Returns false if it doesn't fit.
+// Strings are truncated to leave `reserve` bytes for the arguments after them.
+static bool packArg(LogRecord& rec, size_t& used, const LogArg& arg, size_t reserve) {
+    const void* src = nullptr;
+    size_t n = 0;
+    switch (arg.type) {
+        case LogArg::I32: case LogArg::U32: case LogArg::F32:
+            src = &arg.u32; n = 4;
+            break;
+        case LogArg::I64: case LogArg::U64: case LogArg::F64:
+            src = &arg.u64; n = 8;
+            break;
+        case LogArg::PTR:
+            src = &arg.ptr; n = sizeof(arg.ptr);
+            break;
+        case LogArg::STR: {
+            // Copy the string itself (truncated to the space left)
+            const char* s = arg.str ? arg.str : "(null)";
+            if (used >= LOG_DEFER_PAYLOAD_BYTES) {
+                return false;
+            }
+            size_t room = LOG_DEFER_PAYLOAD_BYTES - used;
+            room = (room > reserve + 1) ? room - reserve : 1;
+            size_t len = strnlen(s, room - 1);
+            memcpy(rec.payload + used, s, len);
+            rec.payload[used + len] = '\0';
+            used += len + 1;
+            return true;
+        }
+        default:
+            return false;
     }
+    if (used + n > LOG_DEFER_PAYLOAD_BYTES) {
+        return false;
+    }
+    memcpy(rec.payload + used, src, n);
+    used += n;
+    return true;
+}
 
-    // Format: [millis] LEVEL [TAG] message
-    char buffer[256];
-    va_list args;
-    va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
-    va_end(args);
+void debugLogWrite(int level, const char* tag, const char* format,
+                   const LogArg* args, int argCount) {
+    uint32_t timestampMs = millis();
 
-    // Build the full formatted line
-    char fullLine[LOG_ENTRY_MAX_LEN];
-    snprintf(fullLine, sizeof(fullLine), "[%8lu] %-5s [%-10s] %s",
-             millis(), levelNames[level], tag, buffer);
+    // Claim a slot: the one at `pos` is free once the consumer has released
+    // it (seq == pos). Lower means the ring is full -- drop rather than wait.
+    uint32_t pos = s_enqueuePos.load(std::memory_order_relaxed);
+    LogRecord* rec;
+    uint32_t slot;
+    for (;;) {
+        slot = pos & (LOG_DEFER_SLOTS - 1);
+        rec = &s_records[slot];
+        uint32_t seq = rec->seq.load(std::memory_order_acquire) + slot;
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (s_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            s_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = s_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
 
-    // Write to serial
-    Serial.println(fullLine);
+    rec->timestampMs = timestampMs;
+    rec->tag = tag;
+    rec->format = format;
+    rec->level = (uint8_t)level;
+
+    int stored = 0;
+    size_t used = 0;
+    for (int i = 0; i < argCount && i < LOG_DEFER_MAX_ARGS; i++) {
+        size_t reserve = 4 * (size_t)(argCount - i - 1);
+        if (!packArg(*rec, used, args[i], reserve)) {
+            break;
+        }
+        rec->argTypes[i] = args[i].type;
+        stored++;
+    }
+    rec->argCount = (uint8_t)stored;
 
-    // Write to ring buffer
-    LogEntry& entry = s_ring[s_ringWriteIdx];
-    entry.seq = s_ringSeq;
-    strncpy(entry.text, fullLine, LOG_ENTRY_MAX_LEN - 1);
-    entry.text[LOG_ENTRY_MAX_LEN - 1] = '\0';
-    s_ringSeq = s_ringSeq + 1;
-    s_ringWriteIdx = (s_ringWriteIdx + 1) % LOG_RING_SIZE;
+    // Publish to the consumer
+    rec->seq.store(pos + 1 - slot, std::memory_order_release);
 }
 
-uint32_t logRingGetHead() {
-    return s_ringSeq;
+uint32_t debugLogGetDropped() {
+    return s_dropped.load(std::memory_order_relaxed);
 }
 
-int logRingGetSince(uint32_t afterSeq, LogEntry* outBuf, int maxEntries) {
-    // If nothing new, return 0
-    if (s_ringSeq <= afterSeq) {
-        return 0;
+// ---------------------------------------------------------------------------
+// Consumer side (drain task)
+// ---------------------------------------------------------------------------
+
+// A record's arguments, unpacked in order
+struct ArgReader {
+    const LogRecord& rec;
+    int index = 0;
+    size_t offset = 0;
+
+    explicit ArgReader(const LogRecord& r) : rec(r) {}
+
+    // Next argument, or NONE once they run out
+    LogArg next() {
+        LogArg arg;
+        if (index >= rec.argCount) {
+            return arg;
+        }
+        arg.type = (LogArg::Type)rec.argTypes[index++];
+        switch (arg.type) {
+            case LogArg::I32: case LogArg::U32: case LogArg::F32:
+                memcpy(&arg.u32, rec.payload + offset, 4);
+                offset += 4;
+                break;
+            case LogArg::I64: case LogArg::U64: case LogArg::F64:
+                memcpy(&arg.u64, rec.payload + offset, 8);
+                offset += 8;
+                break;
+            case LogArg::PTR:
+                memcpy(&arg.ptr, rec.payload + offset, sizeof(arg.ptr));
+                offset += sizeof(arg.ptr);
+                break;
+            case LogArg::STR:
+                arg.str = (const char*)rec.payload + offset;
+                offset += strlen(arg.str) + 1;
+                break;
+            default:
+                break;
+        }
+        return arg;
     }
+};
 
-    // How many new entries exist?
-    uint32_t available = s_ringSeq - afterSeq;
-    // Can't return more than the ring holds
-    if (available > LOG_RING_SIZE) {
-        available = LOG_RING_SIZE;
-        afterSeq = s_ringSeq - LOG_RING_SIZE;
+static long long argAsSigned(const LogArg& a) {
+    switch (a.type) {
+        case LogArg::I32: return a.i32;
+        case LogArg::U32: return a.u32;
+        case LogArg::I64: return a.i64;
+        case LogArg::U64: return (long long)a.u64;
+        case LogArg::F32: return (long long)a.f32;
+        case LogArg::F64: return (long long)a.f64;
+        default:          return 0;
     }
-    // Can't return more than the caller's buffer
-    if (available > (uint32_t)maxEntries) {
-        // Skip oldest, return the most recent maxEntries
-        afterSeq = s_ringSeq - maxEntries;
-        available = maxEntries;
+}
+
+static double argAsDouble(const LogArg& a) {
+    switch (a.type) {
+        case LogArg::F32: return a.f32;
+        case LogArg::F64: return a.f64;
+        case LogArg::U64: return (double)a.u64;
+        default:          return (double)argAsSigned(a);
     }
+}
+
+// printf with the record's captured arguments. Each conversion is re-issued
+// to snprintf on its own, with the length modifier rewritten to match the
+// captured type.
+static int formatRecord(char* out, size_t size, const LogRecord& rec) {
+    ArgReader args(rec);
+    size_t len = 0;
+    const char* f = rec.format;
+
+    auto append = [&](int n) {
+        if (n > 0) {
+            len += (size_t)n;
+            if (len > size - 1) {
+                len = size - 1;
+            }
+        }
+    };
+
+    while (*f && len < size - 1) {
+        if (*f != '%') {
+            out[len++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[len++] = '%';
+            f += 2;
+            continue;
+        }
 
-    int count = 0;
-    for (uint32_t seq = afterSeq; seq < s_ringSeq && count < maxEntries; seq++) {
-        // Find the ring index for this sequence number
-        // The entry with sequence `seq` was written at index:
-        //   (s_ringWriteIdx - (s_ringSeq - seq)) mod LOG_RING_SIZE
-        int idx = (int)(s_ringWriteIdx - (int)(s_ringSeq - seq));
-        while (idx < 0) { idx += LOG_RING_SIZE; }
-        idx = idx % LOG_RING_SIZE;
+        // Rebuild the spec: flags, width, precision ('*' filled in).
+        // Anything past SPEC_MAX is dropped, leaving room for "ll" + conv.
+        static const size_t SPEC_MAX = 19;
+        char spec[SPEC_MAX + 4];
+        size_t sl = 0;
+        auto specPut = [&](char c) {
+            if (sl < SPEC_MAX) {
+                spec[sl++] = c;
+            }
+        };
+        specPut(*f++);
+        while (*f && strchr("-+ #0", *f)) {
+            specPut(*f++);
+        }
+        for (int part = 0; part < 2; part++) {
+            if (part == 1) {
+                if (*f != '.') {
+                    break;
+                }
+                specPut(*f++);
+            }
+            if (*f == '*') {
+                char num[12];
+                snprintf(num, sizeof(num), "%d", (int)argAsSigned(args.next()));
+                for (const char* c = num; *c; c++) {
+                    specPut(*c);
+                }
+                f++;
+            } else {
+                while (*f >= '0' && *f <= '9') {
+                    specPut(*f++);
+                }
+            }
+        }
+        while (*f && strchr("hlLqjzt", *f)) {
+            f++;
+        }
+        char conv = *f;
+        if (conv == '\0') {
+            break;
+        }
+        f++;
 
-        if (s_ring[idx].seq == seq) {
-            outBuf[count] = s_ring[idx];
-            count++;
+        char* dst = out + len;
+        size_t room = size - len;
+        switch (conv) {
+            case 'd': case 'i': {
+                LogArg a = args.next();
+                if (a.type == LogArg::NONE) { append(snprintf(dst, room, "?")); break; }
+                memcpy(spec + sl, "lld", 4);
+                append(snprintf(dst, room, spec, argAsSigned(a)));
+                break;
+            }
+            case 'u': case 'x': case 'X': case 'o': {
+                LogArg a = args.next();
+                if (a.type == LogArg::NONE) { append(snprintf(dst, room, "?")); break; }
+                // Negative 32-bit values print as 32-bit, like printf would
+                unsigned long long v;
+                switch (a.type) {
+                    case LogArg::I32: v = (uint32_t)a.i32; break;
+                    case LogArg::U64: v = a.u64; break;
+                    default:          v = (unsigned long long)argAsSigned(a); break;
+                }
+                spec[sl] = 'l'; spec[sl + 1] = 'l'; spec[sl + 2] = conv; spec[sl + 3] = '\0';
+                append(snprintf(dst, room, spec, v));
+                break;
+            }
+            case 'c': {
+                LogArg a = args.next();
+                if (a.type == LogArg::NONE) { append(snprintf(dst, room, "?")); break; }
+                spec[sl] = 'c'; spec[sl + 1] = '\0';
+                append(snprintf(dst, room, spec, (int)argAsSigned(a)));
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                LogArg a = args.next();
+                if (a.type == LogArg::NONE) { append(snprintf(dst, room, "?")); break; }
+                spec[sl] = conv; spec[sl + 1] = '\0';
+                append(snprintf(dst, room, spec, argAsDouble(a)));
+                break;
+            }
+            case 's': {
+                LogArg a = args.next();
+                if (a.type != LogArg::STR) { append(snprintf(dst, room, "?")); break; }
+                spec[sl] = 's'; spec[sl + 1] = '\0';
+                append(snprintf(dst, room, spec, a.str));
+                break;
+            }
+            case 'p': {
+                LogArg a = args.next();
+                spec[sl] = 'p'; spec[sl + 1] = '\0';
+                append(snprintf(dst, room, spec, a.type == LogArg::PTR ? a.ptr : nullptr));
+                break;
+            }
+            default:
+                // Unknown conversion -- print it literally
+                append(snprintf(dst, room, "%%%c", conv));
+                break;
         }
     }
+    out[len] = '\0';
+    return (int)len;
+}
 
-    return count;
+// Copy `len` bytes in/out of the text ring at absolute position `pos`
+static void textWrite(uint32_t pos, const char* src, uint32_t len) {
+    uint32_t off = pos % s_histBytes;
+    uint32_t first = (len < s_histBytes - off) ? len : s_histBytes - off;
+    memcpy(s_histText + off, src, first);
+    memcpy(s_histText, src + first, len - first);
+}
+
+static void textRead(uint32_t pos, char* dst, uint32_t len) {
+    uint32_t off = pos % s_histBytes;
+    uint32_t first = (len < s_histBytes - off) ? len : s_histBytes - off;
+    memcpy(dst, s_histText + off, first);
+    memcpy(dst + first, s_histText, len - first);
+}
+
+static void historyPush(int level, const char* tag, uint32_t timestampMs, const char* message) {
+    if (s_histIndex == nullptr) {
+        return;
+    }
+    uint32_t len = strnlen(message, LOG_ENTRY_MAX_LEN - 1);
+    uint32_t seq = s_histHead.load(std::memory_order_relaxed);
+    uint32_t pos = s_textReserve.load(std::memory_order_relaxed);
+
+    // Claim the text bytes first, so a reader copying an older message
+    // from this region sees that it was overwritten
+    uint32_t reserve = pos + len;
+    s_textReserve.store(reserve, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Drop entries whose text this write clobbers, and the entry whose
+    // index slot is about to be reused
+    uint32_t oldest = s_histOldest.load(std::memory_order_relaxed);
+    if (seq - oldest >= s_histEntries) {
+        oldest = seq - s_histEntries + 1;
+    }
+    while (oldest != seq) {
+        const HistoryIndex& old = s_histIndex[oldest & (s_histEntries - 1)];
+        if (reserve - old.textPos <= s_histBytes) {
+            break;
+        }
+        oldest++;
+    }
+    s_histOldest.store(oldest, std::memory_order_release);
+
+    textWrite(pos, message, len);
+
+    HistoryIndex& entry = s_histIndex[seq & (s_histEntries - 1)];
+    entry.seq.store(SEQ_INVALID, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.textPos = pos;
+    entry.timestampMs = timestampMs;
+    entry.tag = tag;
+    entry.len = (uint16_t)len;
+    entry.level = (uint8_t)level;
+    entry.seq.store(seq, std::memory_order_release);
+
+    s_histHead.store(seq + 1, std::memory_order_release);
+}
+
+static void emitLine(int level, const char* tag, uint32_t timestampMs, const char* message) {
+    LogLine line;
+    line.timestampMs = timestampMs;
+    line.level = (uint8_t)level;
+    line.tag = tag;
+    strncpy(line.text, message, LOG_ENTRY_MAX_LEN - 1);
+    line.text[LOG_ENTRY_MAX_LEN - 1] = '\0';
+
+    char fullLine[LOG_LINE_MAX_LEN];
+    logFormatLine(line, fullLine, sizeof(fullLine));
+    Serial.println(fullLine);
+    historyPush(level, tag, timestampMs, line.text);
+}
+
+// Format and emit the oldest record. Returns false if the ring is empty.
+static bool drainOne() {
+    uint32_t slot = s_dequeuePos & (LOG_DEFER_SLOTS - 1);
+    LogRecord& rec = s_records[slot];
+    if (rec.seq.load(std::memory_order_acquire) + slot != s_dequeuePos + 1) {
+        return false;
+    }
+
+    char message[LOG_ENTRY_MAX_LEN];
+    formatRecord(message, sizeof(message), rec);
+    int level = rec.level;
+    const char* tag = rec.tag;
+    uint32_t timestampMs = rec.timestampMs;
+
+    // Hand the slot back before the (slower) output
+    rec.seq.store(s_dequeuePos + LOG_DEFER_SLOTS - slot, std::memory_order_release);
+    s_dequeuePos++;
+
+    emitLine(level, tag, timestampMs, message);
+    return true;
+}
+
+static void logTaskFunc(void* param) {
+    uint32_t reportedDrops = 0;
+
+    for (;;) {
+        while (drainOne()) {
+        }
+
+        uint32_t dropped = s_dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops) {
+            char message[64];
+            snprintf(message, sizeof(message), "%lu log records dropped (ring full)",
+                     (unsigned long)(dropped - reportedDrops));
+            emitLine(LOG_LEVEL_WARN, "Log", millis(), message);
+            reportedDrops = dropped;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// History readers (any task)
+// ---------------------------------------------------------------------------
+
+uint32_t logHistoryGetHead() {
+    return s_histHead.load(std::memory_order_acquire);
+}
+
+uint32_t logHistoryGetOldest() {
+    return s_histOldest.load(std::memory_order_acquire);
+}
+
+uint32_t logHistoryGetCapacity() {
+    return s_histEntries;
+}
+
+bool logHistoryRead(uint32_t seq, LogLine* out) {
+    if (s_histIndex == nullptr) {
+        return false;
+    }
+    const HistoryIndex& entry = s_histIndex[seq & (s_histEntries - 1)];
+    if (entry.seq.load(std::memory_order_acquire) != seq) {
+        return false;
+    }
+    uint32_t textPos = entry.textPos;
+    uint32_t len = entry.len;
+    out->seq = seq;
+    out->timestampMs = entry.timestampMs;
+    out->level = entry.level;
+    out->tag = entry.tag;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (entry.seq.load(std::memory_order_relaxed) != seq || len >= LOG_ENTRY_MAX_LEN) {
+        return false;
+    }
+
+    // The text is valid if the writer hasn't claimed past it by a full lap
+    textRead(textPos, out->text, len);
+    out->text[len] = '\0';
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s_textReserve.load(std::memory_order_relaxed) - textPos <= s_histBytes;
+}
+
+int logFormatLine(const LogLine& line, char* out, size_t size) {
+    int n = snprintf(out, size, "[%8lu] %-5s [%-10s] %s",
+                     (unsigned long)line.timestampMs, logLevelName(line.level),
+                     line.tag, line.text);
+    if (n < 0) {
+        return 0;
+    }
+    return (size_t)n < size ? n : (int)size - 1;
+}
+
+const char* logLevelName(int level) {
+    if (level < LOG_LEVEL_NONE || level > LOG_LEVEL_DEBUG) {
+        return "?";
+    }
+    return levelNames[level];
+}
+
+int logLevelFromName(const char* name) {
+    if (name[0] >= '0' && name[0] <= '9') {
+        int level = atoi(name);
+        return (level <= LOG_LEVEL_DEBUG) ? level : -1;
+    }
+    for (int level = LOG_LEVEL_ERROR; level <= LOG_LEVEL_DEBUG; level++) {
+        if (strcasecmp(name, levelNames[level]) == 0) {
+            return level;
+        }
+    }
+    return -1;
 }
@@ -6,12 +6,24 @@
 // Provides severity-level logging over Serial.
 // Uses Arduino Serial (Bluepad32 console is disabled in sdkconfig.defaults).
 //
+// Logging is deferred: a LOG_* call only captures the tag, the format-string
+// pointer, a timestamp and the raw argument values into a fixed-size binary
+// record, and pushes it into a lock-free multi-producer ring. A low-priority
+// drain task formats the records and writes them to Serial and to the web
+// log ring (/logs). Hot paths on either core never format or block on the
+// UART; if the ring is full the record is dropped and counted.
+//
+// Because formatting happens later, the tag and format string must be
+// string literals (or otherwise static). %s arguments are copied into the
+// record, so temporaries such as String::c_str() are fine.
+//
 // Usage:
 //   LOG_INFO("WiFi", "Connected to %s", ssid);
 //   LOG_ERROR("CAN", "Transmit failed: %d", err);
 // =============================================================================
 
 #include <Arduino.h>
+#include <type_traits>
 #include "config.h"
 
 // Log level definitions
@@ -21,29 +33,109 @@
 #define LOG_LEVEL_INFO   3
 #define LOG_LEVEL_DEBUG  4
 
-// Initialize the debug logging system (call once in setup)
+// Initialize the debug logging system and start the drain task (call once
+// in setup). Records logged earlier wait in the deferred ring and are
+// printed once the drain task runs; past LOG_DEFER_SLOTS they are dropped
+// and counted like any other overflow.
 void debugLogInit();
 
+// ---------------------------------------------------------------------------
+// Deferred records
+// ---------------------------------------------------------------------------
+#define LOG_DEFER_MAX_ARGS       12      // Arguments per call (extra ones print as "?")
+#define LOG_DEFER_PAYLOAD_BYTES  96      // Packed argument values + copied strings
+
+// One argument captured by value at the call site
+struct LogArg {
+    enum Type : uint8_t { NONE, I32, U32, I64, U64, F32, F64, STR, PTR };
+
+    Type type;
+    union {
+        int32_t i32;
+        uint32_t u32;
+        int64_t i64;
+        uint64_t u64;
+        float f32;
+        double f64;
+        const char* str;
+        const void* ptr;
+    };
+
+    LogArg() : type(NONE), u64(0) {}
+    LogArg(float v) : type(F32), f32(v) {}
+    LogArg(double v) : type(F64), f64(v) {}
+    LogArg(const char* v) : type(STR), str(v) {}
+    LogArg(const void* v) : type(PTR), ptr(v) {}
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    LogArg(T v) {
+        if (sizeof(T) > 4) {
+            if (std::is_signed<T>::value) { type = I64; i64 = (int64_t)v; }
+            else                          { type = U64; u64 = (uint64_t)v; }
+        } else {
+            if (std::is_signed<T>::value) { type = I32; i32 = (int32_t)v; }
+            else                          { type = U32; u32 = (uint32_t)v; }
+        }
+    }
+
+    template <typename T, typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+    LogArg(T v) : LogArg((typename std::underlying_type<T>::type)v) {}
+};
+
+// Enqueue one record -- called by debugLog(), use the macros below
+void debugLogWrite(int level, const char* tag, const char* format,
+                   const LogArg* args, int argCount);
+
 // Core logging function - prefer the macros below
-void debugLog(int level, const char* tag, const char* format, ...);
+template <typename... Args>
+inline void debugLog(int level, const char* tag, const char* format, Args... args) {
+    if (level > LOG_LEVEL) {
+        return;
+    }
+    // Trailing NONE keeps the array non-empty for argument-less calls
+    const LogArg packed[] = { LogArg(args)..., LogArg() };
+    debugLogWrite(level, tag, format, packed, (int)sizeof...(Args));
+}
+
+// Records dropped because the deferred ring was full (since boot)
+uint32_t debugLogGetDropped();
 
 // ---------------------------------------------------------------------------
-// Log ring buffer for web streaming
+// Log history (web /logs)
 // ---------------------------------------------------------------------------
-#define LOG_RING_SIZE       30      // Number of entries in the ring buffer
-#define LOG_ENTRY_MAX_LEN   140     // Max characters per log entry (truncated)
+// Every emitted line is also kept in a history ring in PSRAM (see
+// LOG_HISTORY_* in config.h): message text in a byte ring, plus an index
+// entry per line so any sequence number is an O(1) lookup. Written only by
+// the drain task; readers on any task get whole entries or nothing.
+#define LOG_ENTRY_MAX_LEN   160     // Max characters per log message (truncated)
+#define LOG_LINE_MAX_LEN    (LOG_ENTRY_MAX_LEN + 32)   // Message plus "[millis] LEVEL [TAG] "
 
-struct LogEntry {
+struct LogLine {
     uint32_t seq;                           // Monotonic sequence number
-    char text[LOG_ENTRY_MAX_LEN];           // Pre-formatted log line
+    uint32_t timestampMs;
+    uint8_t level;                          // LOG_LEVEL_*
+    const char* tag;                        // Static tag string
+    char text[LOG_ENTRY_MAX_LEN];           // Formatted message (no prefix)
 };
 
-// Returns the current sequence number (latest entry written)
-uint32_t logRingGetHead();
+// Sequence number the next line will get (one past the newest)
+uint32_t logHistoryGetHead();
+
+// Oldest sequence number still held
+uint32_t logHistoryGetOldest();
+
+// Entries the history can index
+uint32_t logHistoryGetCapacity();
+
+// Copy line `seq`. Returns false if it was overwritten or not written yet.
+bool logHistoryRead(uint32_t seq, LogLine* out);
+
+// Format a line as "[millis] LEVEL [TAG] message". Returns its length.
+int logFormatLine(const LogLine& line, char* out, size_t size);
 
-// Copy entries with seq > afterSeq into outBuf (up to maxEntries).
-// Returns number of entries copied. Entries are in chronological order.
-int logRingGetSince(uint32_t afterSeq, LogEntry* outBuf, int maxEntries);
+// Level name ("ERROR", ...), and back (-1 if unknown; digits accepted)
+const char* logLevelName(int level);
+int logLevelFromName(const char* name);
 
 // Convenience macros with compile-time level filtering
 #if LOG_LEVEL >= LOG_LEVEL_ERROR
@@ -5,12 +5,13 @@
 #include "display_manager.h"
 #include "config.h"
 #include "debug_log.h"
-#include "wifi_manager.h"
-#include "controller_manager.h"
-#include "drive_manager.h"
-#include "motor_manager.h"
+#include "profiler.h"
 
 #include <M5Unified.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <math.h>
+#include <string.h>
 
 static const char* TAG = "Display";
 
@@ -23,96 +24,370 @@ static const uint16_t COLOR_ACCENT     = 0x5D9F;   // Soft blue
 static const uint16_t COLOR_OK         = 0x07E0;   // Green
 static const uint16_t COLOR_WARN       = 0xFD20;   // Orange
 static const uint16_t COLOR_ERROR      = 0xF800;   // Red
+static const uint16_t COLOR_INACTIVE   = 0x3186;   // Dark gray (unpressed)
 
-// Sprite for double-buffered rendering
+// Frame buffer: the whole screen, kept between frames so clean sections are
+// never redrawn. Internal RAM so it can feed the SPI DMA directly.
 static M5Canvas sprite(&M5.Display);
 
-// External references
-extern WiFiManager g_wifiManager;
-extern ControllerManager g_controllerManager;
-extern DriveManager g_driveManager;
-extern MotorManager g_motorManager;
+// ---------------------------------------------------------------------------
+// Widget inputs
+// ---------------------------------------------------------------------------
+// Each section's model holds exactly what it draws, quantized to the
+// displayed precision, so two models compare equal iff the pixels would.
+// Models are memset before capture so padding compares equal too.
+
+struct DisplayStatusModel {
+    bool connected;
+    int8_t rssi;
+    char ip[16];
+};
+
+struct DisplayControllerModel {
+    int8_t connCount;
+    bool found;
+    int16_t lx, ly, rx, ry;
+    int16_t l2, r2;
+    uint16_t buttons;
+    uint16_t miscButtons;
+    uint8_t dpad;
+    char modelName[32];
+};
+
+struct DisplayMotorModel {
+    struct Row {
+        uint8_t id;
+        uint8_t mode;           // 0=RST 1=CAL 2=RUN 3=--- (stale)
+        uint16_t color;
+        int16_t voltageDv;      // 0.1 V, 0 = no reading
+        int16_t positionCr;     // 0.01 rad
+        char role[2];
+    };
+    int8_t motorCount;
+    int8_t rowCount;
+    bool canRunning;
+    bool hasLeft;
+    bool hasRight;
+    int16_t trimLeftCr;         // 0.01 rad
+    int16_t trimRightCr;
+    Row rows[2];
+};
+
+struct DisplayOutputModel {
+    uint16_t leftPulse;
+    uint16_t rightPulse;
+};
+
+struct DisplaySystemModel {
+    uint32_t uptimeSec;
+    uint32_t heapKb;
+};
+
+// ---------------------------------------------------------------------------
+// Widgets
+// ---------------------------------------------------------------------------
+// A widget is a full-width band of the screen plus the model it last drew.
+// Full-width bands are contiguous in the sprite buffer, so a dirty band is
+// pushed with a single DMA transfer straight out of the sprite.
+//
+// Layout budget for 240px display:
+//   Status bar:  28px
+//   Controller:  96px (added miscButtons row)
+//   Motors:      51px (includes trim line)
+//   Outputs:     36px
+//   System:      29px
+//   Total:      240px
+
+template <typename Model>
+struct DisplayWidget {
+    const int y;
+    const int height;
+    Model drawn;            // Inputs of the last render
+    bool valid;             // False until first render (forces a draw)
+};
+
+static DisplayWidget<DisplayStatusModel>     s_statusWidget     = {0,   28, {}, false};
+static DisplayWidget<DisplayControllerModel> s_controllerWidget = {28,  96, {}, false};
+static DisplayWidget<DisplayMotorModel>      s_motorWidget      = {124, 51, {}, false};
+static DisplayWidget<DisplayOutputModel>     s_outputWidget     = {175, 36, {}, false};
+static DisplayWidget<DisplaySystemModel>     s_systemWidget     = {211, 29, {}, false};
+
+static uint32_t s_framesPushed = 0;
+static uint32_t s_bandsPushed = 0;
+
+static int16_t toCentis(float v) {
+    return (int16_t)lroundf(v * 100.0f);
+}
+
+// Record the model and report whether the widget needs a redraw
+template <typename Model>
+static bool widgetChanged(DisplayWidget<Model>& widget, const Model& model) {
+    if (widget.valid && memcmp(&widget.drawn, &model, sizeof(Model)) == 0) {
+        return false;
+    }
+    widget.drawn = model;
+    widget.valid = true;
+    return true;
+}
 
-// Trim target positions (defined in sketch.cpp)
-extern float g_trimTargetLeft;
-extern float g_trimTargetRight;
+// Clear a widget's band before its section redraws into it
+template <typename Model>
+static void clearBand(const DisplayWidget<Model>& widget) {
+    sprite.fillRect(0, widget.y, DISPLAY_WIDTH, widget.height, COLOR_BG);
+}
+
+// Start a DMA push of a widget's band. The caller holds the write
+// transaction; the transfer runs while the loop carries on.
+template <typename Model>
+static void pushBand(const DisplayWidget<Model>& widget) {
+    const lgfx::swap565_t* pixels = (const lgfx::swap565_t*)sprite.getBuffer();
+    M5.Display.pushImageDMA(0, widget.y, DISPLAY_WIDTH, widget.height,
+                            pixels + widget.y * DISPLAY_WIDTH);
+    s_bandsPushed++;
+}
 
 void DisplayManager::begin() {
     LOG_INFO(TAG, "Initializing display...");
 
     // Create sprite buffer matching display size
     // M5StickC Plus 2 display is 135x240 in portrait
+    sprite.setPsram(false);
     sprite.createSprite(DISPLAY_WIDTH, DISPLAY_HEIGHT);
     sprite.setTextWrap(false);
+    sprite.fillSprite(COLOR_BG);
 
     _initialized = true;
 
-    // Draw initial screen immediately
-    _lastUpdateMs = 0;
-    update();
+    BaseType_t result = xTaskCreatePinnedToCore(
+        displayTaskFunc,        // Task function
+        "display",              // Name
+        DISPLAY_TASK_STACK,     // Stack size
+        this,                   // Parameter (DisplayManager instance)
+        DISPLAY_TASK_PRIORITY,  // Priority
+        NULL,                   // Task handle (not needed)
+        DISPLAY_TASK_CORE       // Core ID
+    );
+
+    if (result != pdPASS) {
+        LOG_ERROR(TAG, "Failed to create display task");
+        return;
+    }
 
-    LOG_INFO(TAG, "Display initialized (%dx%d)", DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    LOG_INFO(TAG, "Display initialized (%dx%d), task on CPU%d (prio %d)",
+             DISPLAY_WIDTH, DISPLAY_HEIGHT, DISPLAY_TASK_CORE, DISPLAY_TASK_PRIORITY);
 }
 
-void DisplayManager::update() {
+void DisplayManager::publish(const DisplaySnapshot& snapshot) {
     if (!_initialized) {
         return;
     }
+    _snapshot.store(snapshot);
+}
+
+// ---------------------------------------------------------------------------
+// Task
+// ---------------------------------------------------------------------------
+
+void DisplayManager::displayTaskFunc(void* param) {
+    DisplayManager* self = static_cast<DisplayManager*>(param);
+
+    // Nothing else draws to the LCD, so the write transaction stays open
+    // for good -- DMA pushes then return immediately instead of waiting for
+    // the bus to be released at the end of each frame.
+    M5.Display.startWrite();
+
+    // Draw the initial screen immediately (every widget starts dirty)
+    self->render();
+
+    TickType_t lastWake = xTaskGetTickCount();
+    while (true) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(DISPLAY_UPDATE_MS));
+        PROFILE_SCOPE(PROF_STAGE_RENDER);
+        self->render();
+    }
+}
 
-    unsigned long now = millis();
-    if (now - _lastUpdateMs < DISPLAY_UPDATE_MS) {
+void DisplayManager::render() {
+    DisplaySnapshot snap;
+    uint32_t seq = _snapshot.load(&snap);
+
+    // Nothing published since the last frame (the loop is stalled, or
+    // setup() is still running) -- every widget would compare clean
+    if (seq == _renderedSeq && s_framesPushed > 0) {
+        return;
+    }
+    _renderedSeq = seq;
+
+    DisplayStatusModel status;
+    DisplayControllerModel controller;
+    DisplayMotorModel motors;
+    DisplayOutputModel outputs;
+    DisplaySystemModel system;
+    captureStatus(snap, &status);
+    captureController(snap, &controller);
+    captureMotors(snap, &motors);
+    captureOutputs(snap, &outputs);
+    captureSystem(snap, &system);
+
+    bool statusDirty = widgetChanged(s_statusWidget, status);
+    bool controllerDirty = widgetChanged(s_controllerWidget, controller);
+    bool motorsDirty = widgetChanged(s_motorWidget, motors);
+    bool outputsDirty = widgetChanged(s_outputWidget, outputs);
+    bool systemDirty = widgetChanged(s_systemWidget, system);
+
+    if (!statusDirty && !controllerDirty && !motorsDirty && !outputsDirty && !systemDirty) {
         return;
     }
-    _lastUpdateMs = now;
 
-    // Clear the sprite
-    sprite.fillSprite(COLOR_BG);
+    // The previous frame's DMA may still be reading the sprite
+    M5.Display.waitDMA();
+
+    if (statusDirty) {
+        clearBand(s_statusWidget);
+        drawStatusBar(s_statusWidget.y, status);
+    }
+    if (controllerDirty) {
+        clearBand(s_controllerWidget);
+        drawControllerInfo(s_controllerWidget.y, controller);
+    }
+    if (motorsDirty) {
+        clearBand(s_motorWidget);
+        drawMotorInfo(s_motorWidget.y, motors);
+    }
+    if (outputsDirty) {
+        clearBand(s_outputWidget);
+        drawOutputInfo(s_outputWidget.y, outputs);
+    }
+    if (systemDirty) {
+        clearBand(s_systemWidget);
+        drawSystemInfo(s_systemWidget.y, system);
+    }
 
-    // Draw sections top to bottom
-    // Layout budget for 240px display:
-    //   Status bar:  28px
-    //   Controller:  96px (added miscButtons row)
-    //   Motors:      51px (includes trim line)
-    //   Outputs:     36px
-    //   System:      29px
-    //   Total:      240px
-    int y = 0;
-    drawStatusBar(y);
-    y += 28;
-    drawControllerInfo(y);
-    y += 96;
-    drawMotorInfo(y);
-    y += 51;
-    drawOutputInfo(y);
-    y += 36;
-    drawSystemInfo(y);
-
-    // Push sprite to display (flicker-free)
-    sprite.pushSprite(0, 0);
+    // Push only the bands that changed
+    if (statusDirty)     { pushBand(s_statusWidget); }
+    if (controllerDirty) { pushBand(s_controllerWidget); }
+    if (motorsDirty)     { pushBand(s_motorWidget); }
+    if (outputsDirty)    { pushBand(s_outputWidget); }
+    if (systemDirty)     { pushBand(s_systemWidget); }
+    s_framesPushed++;
+
+    if (s_framesPushed % 300 == 0) {
+        LOG_DEBUG(TAG, "%lu frames, %lu bands pushed",
+                  (unsigned long)s_framesPushed, (unsigned long)s_bandsPushed);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Capture -- read the snapshot into each widget's model
+// ---------------------------------------------------------------------------
+
+void DisplayManager::captureStatus(const DisplaySnapshot& s, DisplayStatusModel* m) {
+    memset(m, 0, sizeof(*m));
+    m->connected = s.wifiConnected;
+    if (m->connected) {
+        memcpy(m->ip, s.ip, sizeof(m->ip));
+        m->ip[sizeof(m->ip) - 1] = '\0';
+        m->rssi = s.rssi;
+    }
 }
 
-void DisplayManager::drawStatusBar(int y) {
+void DisplayManager::captureController(const DisplaySnapshot& s, DisplayControllerModel* m) {
+    memset(m, 0, sizeof(*m));
+    m->connCount = s.controllerCount;
+    if (m->connCount == 0 || !s.hasController) {
+        return;
+    }
+
+    const ControllerState& state = s.controller;
+    m->found = true;
+    m->lx = state.lx;
+    m->ly = state.ly;
+    m->rx = state.rx;
+    m->ry = state.ry;
+    m->l2 = state.l2;
+    m->r2 = state.r2;
+    m->buttons = state.buttons;
+    m->miscButtons = state.miscButtons;
+    m->dpad = state.dpad;
+    strncpy(m->modelName, state.modelName, sizeof(m->modelName) - 1);
+}
+
+void DisplayManager::captureMotors(const DisplaySnapshot& s, DisplayMotorModel* m) {
+    memset(m, 0, sizeof(*m));
+    m->motorCount = s.motorCount;
+    m->canRunning = s.canRunning;
+
+    // Show up to 2 motors (fits in available space)
+    m->rowCount = (int8_t)(s.motorCount > 2 ? 2 : s.motorCount);
+    for (int i = 0; i < m->rowCount; i++) {
+        DisplayMotorModel::Row& row = m->rows[i];
+        const RobstrideMotorStatus& status = s.motors[i];
+        row.id = s.motorIds[i];
+
+        // Color based on state
+        row.color = COLOR_TEXT_DIM;         // Gray = no data / reset
+        if (status.stale) {
+            row.color = COLOR_WARN;         // Orange = stale / disconnected
+        } else if (status.hasFault) {
+            row.color = COLOR_ERROR;        // Red = fault
+        } else if (status.enabled) {
+            row.color = COLOR_OK;           // Green = running
+        } else if (status.mode == 1) {
+            row.color = COLOR_WARN;         // Orange = calibrating
+        }
+
+        row.mode = status.stale ? 3 : (status.mode <= 2 ? status.mode : 0);
+        row.voltageDv = (status.voltage > 0.1f) ? (int16_t)lroundf(status.voltage * 10.0f) : 0;
+        row.positionCr = toCentis(status.position);
+        row.role[0] = s.motorRoles[i][0];
+    }
+
+    m->hasLeft = (s.leftMotorId > 0);
+    m->hasRight = (s.rightMotorId > 0);
+    if (m->hasLeft) {
+        m->trimLeftCr = toCentis(s.trimLeft);
+    }
+    if (m->hasRight) {
+        m->trimRightCr = toCentis(s.trimRight);
+    }
+}
+
+void DisplayManager::captureOutputs(const DisplaySnapshot& s, DisplayOutputModel* m) {
+    memset(m, 0, sizeof(*m));
+    m->leftPulse = s.leftPulse;
+    m->rightPulse = s.rightPulse;
+}
+
+void DisplayManager::captureSystem(const DisplaySnapshot& s, DisplaySystemModel* m) {
+    memset(m, 0, sizeof(*m));
+    m->uptimeSec = s.timeMs / 1000;
+    m->heapKb = s.freeHeap / 1024;
+}
+
+// ---------------------------------------------------------------------------
+// Render -- draw one section from its model
+// ---------------------------------------------------------------------------
+
+void DisplayManager::drawStatusBar(int y, const DisplayStatusModel& m) {
     // WiFi status bar at the top
     sprite.fillRect(0, y, DISPLAY_WIDTH, 26, COLOR_HEADER_BG);
 
     // WiFi indicator
-    bool connected = g_wifiManager.isConnected();
-    uint16_t wifiColor = connected ? COLOR_OK : COLOR_ERROR;
+    uint16_t wifiColor = m.connected ? COLOR_OK : COLOR_ERROR;
     sprite.fillCircle(10, y + 13, 4, wifiColor);
 
     // IP or status text
     sprite.setTextSize(1);
     sprite.setTextColor(COLOR_TEXT);
-    if (connected) {
+    if (m.connected) {
         sprite.setCursor(20, y + 6);
-        sprite.print(g_wifiManager.getIP());
+        sprite.print(m.ip);
 
         // RSSI indicator
-        int rssi = g_wifiManager.getRSSI();
         sprite.setTextColor(COLOR_TEXT_DIM);
         sprite.setCursor(20, y + 16);
         char rssiBuf[16];
-        snprintf(rssiBuf, sizeof(rssiBuf), "%ddBm", rssi);
+        snprintf(rssiBuf, sizeof(rssiBuf), "%ddBm", m.rssi);
         sprite.print(rssiBuf);
     } else {
         sprite.setCursor(20, y + 9);
@@ -122,22 +397,20 @@ void DisplayManager::drawStatusBar(int y) {
 
 }
 
-void DisplayManager::drawControllerInfo(int y) {
+void DisplayManager::drawControllerInfo(int y, const DisplayControllerModel& m) {
     sprite.setTextSize(1);
     sprite.setTextColor(COLOR_ACCENT);
     sprite.setCursor(4, y + 2);
     sprite.print("CONTROLLER");
 
-    int connCount = g_controllerManager.getConnectedCount();
-
     sprite.setTextColor(COLOR_TEXT_DIM);
     char countBuf[8];
-    snprintf(countBuf, sizeof(countBuf), " (%d)", connCount);
+    snprintf(countBuf, sizeof(countBuf), " (%d)", m.connCount);
     sprite.print(countBuf);
 
     y += 14;
 
-    if (connCount == 0) {
+    if (m.connCount == 0) {
         sprite.setTextColor(COLOR_TEXT_DIM);
         sprite.setCursor(4, y + 20);
         sprite.print("No controller");
@@ -145,123 +418,114 @@ void DisplayManager::drawControllerInfo(int y) {
         sprite.print("Pair 8BitDo...");
         return;
     }
+    if (!m.found) {
+        return;
+    }
 
-    // Show first connected controller's state
-    for (int i = 0; i < CONTROLLER_MAX_COUNT; i++) {
-        const ControllerState& state = g_controllerManager.getState(i);
-        if (!state.connected) {
-            continue;
-        }
-
-        // Model name
-        sprite.setTextColor(COLOR_TEXT);
-        sprite.setCursor(4, y);
-        sprite.print(state.modelName);
-        y += 12;
-
-        // Left stick
-        sprite.setTextColor(COLOR_TEXT_DIM);
-        sprite.setCursor(4, y);
-        sprite.print("L:");
-        sprite.setTextColor(COLOR_TEXT);
-        char stickBuf[24];
-        snprintf(stickBuf, sizeof(stickBuf), "%4d,%4d", state.lx, state.ly);
-        sprite.print(stickBuf);
-        y += 11;
+    // Model name
+    sprite.setTextColor(COLOR_TEXT);
+    sprite.setCursor(4, y);
+    sprite.print(m.modelName);
+    y += 12;
 
-        // Right stick
-        sprite.setTextColor(COLOR_TEXT_DIM);
-        sprite.setCursor(4, y);
-        sprite.print("R:");
-        sprite.setTextColor(COLOR_TEXT);
-        snprintf(stickBuf, sizeof(stickBuf), "%4d,%4d", state.rx, state.ry);
-        sprite.print(stickBuf);
-        y += 11;
+    // Left stick
+    sprite.setTextColor(COLOR_TEXT_DIM);
+    sprite.setCursor(4, y);
+    sprite.print("L:");
+    sprite.setTextColor(COLOR_TEXT);
+    char stickBuf[24];
+    snprintf(stickBuf, sizeof(stickBuf), "%4d,%4d", m.lx, m.ly);
+    sprite.print(stickBuf);
+    y += 11;
 
-        // Triggers (L2/R2)
-        sprite.setTextColor(COLOR_TEXT_DIM);
-        sprite.setCursor(4, y);
-        sprite.print("T:");
-        sprite.setTextColor(COLOR_TEXT);
-        char trigBuf[24];
-        snprintf(trigBuf, sizeof(trigBuf), "L2%4d R2%4d", state.l2, state.r2);
-        sprite.print(trigBuf);
-        y += 11;
+    // Right stick
+    sprite.setTextColor(COLOR_TEXT_DIM);
+    sprite.setCursor(4, y);
+    sprite.print("R:");
+    sprite.setTextColor(COLOR_TEXT);
+    snprintf(stickBuf, sizeof(stickBuf), "%4d,%4d", m.rx, m.ry);
+    sprite.print(stickBuf);
+    y += 11;
 
-        // Buttons row 1: A B X Y L1 R1
-        sprite.setTextColor(COLOR_TEXT_DIM);
-        sprite.setCursor(4, y);
-        sprite.print("B:");
-
-        const char* btnLabels[] = {"A","B","X","Y","L1","R1","L2","R2","L3","R3"};
-        int bx = 20;
-        for (int b = 0; b < 6; b++) {
-            bool pressed = (state.buttons & (1 << b)) != 0;
-            sprite.setTextColor(pressed ? COLOR_ACCENT : 0x3186);
-            sprite.setCursor(bx, y);
-            sprite.print(btnLabels[b]);
-            bx += (b < 4) ? 14 : 16;
-        }
-        y += 11;
+    // Triggers (L2/R2)
+    sprite.setTextColor(COLOR_TEXT_DIM);
+    sprite.setCursor(4, y);
+    sprite.print("T:");
+    sprite.setTextColor(COLOR_TEXT);
+    char trigBuf[24];
+    snprintf(trigBuf, sizeof(trigBuf), "L2%4d R2%4d", m.l2, m.r2);
+    sprite.print(trigBuf);
+    y += 11;
 
-        // Buttons row 2: L2 R2 L3 R3 + Misc (Sel Sta Sys Cap)
-        bx = 20;
-        for (int b = 6; b < 10; b++) {
-            bool pressed = (state.buttons & (1 << b)) != 0;
-            sprite.setTextColor(pressed ? COLOR_ACCENT : 0x3186);
-            sprite.setCursor(bx, y);
-            sprite.print(btnLabels[b]);
-            bx += 16;
-        }
-        // Misc buttons: 0=System, 1=Select, 2=Start, 3=Capture
-        const char* miscLabels[] = {"Sys","Sel","Sta","Cap"};
-        for (int m = 0; m < 4; m++) {
-            bool pressed = (state.miscButtons & (1 << m)) != 0;
-            sprite.setTextColor(pressed ? COLOR_OK : 0x3186);
-            sprite.setCursor(bx, y);
-            sprite.print(miscLabels[m]);
-            bx += 20;
-        }
-        y += 11;
+    // Buttons row 1: A B X Y L1 R1
+    sprite.setTextColor(COLOR_TEXT_DIM);
+    sprite.setCursor(4, y);
+    sprite.print("B:");
+
+    const char* btnLabels[] = {"A","B","X","Y","L1","R1","L2","R2","L3","R3"};
+    int bx = 20;
+    for (int b = 0; b < 6; b++) {
+        bool pressed = (m.buttons & (1 << b)) != 0;
+        sprite.setTextColor(pressed ? COLOR_ACCENT : COLOR_INACTIVE);
+        sprite.setCursor(bx, y);
+        sprite.print(btnLabels[b]);
+        bx += (b < 4) ? 14 : 16;
+    }
+    y += 11;
 
-        // D-pad + raw hex for debugging unmapped buttons
-        sprite.setTextColor(COLOR_TEXT_DIM);
-        sprite.setCursor(4, y);
-        sprite.print("D:");
-        int dx = 20;
-        const char* dNames[] = {"U","D","R","L"};
-        uint8_t dMasks[] = {1, 2, 4, 8};
-        for (int d = 0; d < 4; d++) {
-            bool active = (state.dpad & dMasks[d]) != 0;
-            sprite.setTextColor(active ? COLOR_ACCENT : 0x3186);
-            sprite.setCursor(dx, y);
-            sprite.print(dNames[d]);
-            dx += 14;
-        }
-        // Raw hex for debugging
-        sprite.setTextColor(COLOR_TEXT_DIM);
-        sprite.setCursor(80, y);
-        char hexBuf[20];
-        snprintf(hexBuf, sizeof(hexBuf), "%03X/%02X", state.buttons, state.miscButtons);
-        sprite.print(hexBuf);
+    // Buttons row 2: L2 R2 L3 R3 + Misc (Sel Sta Sys Cap)
+    bx = 20;
+    for (int b = 6; b < 10; b++) {
+        bool pressed = (m.buttons & (1 << b)) != 0;
+        sprite.setTextColor(pressed ? COLOR_ACCENT : COLOR_INACTIVE);
+        sprite.setCursor(bx, y);
+        sprite.print(btnLabels[b]);
+        bx += 16;
+    }
+    // Misc buttons: 0=System, 1=Select, 2=Start, 3=Capture
+    const char* miscLabels[] = {"Sys","Sel","Sta","Cap"};
+    for (int i = 0; i < 4; i++) {
+        bool pressed = (m.miscButtons & (1 << i)) != 0;
+        sprite.setTextColor(pressed ? COLOR_OK : COLOR_INACTIVE);
+        sprite.setCursor(bx, y);
+        sprite.print(miscLabels[i]);
+        bx += 20;
+    }
+    y += 11;
 
-        // Only show first connected controller on the small display
-        break;
+    // D-pad + raw hex for debugging unmapped buttons
+    sprite.setTextColor(COLOR_TEXT_DIM);
+    sprite.setCursor(4, y);
+    sprite.print("D:");
+    int dx = 20;
+    const char* dNames[] = {"U","D","R","L"};
+    uint8_t dMasks[] = {1, 2, 4, 8};
+    for (int d = 0; d < 4; d++) {
+        bool active = (m.dpad & dMasks[d]) != 0;
+        sprite.setTextColor(active ? COLOR_ACCENT : COLOR_INACTIVE);
+        sprite.setCursor(dx, y);
+        sprite.print(dNames[d]);
+        dx += 14;
     }
+    // Raw hex for debugging
+    sprite.setTextColor(COLOR_TEXT_DIM);
+    sprite.setCursor(80, y);
+    char hexBuf[20];
+    snprintf(hexBuf, sizeof(hexBuf), "%03X/%02X", m.buttons, m.miscButtons);
+    sprite.print(hexBuf);
 }
 
-void DisplayManager::drawMotorInfo(int y) {
+void DisplayManager::drawMotorInfo(int y, const DisplayMotorModel& m) {
     sprite.setTextSize(1);
     sprite.setTextColor(COLOR_ACCENT);
     sprite.setCursor(4, y + 2);
 
-    int motorCount = g_motorManager.getMotorCount();
     char headerBuf[24];
-    snprintf(headerBuf, sizeof(headerBuf), "MOTORS (%d)", motorCount);
+    snprintf(headerBuf, sizeof(headerBuf), "MOTORS (%d)", m.motorCount);
     sprite.print(headerBuf);
 
     // Show CAN status indicator
-    if (!g_motorManager.isRunning()) {
+    if (!m.canRunning) {
         sprite.setTextColor(COLOR_ERROR);
         sprite.setCursor(90, y + 2);
         sprite.print("NO CAN");
@@ -269,52 +533,34 @@ void DisplayManager::drawMotorInfo(int y) {
 
     y += 14;
 
-    if (motorCount == 0) {
+    if (m.motorCount == 0) {
         sprite.setTextColor(COLOR_TEXT_DIM);
         sprite.setCursor(4, y);
         sprite.print("No motors found");
         return;
     }
 
-    // Show up to 2 motors (fits in available space)
-    int showCount = motorCount;
-    if (showCount > 2) {
-        showCount = 2;
-    }
+    static const char* const MODE_NAMES[] = {"RST", "CAL", "RUN", "---"};
 
-    for (int i = 0; i < showCount; i++) {
-        uint8_t motorId = g_motorManager.getMotorId(i);
-        const RobstrideMotorStatus& status = g_motorManager.getMotorStatus(i);
-
-        // Color based on state
-        uint16_t stateColor = COLOR_TEXT_DIM;  // Gray = no data / reset
-        if (status.stale) {
-            stateColor = COLOR_WARN;   // Orange = stale / disconnected
-        } else if (status.hasFault) {
-            stateColor = COLOR_ERROR;  // Red = fault
-        } else if (status.enabled) {
-            stateColor = COLOR_OK;     // Green = running
-        } else if (status.mode == 1) {
-            stateColor = COLOR_WARN;   // Orange = calibrating
-        }
+    for (int i = 0; i < m.rowCount; i++) {
+        const DisplayMotorModel::Row& row = m.rows[i];
 
         // Motor ID with role label
-        sprite.setTextColor(stateColor);
+        sprite.setTextColor(row.color);
         sprite.setCursor(4, y);
-        const char* role = g_motorManager.getRoleLabel(motorId);
         char idBuf[12];
-        if (role[0] != '\0') {
-            snprintf(idBuf, sizeof(idBuf), "%s%d:", role, motorId);
+        if (row.role[0] != '\0') {
+            snprintf(idBuf, sizeof(idBuf), "%s%d:", row.role, row.id);
         } else {
-            snprintf(idBuf, sizeof(idBuf), "M%d:", motorId);
+            snprintf(idBuf, sizeof(idBuf), "M%d:", row.id);
         }
         sprite.print(idBuf);
 
         // Voltage
         sprite.setTextColor(COLOR_TEXT);
         char vBuf[10];
-        if (status.voltage > 0.1f) {
-            snprintf(vBuf, sizeof(vBuf), "%.1fV", status.voltage);
+        if (row.voltageDv > 0) {
+            snprintf(vBuf, sizeof(vBuf), "%.1fV", row.voltageDv / 10.0f);
         } else {
             snprintf(vBuf, sizeof(vBuf), "--V");
         }
@@ -322,59 +568,49 @@ void DisplayManager::drawMotorInfo(int y) {
         sprite.print(vBuf);
 
         // Mode (RST/CAL/RUN/---)
-        const char* modeStr = "RST";
-        if (status.stale) {
-            modeStr = "---";
-        } else if (status.mode == 1) {
-            modeStr = "CAL";
-        } else if (status.mode == 2) {
-            modeStr = "RUN";
-        }
-        sprite.setTextColor(stateColor);
+        sprite.setTextColor(row.color);
         sprite.setCursor(72, y);
-        sprite.print(modeStr);
+        sprite.print(MODE_NAMES[row.mode]);
 
         // Position in radians
         sprite.setTextColor(COLOR_TEXT);
         sprite.setCursor(96, y);
         char posBuf[12];
-        snprintf(posBuf, sizeof(posBuf), "%+.2f", status.position);
+        snprintf(posBuf, sizeof(posBuf), "%+.2f", row.positionCr / 100.0f);
         sprite.print(posBuf);
 
         y += 11;
     }
 
     // Trim targets (always show when either L or R motor is assigned)
-    bool hasLeft = (g_motorManager.getLeftMotorId() > 0);
-    bool hasRight = (g_motorManager.getRightMotorId() > 0);
-    if (hasLeft || hasRight) {
+    if (m.hasLeft || m.hasRight) {
         sprite.setTextColor(COLOR_TEXT_DIM);
         sprite.setCursor(4, y);
         sprite.print("Trm");
 
-        if (hasLeft) {
+        if (m.hasLeft) {
             sprite.setTextColor(COLOR_TEXT_DIM);
             sprite.setCursor(28, y);
             sprite.print("L:");
             sprite.setTextColor(COLOR_TEXT);
             char trimLBuf[10];
-            snprintf(trimLBuf, sizeof(trimLBuf), "%+.2f", g_trimTargetLeft);
+            snprintf(trimLBuf, sizeof(trimLBuf), "%+.2f", m.trimLeftCr / 100.0f);
             sprite.print(trimLBuf);
         }
 
-        if (hasRight) {
+        if (m.hasRight) {
             sprite.setTextColor(COLOR_TEXT_DIM);
             sprite.setCursor(80, y);
             sprite.print("R:");
             sprite.setTextColor(COLOR_TEXT);
             char trimRBuf[10];
-            snprintf(trimRBuf, sizeof(trimRBuf), "%+.2f", g_trimTargetRight);
+            snprintf(trimRBuf, sizeof(trimRBuf), "%+.2f", m.trimRightCr / 100.0f);
             sprite.print(trimRBuf);
         }
     }
 }
 
-void DisplayManager::drawOutputInfo(int y) {
+void DisplayManager::drawOutputInfo(int y, const DisplayOutputModel& m) {
     sprite.setTextColor(COLOR_ACCENT);
     sprite.setCursor(4, y + 2);
     sprite.setTextSize(1);
@@ -387,7 +623,7 @@ void DisplayManager::drawOutputInfo(int y) {
     sprite.print("SrvL:");
     sprite.setTextColor(COLOR_TEXT);
     char leftBuf[8];
-    snprintf(leftBuf, sizeof(leftBuf), "%u", g_driveManager.getLeftPulse());
+    snprintf(leftBuf, sizeof(leftBuf), "%u", m.leftPulse);
     sprite.print(leftBuf);
 
     sprite.setTextColor(COLOR_TEXT_DIM);
@@ -395,11 +631,11 @@ void DisplayManager::drawOutputInfo(int y) {
     sprite.print("SrvR:");
     sprite.setTextColor(COLOR_TEXT);
     char rightBuf[8];
-    snprintf(rightBuf, sizeof(rightBuf), "%u", g_driveManager.getRightPulse());
+    snprintf(rightBuf, sizeof(rightBuf), "%u", m.rightPulse);
     sprite.print(rightBuf);
 }
 
-void DisplayManager::drawSystemInfo(int y) {
+void DisplayManager::drawSystemInfo(int y, const DisplaySystemModel& m) {
     sprite.setTextColor(COLOR_ACCENT);
     sprite.setCursor(4, y + 2);
     sprite.setTextSize(1);
@@ -407,10 +643,9 @@ void DisplayManager::drawSystemInfo(int y) {
     y += 14;
 
     // Uptime
-    unsigned long uptimeSec = millis() / 1000;
-    unsigned long hours = uptimeSec / 3600;
-    unsigned long mins = (uptimeSec % 3600) / 60;
-    unsigned long secs = uptimeSec % 60;
+    unsigned long hours = m.uptimeSec / 3600;
+    unsigned long mins = (m.uptimeSec % 3600) / 60;
+    unsigned long secs = m.uptimeSec % 60;
 
     sprite.setTextColor(COLOR_TEXT_DIM);
     sprite.setCursor(4, y);
@@ -427,6 +662,6 @@ void DisplayManager::drawSystemInfo(int y) {
     sprite.print("Heap:");
     sprite.setTextColor(COLOR_TEXT);
     char heapBuf[16];
-    snprintf(heapBuf, sizeof(heapBuf), "%luK", (unsigned long)(ESP.getFreeHeap() / 1024));
+    snprintf(heapBuf, sizeof(heapBuf), "%luK", (unsigned long)m.heapKb);
     sprite.print(heapBuf);
 }
@@ -6,32 +6,99 @@
 // Renders status information on the M5StickC Plus 2's 135x240 ST7789V2 LCD.
 // Uses M5Unified's sprite-based double buffering for flicker-free updates.
 //
+// Dirty-region rendering: the screen is split into full-width widgets
+// (status bar, controller, motors, outputs, system). Each refresh captures
+// every widget's inputs into a small model -- quantized to what is actually
+// displayed -- and only widgets whose model changed are redrawn into the
+// sprite and pushed to the LCD, each as one DMA transfer of its band. A
+// refresh where nothing changed costs only the captures.
+//
+// Rendering and the SPI push run on a low-priority display task on CPU0,
+// away from the control loop. The display never reads live module state:
+// the control loop publishes a DisplaySnapshot once per tick through a
+// SeqLock (seqlock.h), and the display task renders from a consistent copy.
+//
 // Usage:
 //   DisplayManager display;
-//   display.begin();        // Call once in setup() after M5.begin()
-//   display.update();       // Call every loop iteration (rate-limited internally)
+//   display.begin();            // Call once in setup() after M5.begin()
+//   display.publish(snapshot);  // Control loop, every tick
 // =============================================================================
 
 #include <Arduino.h>
+#include "controller_manager.h"
+#include "robstride_protocol.h"
+#include "seqlock.h"
+
+// Everything the display shows, captured by the control loop
+struct DisplaySnapshot {
+    uint32_t timeMs;                // millis() at capture (uptime)
+
+    // ---- System (refreshed at the display rate) ----
+    bool wifiConnected;
+    int8_t rssi;                    // dBm
+    char ip[16];
+    uint32_t freeHeap;              // bytes
+
+    // ---- Controller (first connected) ----
+    int8_t controllerCount;
+    bool hasController;
+    ControllerState controller;
+
+    // ---- Motors (first two on the bus) ----
+    int8_t motorCount;
+    bool canRunning;
+    uint8_t motorIds[2];
+    char motorRoles[2][2];          // "L", "R" or ""
+    RobstrideMotorStatus motors[2];
+    uint8_t leftMotorId;            // 0 = unassigned
+    uint8_t rightMotorId;
+    float trimLeft;                 // rad
+    float trimRight;
+
+    // ---- Outputs ----
+    uint16_t leftPulse;             // us
+    uint16_t rightPulse;
+};
+
+// Widget inputs (defined in display_manager.cpp)
+struct DisplayStatusModel;
+struct DisplayControllerModel;
+struct DisplayMotorModel;
+struct DisplayOutputModel;
+struct DisplaySystemModel;
 
 class DisplayManager {
 public:
-    // Initialize the display and create the sprite buffer.
-    // Must be called after M5.begin().
+    // Initialize the display, create the sprite buffer and start the
+    // display task. Must be called after M5.begin().
     void begin();
 
-    // Update the display with current status.
-    // Rate-limited internally by DISPLAY_UPDATE_MS from config.h.
-    void update();
+    // Publish the state to show (control loop only). Rendered by the
+    // display task every DISPLAY_UPDATE_MS.
+    void publish(const DisplaySnapshot& snapshot);
 
 private:
-    unsigned long _lastUpdateMs = 0;
     bool _initialized = false;
 
-    // Drawing helpers
-    void drawStatusBar(int y);
-    void drawControllerInfo(int y);
-    void drawMotorInfo(int y);
-    void drawOutputInfo(int y);
-    void drawSystemInfo(int y);
+    SeqLock<DisplaySnapshot> _snapshot;     // Loop -> display task
+    uint32_t _renderedSeq = 0;              // Display task only
+
+    static void displayTaskFunc(void* param);
+
+    // Render one frame from the latest snapshot (display task)
+    void render();
+
+    // Read the snapshot into each widget's model
+    void captureStatus(const DisplaySnapshot& s, DisplayStatusModel* m);
+    void captureController(const DisplaySnapshot& s, DisplayControllerModel* m);
+    void captureMotors(const DisplaySnapshot& s, DisplayMotorModel* m);
+    void captureOutputs(const DisplaySnapshot& s, DisplayOutputModel* m);
+    void captureSystem(const DisplaySnapshot& s, DisplaySystemModel* m);
+
+    // Drawing helpers (render one widget's band from its model)
+    void drawStatusBar(int y, const DisplayStatusModel& m);
+    void drawControllerInfo(int y, const DisplayControllerModel& m);
+    void drawMotorInfo(int y, const DisplayMotorModel& m);
+    void drawOutputInfo(int y, const DisplayOutputModel& m);
+    void drawSystemInfo(int y, const DisplaySystemModel& m);
 };
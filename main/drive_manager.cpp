@@ -2,7 +2,15 @@
 // Drive Manager Module - Implementation
 // =============================================================================
 // Standard RC servo PPM via ESP32 LEDC peripheral. Runs as a FreeRTOS task
-// on CPU0 for deterministic 50Hz timing, isolated from display/WiFi on CPU1.
+// on CPU0, isolated from display/WiFi on CPU1.
+//
+// The task is event-driven: Bluepad32 notifies it when a report lands in the
+// input mailbox, and it reads the mailbox and writes the servo duty at once,
+// without waiting for loop(). LEDC latches
+// a new duty at the start of the next PPM period, so the freshest value
+// always goes out on the next pulse. Without input, the task still wakes once
+// per period, DRIVE_PPM_LEAD_US before the boundary, so smoothing, overrides
+// and disconnects reach the pulse that follows.
 //
 // Arcade-style differential drive with expo curves.
 // Bidirectional: 1500us = stop, 1000us = full reverse, 2000us = full forward.
@@ -12,10 +20,14 @@
 #include "config.h"
 #include "debug_log.h"
 #include "controller_manager.h"
+#include "profiler.h"
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <driver/ledc.h>
+#include <esp_timer.h>
+#include <math.h>
+#include <Bluepad32.h>
 #include <controller/uni_gamepad.h>  // For BUTTON_SHOULDER_L/R constants
 
 static const char* TAG = "Drive";
@@ -48,6 +60,16 @@ void DriveManager::begin() {
     writeServo(LEDC_SERVO_LEFT_CH, SERVO_CENTER_US);
     writeServo(LEDC_SERVO_RIGHT_CH, SERVO_CENTER_US);
 
+    // Restart the PPM period now so the task knows where pulses start.
+    // 16-bit at 50Hz divides the 80MHz APB clock exactly (divider 6250/256),
+    // so the period is exactly SERVO_PERIOD_US and the phase does not drift
+    // against esp_timer.
+    ledc_timer_rst((ledc_mode_t)LEDC_SERVO_SPEED_MODE, (ledc_timer_t)LEDC_SERVO_TIMER);
+    _ppmEpochUs = esp_timer_get_time();
+
+    DriveOutputs centered = {SERVO_CENTER_US, SERVO_CENTER_US, 0.0f, 0.0f};
+    _outputs.store(centered);
+
     _initialized = true;
 
     // Spawn the drive control task on CPU0
@@ -57,7 +79,7 @@ void DriveManager::begin() {
         DRIVE_TASK_STACK,       // Stack size
         this,                   // Parameter (DriveManager instance)
         DRIVE_TASK_PRIORITY,    // Priority
-        NULL,                   // Task handle (not needed)
+        &_task,                 // Task handle (for input notifications)
         DRIVE_TASK_CORE         // Core ID
     );
 
@@ -67,43 +89,50 @@ void DriveManager::begin() {
         return;
     }
 
-    LOG_INFO(TAG, "Drive task started on CPU%d (PPM %dHz, L=G%d ch%d, R=G%d ch%d, mix@%dHz)",
+    // Wake the task on every report Bluepad32 publishes, not after loop()
+    if (!BP32.addDataListener(_task, DRIVE_NOTIFY_BIT)) {
+        LOG_WARN(TAG, "No input notifications, driving on the PPM period only");
+    }
+
+    LOG_INFO(TAG, "Drive task started on CPU%d (PPM %dHz, L=G%d ch%d, R=G%d ch%d, on input + %dus before each pulse)",
              DRIVE_TASK_CORE, SERVO_FREQ_HZ,
              PIN_SERVO_LEFT, LEDC_SERVO_LEFT_CH,
              PIN_SERVO_RIGHT, LEDC_SERVO_RIGHT_CH,
-             1000 / DRIVE_UPDATE_MS);
+             DRIVE_PPM_LEAD_US);
+}
+
+DriveOutputs DriveManager::getOutputs() const {
+    return _outputs.load();
 }
 
 uint16_t DriveManager::getLeftPulse() const {
-    return _leftPulseUs;
+    return _outputs.load().leftPulseUs;
 }
 
 uint16_t DriveManager::getRightPulse() const {
-    return _rightPulseUs;
+    return _outputs.load().rightPulseUs;
 }
 
 float DriveManager::getLeftDrive() const {
-    return _leftDrive;
+    return _outputs.load().leftDrive;
 }
 
 float DriveManager::getRightDrive() const {
-    return _rightDrive;
+    return _outputs.load().rightDrive;
 }
 
 void DriveManager::setInverted(bool inverted) {
-    _inverted = inverted;
+    _inverted.store(inverted, std::memory_order_relaxed);
 }
 
 void DriveManager::setOverride(float left, float right) {
-    _overrideLeft = left;
-    _overrideRight = right;
-    _overrideActive = true;
+    DriveOverride ovr = {true, left, right};
+    _override.store(ovr);
 }
 
 void DriveManager::clearOverride() {
-    _overrideActive = false;
-    _overrideLeft = 0.0f;
-    _overrideRight = 0.0f;
+    DriveOverride ovr = {false, 0.0f, 0.0f};
+    _override.store(ovr);
 }
 
 // ---------------------------------------------------------------------------
@@ -179,6 +208,21 @@ uint16_t DriveManager::driveToMicroseconds(float drive) {
     return (uint16_t)(result + 0.5f);
 }
 
+// Ticks until DRIVE_PPM_LEAD_US before the next PPM period starts.
+// A wait of n ticks returns after n-1..n tick periods, so rounding up lands
+// the wakeup within one tick of the target -- still ahead of the latch as
+// long as the lead is longer than a tick.
+TickType_t DriveManager::ticksUntilPulseLead(int64_t epochUs) {
+    const int64_t tickUs = (int64_t)portTICK_PERIOD_MS * 1000;
+    int64_t phaseUs = (esp_timer_get_time() - epochUs) % SERVO_PERIOD_US;
+    int64_t waitUs = (int64_t)SERVO_PERIOD_US - phaseUs - DRIVE_PPM_LEAD_US;
+    if (waitUs <= 0) {
+        waitUs += SERVO_PERIOD_US;
+    }
+    TickType_t ticks = (TickType_t)((waitUs + tickUs - 1) / tickUs);
+    return ticks > 0 ? ticks : 1;
+}
+
 // ---------------------------------------------------------------------------
 // Expo helper
 // ---------------------------------------------------------------------------
@@ -199,25 +243,62 @@ void DriveManager::driveTaskFunc(void* param) {
 
     LOG_INFO(TAG, "Drive task running on core %d", xPortGetCoreID());
 
-    TickType_t lastWake = xTaskGetTickCount();
     unsigned long lastLogMs = millis();
+    int64_t lastTickUs = esp_timer_get_time();
+
+    // Input watchdog: when the controller state was last published
+    uint32_t lastStatesSeq = 0;
+    int64_t lastStatesUs = lastTickUs;
+    bool inputLost = false;
 
     // Smoothed drive output (persists across ticks for low-pass filter)
     float smoothedLeft = 0.0f;
     float smoothedRight = 0.0f;
 
+    // Receive time of the last controller report traced to the servos
+    uint32_t tracedRxUs = 0;
+
     for (;;) {
-        // Sleep until next 20ms tick (50Hz)
-        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(DRIVE_UPDATE_MS));
+        // Sleep until new input, or until just before the next PPM period
+        // (the watchdog tick when no input arrives)
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, DRIVE_NOTIFY_BIT, &bits, ticksUntilPulseLead(self->_ppmEpochUs));
+
+        // Times the rest of this tick
+        PROFILE_SCOPE(PROF_STAGE_DRIVE);
 
         unsigned long now = millis();
+        int64_t tickUs = esp_timer_get_time();
+
+        // Loop watchdog only: loop() publishes on every iteration, so a
+        // sequence that stops moving means the loop has stalled (trim, arm
+        // and overrides no longer update) and the last stick position must
+        // not keep driving. Armed by the first publish (loop() is not
+        // running yet while setup() finishes).
+        ControllerStates controllers;
+        uint32_t statesSeq = g_controllerManager.readStates(&controllers);
+        if (statesSeq != lastStatesSeq) {
+            lastStatesSeq = statesSeq;
+            lastStatesUs = tickUs;
+        }
+        bool stale = lastStatesSeq != 0
+                     && (tickUs - lastStatesUs) > (int64_t)DRIVE_INPUT_WATCHDOG_MS * 1000;
+        if (stale != inputLost) {
+            inputLost = stale;
+            if (stale) {
+                LOG_WARN(TAG, "Controller state not updated for %dms, stopping", DRIVE_INPUT_WATCHDOG_MS);
+            } else {
+                LOG_INFO(TAG, "Controller state updates resumed");
+            }
+        }
 
-        // Find the first connected controller
+        // Input straight from the mailbox: first connected controller that
+        // has reported (same slot order as loop())
+        ControllerState input;
         const ControllerState* activeCtrl = nullptr;
-        for (int i = 0; i < CONTROLLER_MAX_COUNT; i++) {
-            const ControllerState& state = g_controllerManager.getState(i);
-            if (state.connected) {
-                activeCtrl = &state;
+        for (int i = 0; i < CONTROLLER_MAX_COUNT && !stale; i++) {
+            if (g_controllerManager.peekInput(i, &input)) {
+                activeCtrl = &input;
                 break;
             }
         }
@@ -227,11 +308,12 @@ void DriveManager::driveTaskFunc(void* param) {
         float leftDrive = 0.0f;
         float rightDrive = 0.0f;
 
-        if (self->_overrideActive) {
+        DriveOverride ovr = self->_override.load();
+        if (ovr.active) {
             // Drive override: use explicit values from self-righting / nose-down.
             // Bypasses controller input and inversion -- the caller handles orientation.
-            leftDrive  = self->_overrideLeft;
-            rightDrive = self->_overrideRight;
+            leftDrive  = ovr.left;
+            rightDrive = ovr.right;
         } else if (activeCtrl != nullptr) {
             // Use right stick only for drive (left stick is reserved for motor control)
             float rawX = (float)activeCtrl->rx;
@@ -252,7 +334,7 @@ void DriveManager::driveTaskFunc(void* param) {
             // If robot is upside-down, negate throttle so forward stays "forward"
             // from the driver's perspective. Turn is unchanged (steering reverses
             // physically when flipped, so the same stick direction stays correct).
-            if (self->_inverted) {
+            if (self->_inverted.load(std::memory_order_relaxed)) {
                 throttle = -throttle;
             }
 
@@ -281,23 +363,35 @@ void DriveManager::driveTaskFunc(void* param) {
 
         // Apply exponential smoothing (low-pass filter).
         // When no controller is connected, leftDrive/rightDrive are 0 and the
-        // filter naturally decays the output toward stop.
-        smoothedLeft  += DRIVE_SMOOTHING * (leftDrive  - smoothedLeft);
-        smoothedRight += DRIVE_SMOOTHING * (rightDrive - smoothedRight);
+        // filter naturally decays the output toward stop. Ticks are irregular
+        // (one per input report plus one per PPM period), so the per-step
+        // alpha is scaled to the elapsed time to keep the response the same.
+        float steps = (float)(tickUs - lastTickUs) / (DRIVE_SMOOTHING_STEP_MS * 1000.0f);
+        lastTickUs = tickUs;
+        float alpha = 1.0f - powf(1.0f - DRIVE_SMOOTHING, steps);
+        smoothedLeft  += alpha * (leftDrive  - smoothedLeft);
+        smoothedRight += alpha * (rightDrive - smoothedRight);
 
         // Convert smoothed values to servo pulse widths
         leftUs  = driveToMicroseconds(smoothedLeft);
         rightUs = driveToMicroseconds(smoothedRight);
 
-        // Write to servo hardware
+        // Write to servo hardware (latched at the next PPM period)
+        uint32_t pickupUs = (uint32_t)esp_timer_get_time();
         writeServo(LEDC_SERVO_LEFT_CH, leftUs);
         writeServo(LEDC_SERVO_RIGHT_CH, rightUs);
 
-        // Update shared state for display/web (volatile writes)
-        self->_leftDrive = smoothedLeft;
-        self->_rightDrive = smoothedRight;
-        self->_leftPulseUs = leftUs;
-        self->_rightPulseUs = rightUs;
+        // Latency trace: first tick that drives the servos from a new report
+        if (!ovr.active && activeCtrl != nullptr && activeCtrl->inputRxUs != 0
+            && activeCtrl->inputRxUs != tracedRxUs) {
+            tracedRxUs = activeCtrl->inputRxUs;
+            g_profiler.record(PROF_STAGE_IN_DRIVE, pickupUs - activeCtrl->inputUpdateUs);
+            g_profiler.record(PROF_STAGE_IN_SERVO, (uint32_t)esp_timer_get_time() - activeCtrl->inputRxUs);
+        }
+
+        // Publish for display/web
+        DriveOutputs out = {leftUs, rightUs, smoothedLeft, smoothedRight};
+        self->_outputs.store(out);
 
         // Periodic log (every 500ms)
         if ((now - lastLogMs) >= 500) {
@@ -7,8 +7,17 @@
 // applies an expo curve for fine control, performs arcade-style mixing for
 // differential drive, and outputs standard RC servo PPM via ESP32 LEDC.
 //
-// Runs as a dedicated FreeRTOS task on CPU0 at 50Hz for deterministic timing,
-// completely isolated from display/WiFi/web on CPU1.
+// Runs as a dedicated FreeRTOS task on CPU0, completely isolated from
+// display/WiFi/web on CPU1. The task sleeps on a task notification:
+// Bluepad32 wakes it as soon as a report lands in the input mailbox, which
+// it reads directly (ControllerManager::peekInput()), and a timeout wakes it
+// DRIVE_PPM_LEAD_US before each PPM period so the pulse always carries the
+// latest value. If loop() stops publishing controller state for
+// DRIVE_INPUT_WATCHDOG_MS, the drive decays to stop.
+//
+// State crosses cores through SeqLocks (seqlock.h): the task publishes its
+// outputs every tick, and the override set from loop() is published as one
+// unit, so neither side ever sees a half-updated left/right pair.
 //
 // Usage:
 //   DriveManager drive;
@@ -19,6 +28,16 @@
 // =============================================================================
 
 #include <Arduino.h>
+#include <atomic>
+#include "seqlock.h"
+
+// Outputs published by the drive task every tick
+struct DriveOutputs {
+    uint16_t leftPulseUs;       // 1000-2000 us
+    uint16_t rightPulseUs;
+    float leftDrive;            // -1.0 to 1.0 (smoothed)
+    float rightDrive;
+};
 
 class DriveManager {
 public:
@@ -26,13 +45,15 @@ public:
     // Must be called once in setup().
     void begin();
 
+    // Coherent copy of the latest outputs. Safe from any task.
+    DriveOutputs getOutputs() const;
+
     // Current servo pulse widths in microseconds (1000-2000, center 1500).
-    // Thread-safe: volatile, read from CPU1, written from CPU0.
+    // Individual fields of getOutputs() -- use that when reading several.
     uint16_t getLeftPulse() const;
     uint16_t getRightPulse() const;
 
     // Current drive values as normalized floats (-1.0 to 1.0).
-    // Thread-safe: volatile, read from CPU1, written from CPU0.
     float getLeftDrive() const;
     float getRightDrive() const;
 
@@ -42,6 +63,7 @@ public:
 
     // Override normal controller drive with explicit left/right values (-1..1).
     // Used by self-righting and nose-down modes. Bypasses inversion.
+    // loop() only (single writer).
     void setOverride(float left, float right);
 
     // Clear drive override, returning to normal controller input.
@@ -50,19 +72,19 @@ public:
 private:
     bool _initialized = false;
 
-    // Output state -- volatile for cross-core visibility (written on CPU0, read on CPU1)
-    volatile uint16_t _leftPulseUs = 1500;
-    volatile uint16_t _rightPulseUs = 1500;
-    volatile float _leftDrive = 0.0f;
-    volatile float _rightDrive = 0.0f;
+    // Output state -- written by the drive task (CPU0), read anywhere
+    SeqLock<DriveOutputs> _outputs;
 
     // Drive inversion (for upside-down driving) -- written CPU1, read CPU0
-    volatile bool _inverted = false;
+    std::atomic<bool> _inverted{false};
 
     // Drive override -- written CPU1, read CPU0
-    volatile bool _overrideActive = false;
-    volatile float _overrideLeft = 0.0f;
-    volatile float _overrideRight = 0.0f;
+    struct DriveOverride {
+        bool active;
+        float left;
+        float right;
+    };
+    SeqLock<DriveOverride> _override;
 
     // Initialize LEDC timer and channels for servo PWM.
     bool initLedc();
@@ -78,6 +100,14 @@ private:
     // Input and output are in [-1.0, 1.0].
     static float applyExpo(float input, float expo);
 
+    // Drive task, and the time a PPM period started (set in begin())
+    TaskHandle_t _task = nullptr;
+    int64_t _ppmEpochUs = 0;
+
+    // Ticks to wait so the task wakes DRIVE_PPM_LEAD_US before the next
+    // PPM period starts (when LEDC latches the duty for the next pulse).
+    static TickType_t ticksUntilPulseLead(int64_t epochUs);
+
     // The FreeRTOS task function (static, receives DriveManager* as param).
     static void driveTaskFunc(void* param);
 };
@@ -0,0 +1,177 @@
+// =============================================================================
+// Flight Recorder Module - Implementation
+// =============================================================================
+
+#include "flight_recorder.h"
+#include "config.h"
+#include "debug_log.h"
+
+#include <esp_heap_caps.h>
+#include <cstring>
+#include <new>
+
+static const char* TAG = "FlightRec";
+
+static_assert(sizeof(FlightRecord) == 80, "FlightRecord layout changed -- bump FLIGHT_REC_VERSION and the decoder");
+static_assert(sizeof(FlightRecordingHeader) == 16, "FlightRecordingHeader layout changed");
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+
+bool FlightRecorder::begin() {
+    size_t ringBytes = (size_t)FLIGHT_REC_CAPACITY * sizeof(FlightRecord);
+    size_t seqBytes = (size_t)FLIGHT_REC_CAPACITY * sizeof(std::atomic<uint32_t>);
+
+    _ring = (FlightRecord*)heap_caps_malloc(ringBytes, MALLOC_CAP_SPIRAM);
+    void* seqMem = heap_caps_malloc(seqBytes, MALLOC_CAP_SPIRAM);
+    if (_ring == nullptr || seqMem == nullptr) {
+        LOG_ERROR(TAG, "Failed to allocate %u B in PSRAM -- recorder disabled",
+                  (unsigned)(ringBytes + seqBytes));
+        heap_caps_free(_ring);
+        heap_caps_free(seqMem);
+        _ring = nullptr;
+        return false;
+    }
+
+    _slotSeq = (std::atomic<uint32_t>*)seqMem;
+    for (uint32_t i = 0; i < FLIGHT_REC_CAPACITY; i++) {
+        new (&_slotSeq[i]) std::atomic<uint32_t>(SEQ_INVALID);
+    }
+    _capacity = FLIGHT_REC_CAPACITY;
+
+    LOG_INFO(TAG, "Recorder ready: %lu records x %u B in PSRAM (%.0f s at %d Hz)",
+             (unsigned long)_capacity, (unsigned)sizeof(FlightRecord),
+             _capacity * IMU_UPDATE_MS / 1000.0f, 1000 / IMU_UPDATE_MS);
+    return true;
+}
+
+void FlightRecorder::arm() {
+    if (_ring == nullptr) {
+        return;
+    }
+    // The producer restarts the sequence before its next record
+    _triggerPending.store(false, std::memory_order_relaxed);
+    _resetPending.store(true, std::memory_order_release);
+    _captureId.fetch_add(1, std::memory_order_acq_rel);
+    _state.store(ARMED, std::memory_order_release);
+    LOG_INFO(TAG, "Armed");
+}
+
+bool FlightRecorder::autoArm() {
+    if (_ring == nullptr) {
+        return false;
+    }
+    uint8_t state = _state.load(std::memory_order_acquire);
+    if (state == IDLE || (state == STOPPED && isDownloaded())) {
+        arm();
+        return true;
+    }
+    LOG_INFO(TAG, "Auto-arm skipped: %s capture not downloaded yet",
+             stateName((State)state));
+    return false;
+}
+
+void FlightRecorder::markDownloaded(uint32_t captureId) {
+    _downloadedId.store(captureId, std::memory_order_release);
+}
+
+bool FlightRecorder::isDownloaded() const {
+    return _downloadedId.load(std::memory_order_acquire) == getCaptureId();
+}
+
+void FlightRecorder::trigger() {
+    uint8_t expected = ARMED;
+    if (_state.compare_exchange_strong(expected, TRIGGERED, std::memory_order_acq_rel)) {
+        _triggerPending.store(true, std::memory_order_release);
+        LOG_INFO(TAG, "Triggered at record %lu", (unsigned long)getWriteCount());
+    }
+}
+
+void FlightRecorder::stop() {
+    uint8_t state = _state.load(std::memory_order_acquire);
+    if (state == ARMED || state == TRIGGERED) {
+        _state.store(STOPPED, std::memory_order_release);
+        LOG_INFO(TAG, "Stopped (%lu records)", (unsigned long)getWriteCount());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Producer
+// ---------------------------------------------------------------------------
+
+void FlightRecorder::record(const FlightRecord& rec) {
+    if (_ring == nullptr) {
+        return;
+    }
+
+    if (_resetPending.exchange(false, std::memory_order_acq_rel)) {
+        _writeCount.store(0, std::memory_order_release);
+    }
+
+    uint8_t state = _state.load(std::memory_order_acquire);
+    if (state != ARMED && state != TRIGGERED) {
+        return;
+    }
+
+    uint32_t seq = _writeCount.load(std::memory_order_relaxed);
+    uint8_t extraFlags = 0;
+    if (_triggerPending.exchange(false, std::memory_order_acq_rel)) {
+        _stopAtSeq = seq + FLIGHT_REC_POST_TRIGGER;
+        extraFlags = FLIGHT_REC_FLAG_TRIGGER;
+    }
+
+    // Per-slot seqlock: invalidate, write the body, then publish the seq
+    uint32_t idx = seq % _capacity;
+    _slotSeq[idx].store(SEQ_INVALID, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    FlightRecord* slot = &_ring[idx];
+    memcpy(slot, &rec, sizeof(FlightRecord));
+    slot->seq = seq;
+    slot->flags |= extraFlags;
+
+    _slotSeq[idx].store(seq, std::memory_order_release);
+    _writeCount.store(seq + 1, std::memory_order_release);
+
+    if (state == TRIGGERED && seq + 1 >= _stopAtSeq) {
+        uint8_t expected = TRIGGERED;
+        if (_state.compare_exchange_strong(expected, STOPPED, std::memory_order_acq_rel)) {
+            LOG_INFO(TAG, "Capture complete (%lu records)", (unsigned long)(seq + 1));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Readers
+// ---------------------------------------------------------------------------
+
+uint32_t FlightRecorder::getOldestSeq() const {
+    uint32_t count = getWriteCount();
+    return (count > _capacity) ? (count - _capacity) : 0;
+}
+
+bool FlightRecorder::readRecord(uint32_t seq, FlightRecord* out) const {
+    if (_ring == nullptr) {
+        return false;
+    }
+    uint32_t idx = seq % _capacity;
+    uint32_t before = _slotSeq[idx].load(std::memory_order_acquire);
+    if (before != seq) {
+        return false;
+    }
+    memcpy(out, &_ring[idx], sizeof(FlightRecord));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t after = _slotSeq[idx].load(std::memory_order_relaxed);
+    return after == seq;
+}
+
+const char* FlightRecorder::stateName(State state) {
+    switch (state) {
+        case IDLE:      return "idle";
+        case ARMED:     return "armed";
+        case TRIGGERED: return "triggered";
+        case STOPPED:   return "stopped";
+        default:        return "?";
+    }
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+// =============================================================================
+// Flight Recorder Module
+// =============================================================================
+// Captures every balance-task tick (IMU, PID, arm commands, arm feedback) as
+// a fixed-size binary record into a ring buffer in PSRAM, for offline PID
+// tuning. At 100 Hz the default FLIGHT_REC_CAPACITY holds ~80 s.
+//
+// Recording is controlled with arm/trigger/stop:
+//
+//   IDLE --arm()--> ARMED --trigger()--> TRIGGERED --(post-trigger)--> STOPPED
+//                     |                                                  ^
+//                     +------------------------stop()-------------------+
+//
+// ARMED records continuously, overwriting the oldest records. trigger()
+// marks the moment of interest and keeps recording FLIGHT_REC_POST_TRIGGER
+// more records, so the capture holds what led up to it and what followed.
+// STOPPED freezes the ring until the next arm().
+//
+// Automatic captures (FLIGHT_REC_AUTO_ARM) use autoArm(), which never
+// throws away a capture nobody has seen: it only arms from IDLE, or from a
+// STOPPED capture that has been downloaded in full since it was armed. A
+// capture that is still recording, or frozen and not downloaded yet, is
+// left alone until it is fetched or re-armed by hand.
+//
+// Lock-free: exactly one producer (the balance task) calls record(). Each
+// slot carries its own sequence word, written around the record body like
+// a seqlock, so readers on other tasks (the /recording.bin handler) can copy
+// records while recording continues and drop any that were overwritten
+// mid-copy. Control calls only flip atomics; the producer applies them.
+//
+// Download format (/recording.bin, little-endian):
+//   FlightRecordingHeader, then FlightRecord x N (oldest first, N read to
+//   EOF -- header.recordCount is an upper bound while still recording).
+//   tools/decode_recording.py converts it to CSV.
+//
+// Usage:
+//   g_flightRecorder.begin();            // setup(): allocates the PSRAM ring
+//   g_flightRecorder.record(rec);        // balance task, every tick
+//   g_flightRecorder.arm(); ... trigger();
+// =============================================================================
+
+#include <Arduino.h>
+#include <atomic>
+
+#define FLIGHT_REC_MAGIC         0x5246524Au  // "JRFR"
+#define FLIGHT_REC_VERSION       1
+
+// One balance tick (80 bytes, no padding)
+struct FlightRecord {
+    uint32_t seq;           // Record number since arm()
+    uint32_t timestampUs;   // esp_timer time of the IMU read (low 32 bits)
+
+    // ---- Attitude ----
+    float pitch;            // rad, fused
+    float accelPitch;       // rad, raw accelerometer
+    float pitchRate;        // rad/s, bias-corrected gyro
+    float dt;               // s, measured tick interval
+
+    // ---- PID ----
+    float error;            // rad
+    float pidOut;
+    float integral;
+    float rampProgress;     // 0..1
+
+    // ---- Arm commands (target space, rad) ----
+    float leftTarget;
+    float rightTarget;
+
+    // ---- Arm feedback (raw motor frame: right arm is negated) ----
+    float leftPos;          // rad
+    float rightPos;
+    float leftVel;          // rad/s
+    float rightVel;
+    float leftTorque;       // Nm
+    float rightTorque;
+    uint16_t leftFbAgeUs;   // Age of the feedback frame (clamped to 65535)
+    uint16_t rightFbAgeUs;
+
+    uint8_t flags;          // FLIGHT_REC_FLAG_*
+    uint8_t reserved[3];
+};
+
+#define FLIGHT_REC_FLAG_BALANCING       0x01
+#define FLIGHT_REC_FLAG_UPSIDE_DOWN     0x02
+#define FLIGHT_REC_FLAG_ACCEL_TRUSTED   0x04
+#define FLIGHT_REC_FLAG_TRIGGER         0x08    // First record at/after trigger()
+
+// Prefix of /recording.bin (16 bytes)
+struct FlightRecordingHeader {
+    uint32_t magic;         // FLIGHT_REC_MAGIC
+    uint16_t version;       // FLIGHT_REC_VERSION
+    uint16_t recordSize;    // sizeof(FlightRecord)
+    uint32_t recordCount;   // Records that follow (upper bound)
+    uint32_t periodUs;      // Nominal tick period
+};
+
+class FlightRecorder {
+public:
+    enum State : uint8_t {
+        IDLE,           // Not recording
+        ARMED,          // Recording, waiting for trigger
+        TRIGGERED,      // Recording the post-trigger window
+        STOPPED         // Frozen capture
+    };
+
+    // Allocate the ring in PSRAM. Returns false (and records nothing) if
+    // the allocation fails. Call once in setup().
+    bool begin();
+
+    // ---- Control (any task) ----
+    void arm();         // Start a fresh capture
+    void trigger();     // Keep FLIGHT_REC_POST_TRIGGER more records, then stop
+    void stop();        // Freeze now
+
+    // arm() unless that would discard an unseen capture (see above).
+    // Returns true if it armed.
+    bool autoArm();
+
+    // Capture number, bumped by every arm()
+    uint32_t getCaptureId() const { return _captureId.load(std::memory_order_acquire); }
+
+    // Record that capture captureId was downloaded in full while STOPPED
+    void markDownloaded(uint32_t captureId);
+    bool isDownloaded() const;
+
+    // ---- Producer (balance task only) ----
+    void record(const FlightRecord& rec);
+
+    // ---- Readers (any task) ----
+    State getState() const { return (State)_state.load(std::memory_order_acquire); }
+    bool isAvailable() const { return _ring != nullptr; }
+    uint32_t getCapacity() const { return _capacity; }
+
+    // Total records written since arm() (seq of the next record)
+    uint32_t getWriteCount() const { return _writeCount.load(std::memory_order_acquire); }
+
+    // Seq of the oldest record still in the ring
+    uint32_t getOldestSeq() const;
+
+    // Copy the record with this seq. Returns false if it has been
+    // overwritten (or not written yet).
+    bool readRecord(uint32_t seq, FlightRecord* out) const;
+
+    static const char* stateName(State state);
+
+private:
+    static const uint32_t SEQ_INVALID = 0xFFFFFFFFu;
+
+    FlightRecord* _ring = nullptr;
+    std::atomic<uint32_t>* _slotSeq = nullptr;  // Per-slot seqlock word
+    uint32_t _capacity = 0;
+
+    std::atomic<uint8_t> _state{IDLE};
+    std::atomic<bool> _resetPending{false};
+    std::atomic<bool> _triggerPending{false};
+    std::atomic<uint32_t> _writeCount{0};
+    std::atomic<uint32_t> _captureId{0};
+    std::atomic<uint32_t> _downloadedId{SEQ_INVALID};  // Capture last downloaded
+    uint32_t _stopAtSeq = 0;                    // Producer-owned
+};
@@ -0,0 +1,241 @@
+// =============================================================================
+// JSON Writer Module - Implementation
+// =============================================================================
+
+#include "json_writer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+JsonWriter::JsonWriter(char* buf, size_t size) : _buf(buf), _size(size) {
+    if (_size > 0) {
+        _buf[0] = '\0';
+    } else {
+        _overflow = true;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Containers
+// ---------------------------------------------------------------------------
+
+void JsonWriter::beginObject() {
+    separator();
+    push('{');
+}
+
+void JsonWriter::beginObject(const char* k) {
+    key(k);
+    beginObject();
+}
+
+void JsonWriter::endObject() {
+    pop('}');
+}
+
+void JsonWriter::beginArray() {
+    separator();
+    push('[');
+}
+
+void JsonWriter::beginArray(const char* k) {
+    key(k);
+    beginArray();
+}
+
+void JsonWriter::endArray() {
+    pop(']');
+}
+
+// ---------------------------------------------------------------------------
+// Values
+// ---------------------------------------------------------------------------
+
+void JsonWriter::key(const char* k) {
+    separator();
+    putEscaped(k);
+    put(':');
+    _afterKey = true;
+}
+
+void JsonWriter::value(const char* s) {
+    separator();
+    if (s == nullptr) {
+        put("null", 4);
+        return;
+    }
+    putEscaped(s);
+}
+
+void JsonWriter::value(bool b) {
+    separator();
+    if (b) {
+        put("true", 4);
+    } else {
+        put("false", 5);
+    }
+}
+
+void JsonWriter::value(int v) {
+    value((long)v);
+}
+
+void JsonWriter::value(unsigned v) {
+    value((unsigned long)v);
+}
+
+void JsonWriter::value(long v) {
+    separator();
+    if (v < 0) {
+        put('-');
+        putUnsigned((unsigned long long)(-(long long)v));
+    } else {
+        putUnsigned((unsigned long long)v);
+    }
+}
+
+void JsonWriter::value(unsigned long v) {
+    separator();
+    putUnsigned(v);
+}
+
+void JsonWriter::value(float v, int decimals) {
+    separator();
+    if (!std::isfinite(v)) {
+        put("null", 4);
+        return;
+    }
+    if (decimals < 0) { decimals = 0; }
+    if (decimals > 6) { decimals = 6; }
+
+    // Fixed-point: scale, round, print integer and fraction digits. Values
+    // too large for that go through snprintf instead.
+    double d = v;
+    if (fabs(d) >= 1e12) {
+        char tmp[32];
+        int n = snprintf(tmp, sizeof(tmp), "%.*g", 9, d);
+        put(tmp, (size_t)n);
+        return;
+    }
+
+    unsigned long long scale = 1;
+    for (int i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+    bool negative = d < 0.0;
+    unsigned long long scaled = (unsigned long long)(fabs(d) * (double)scale + 0.5);
+    if (negative && scaled != 0) {
+        put('-');
+    }
+    putUnsigned(scaled / scale);
+    if (decimals > 0) {
+        put('.');
+        char frac[8];
+        unsigned long long rem = scaled % scale;
+        for (int i = decimals - 1; i >= 0; i--) {
+            frac[i] = (char)('0' + rem % 10);
+            rem /= 10;
+        }
+        put(frac, (size_t)decimals);
+    }
+}
+
+void JsonWriter::null() {
+    separator();
+    put("null", 4);
+}
+
+// ---------------------------------------------------------------------------
+// Internals
+// ---------------------------------------------------------------------------
+
+void JsonWriter::separator() {
+    if (_afterKey) {
+        // Value completing a key: pair -- no comma
+        _afterKey = false;
+        return;
+    }
+    if (_depth == 0) {
+        return;
+    }
+    uint16_t bit = (uint16_t)(1u << (_depth - 1));
+    if (_hasItems & bit) {
+        put(',');
+    }
+    _hasItems |= bit;
+}
+
+void JsonWriter::push(char open) {
+    put(open);
+    if (_depth >= MAX_DEPTH) {
+        _overflow = true;
+        return;
+    }
+    _depth++;
+    _hasItems &= (uint16_t)~(1u << (_depth - 1));
+}
+
+void JsonWriter::pop(char close) {
+    if (_depth > 0) {
+        _depth--;
+    }
+    put(close);
+}
+
+void JsonWriter::put(char c) {
+    put(&c, 1);
+}
+
+void JsonWriter::put(const char* s, size_t n) {
+    if (_overflow) {
+        return;
+    }
+    // Keep one byte for the terminator
+    if (_len + n + 1 > _size) {
+        _overflow = true;
+        return;
+    }
+    memcpy(_buf + _len, s, n);
+    _len += n;
+    _buf[_len] = '\0';
+}
+
+void JsonWriter::putUnsigned(unsigned long long v) {
+    char tmp[20];
+    int i = sizeof(tmp);
+    do {
+        tmp[--i] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    put(tmp + i, sizeof(tmp) - i);
+}
+
+void JsonWriter::putEscaped(const char* s) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    put('"');
+    const char* run = s;
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+        // Flush the plain run, then the escape
+        put(run, (size_t)(s - run));
+        run = s + 1;
+        switch (c) {
+            case '"':  put("\\\"", 2); break;
+            case '\\': put("\\\\", 2); break;
+            case '\n': put("\\n", 2); break;
+            case '\r': put("\\r", 2); break;
+            case '\t': put("\\t", 2); break;
+            default: {
+                char esc[6] = { '\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF] };
+                put(esc, 6);
+                break;
+            }
+        }
+    }
+    put(run, (size_t)(s - run));
+    put('"');
+}
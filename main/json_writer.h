@@ -0,0 +1,86 @@
+#pragma once
+
+// =============================================================================
+// JSON Writer Module
+// =============================================================================
+// Streaming JSON serializer that writes straight into a caller-owned,
+// fixed-size buffer. No heap allocation, no intermediate document: the
+// schema is simply the order of calls in the handler, so it is fixed at
+// compile time.
+//
+// Commas are inserted automatically. Floats are written with a fixed number
+// of decimals (NaN/Inf become null). If the output doesn't fit, writing
+// stops, overflowed() turns true and the buffer holds a truncated prefix --
+// callers must check it before sending.
+//
+// Usage:
+//   JsonWriter w(buf, sizeof(buf));
+//   w.beginObject();
+//   w.field("id", 3);
+//   w.field("pos", 1.2345f, 3);
+//   w.beginArray("items");
+//   w.value("a");
+//   w.endArray();
+//   w.endObject();
+//   if (!w.overflowed()) send(w.c_str(), w.length());
+// =============================================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+class JsonWriter {
+public:
+    JsonWriter(char* buf, size_t size);
+
+    // ---- Containers ----
+    void beginObject();
+    void beginObject(const char* key);
+    void endObject();
+    void beginArray();
+    void beginArray(const char* key);
+    void endArray();
+
+    // ---- Values (array elements, or after key()) ----
+    void key(const char* k);
+    void value(const char* s);
+    void value(bool b);
+    void value(int v);
+    void value(unsigned v);
+    void value(long v);
+    void value(unsigned long v);
+    void value(float v, int decimals);
+    void null();
+
+    // ---- Object members (key + value) ----
+    void field(const char* k, const char* s) { key(k); value(s); }
+    void field(const char* k, bool b)        { key(k); value(b); }
+    void field(const char* k, int v)         { key(k); value(v); }
+    void field(const char* k, unsigned v)    { key(k); value(v); }
+    void field(const char* k, long v)        { key(k); value(v); }
+    void field(const char* k, unsigned long v) { key(k); value(v); }
+    void field(const char* k, float v, int decimals) { key(k); value(v, decimals); }
+
+    const char* c_str() const { return _buf; }
+    size_t length() const { return _len; }
+    bool overflowed() const { return _overflow; }
+
+private:
+    static const int MAX_DEPTH = 16;
+
+    char* _buf;
+    size_t _size;
+    size_t _len = 0;
+    bool _overflow = false;
+
+    int _depth = 0;
+    uint16_t _hasItems = 0;     // Bit per depth: container already has an element
+    bool _afterKey = false;     // Next value completes a "key": pair
+
+    void separator();
+    void push(char open);
+    void pop(char close);
+    void put(char c);
+    void put(const char* s, size_t n);
+    void putUnsigned(unsigned long long v);
+    void putEscaped(const char* s);
+};
@@ -0,0 +1,267 @@
+// =============================================================================
+// Motor Init Module - Implementation
+// =============================================================================
+
+#include "motor_init.h"
+#include "config.h"
+#include "debug_log.h"
+#include "motor_manager.h"
+
+#include <cmath>
+#include <esp_timer.h>
+
+static const char* TAG = "MotorInit";
+
+// MotorInit::_checkState layout
+static const int CHECK_GEN_SHIFT = 8;
+static const int CHECK_NACK_SHIFT = 4;
+static const uint32_t CHECK_BITS_MASK = 0x0F;
+
+static uint32_t checkGeneration(uint32_t state) { return state >> CHECK_GEN_SHIFT; }
+static uint32_t checkAcks(uint32_t state) { return state & CHECK_BITS_MASK; }
+static uint32_t checkNacks(uint32_t state) { return (state >> CHECK_NACK_SHIFT) & CHECK_BITS_MASK; }
+
+extern MotorManager g_motorManager;
+
+// =============================================================================
+// Public Methods
+// =============================================================================
+
+void MotorInit::start(uint8_t motorId, bool setZero, float speedLimit, float accel,
+                      float currentLimit) {
+    _motorId = motorId;
+    _setZero = setZero;
+    _speedLimit = speedLimit;
+    _accel = accel;
+    _currentLimit = currentLimit;
+
+    LOG_INFO(TAG, "Init motor %d (stop%s->PP->enable, spd=%.1f accel=%.1f cur=%.1f)",
+             motorId, setZero ? "->zero" : "", speedLimit, accel, currentLimit);
+    enterStep(STOPPING);
+}
+
+void MotorInit::update() {
+    if (_state == IDLE || _state == READY || _state == FAILED) {
+        return;
+    }
+
+    // Re-issue any readbacks that couldn't be queued last time
+    requestChecks();
+
+    if (stepAcked()) {
+        switch (_state) {
+            case STOPPING:
+                enterStep(_setZero ? ZEROING : SET_MODE);
+                break;
+            case ZEROING:
+                LOG_INFO(TAG, "Auto-zeroed motor %d (arms assumed in front)", _motorId);
+                enterStep(SET_MODE);
+                break;
+            case SET_MODE:
+                enterStep(SET_PARAMS);
+                break;
+            case SET_PARAMS:
+                enterStep(ENABLING);
+                break;
+            case ENABLING:
+                _state = READY;
+                LOG_INFO(TAG, "Motor %d ready", _motorId);
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+
+    // A readback came back wrong, or the step has waited too long: resend
+    bool nack = (checkNacks(_checkState.load(std::memory_order_acquire)) != 0);
+    if (nack || millis() - _stepStartMs >= MOTOR_INIT_STEP_TIMEOUT_MS) {
+        if (_attempts >= MOTOR_INIT_MAX_ATTEMPTS) {
+            LOG_WARN(TAG, "Motor %d init failed at step %d after %d attempts",
+                     _motorId, _state, _attempts);
+            _state = FAILED;
+            _failedMs = millis();
+            return;
+        }
+        LOG_DEBUG(TAG, "Motor %d step %d not acknowledged -- retrying", _motorId, _state);
+        sendStep();
+    }
+}
+
+void MotorInit::reset() {
+    _state = IDLE;
+    _motorId = 0;
+}
+
+bool MotorInit::canRetry() const {
+    return _state == FAILED && millis() - _failedMs >= MOTOR_INIT_RETRY_MS;
+}
+
+// =============================================================================
+// Steps
+// =============================================================================
+
+void MotorInit::enterStep(State state) {
+    _state = state;
+    _attempts = 0;
+    sendStep();
+}
+
+void MotorInit::sendStep() {
+    _attempts++;
+    _stepStartMs = millis();
+    _stepStartUs = (uint32_t)esp_timer_get_time();
+
+    // Retire the previous attempt before touching the table: its reads may
+    // still answer, and must neither count for this one nor see a half-
+    // written table. Odd = being rewritten, no read carries that tag.
+    uint32_t generation = checkGeneration(_checkState.load(std::memory_order_relaxed)) + 1;
+    _checkState.store(generation << CHECK_GEN_SHIFT, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _checkCount = 0;
+    _requestedMask = 0;
+
+    switch (_state) {
+        case STOPPING:
+            // Stop first to get a clean RESET state, clearing any faults
+            g_motorManager.stopMotor(_motorId, true);
+            break;
+
+        case ZEROING:
+            g_motorManager.setMechanicalZero(_motorId);
+            break;
+
+        case SET_MODE:
+            // Run mode: Position PP (interpolated position control)
+            g_motorManager.writeUint8Param(_motorId, RobstrideParam::RUN_MODE,
+                                           RobstrideMode::POSITION_PP);
+            addCheck(RobstrideParam::RUN_MODE, (float)RobstrideMode::POSITION_PP);
+            break;
+
+        case SET_PARAMS:
+            // PP mode parameters:
+            //   LIMIT_CUR       - motor current limit
+            //   PP_SPEED        - max velocity during profiled move
+            //   PP_ACCELERATION - accel/decel rate (higher = snappier)
+            //   LIMIT_SPD       - general safety speed backstop
+            g_motorManager.writeFloatParam(_motorId, RobstrideParam::LIMIT_CUR, _currentLimit);
+            g_motorManager.writeFloatParam(_motorId, RobstrideParam::PP_SPEED, _speedLimit);
+            g_motorManager.writeFloatParam(_motorId, RobstrideParam::PP_ACCELERATION, _accel);
+            g_motorManager.writeFloatParam(_motorId, RobstrideParam::LIMIT_SPD, _speedLimit);
+            addCheck(RobstrideParam::LIMIT_CUR, _currentLimit);
+            addCheck(RobstrideParam::PP_SPEED, _speedLimit);
+            addCheck(RobstrideParam::PP_ACCELERATION, _accel);
+            addCheck(RobstrideParam::LIMIT_SPD, _speedLimit);
+            break;
+
+        case ENABLING:
+            g_motorManager.enableMotor(_motorId);
+            break;
+
+        default:
+            break;
+    }
+
+    // Publish the table under the new generation, then request the reads
+    _checkState.store((generation + 1) << CHECK_GEN_SHIFT, std::memory_order_release);
+
+    // Reads queue behind the writes, so the motor answers with the new values
+    requestChecks();
+}
+
+bool MotorInit::stepAcked() {
+    // Readback steps: every check must have come back matching
+    if (_checkCount > 0) {
+        uint32_t all = (1u << _checkCount) - 1;
+        return (checkAcks(_checkState.load(std::memory_order_acquire)) & all) == all;
+    }
+
+    // Feedback steps: need a frame that arrived after the command went out
+    const RobstrideMotorStatus* status = findStatus();
+    if (status == nullptr || (int32_t)(status->lastRxUs - _stepStartUs) <= 0) {
+        return false;
+    }
+
+    switch (_state) {
+        case STOPPING:
+            return !status->enabled;
+        case ZEROING:
+            return fabsf(status->position) < MOTOR_INIT_ZERO_TOL_RAD;
+        case ENABLING:
+            return status->enabled;
+        default:
+            return false;
+    }
+}
+
+// =============================================================================
+// Readback Checks
+// =============================================================================
+
+void MotorInit::addCheck(uint16_t paramIndex, float value) {
+    if (_checkCount >= MAX_CHECKS) {
+        return;
+    }
+    _checkParam[_checkCount] = paramIndex;
+    _checkValue[_checkCount] = value;
+    _checkCount++;
+}
+
+void MotorInit::requestChecks() {
+    uint32_t generation = checkGeneration(_checkState.load(std::memory_order_relaxed));
+    for (int i = 0; i < _checkCount; i++) {
+        uint8_t bit = 1u << i;
+        if (_requestedMask & bit) {
+            continue;
+        }
+        if (g_motorManager.requestParamRead(_motorId, _checkParam[i], onReadback, this, generation)) {
+            _requestedMask |= bit;
+        }
+    }
+}
+
+void MotorInit::onReadback(uint8_t motorId, uint16_t paramIndex, bool ok, float value,
+                           void* ctx, uint32_t generation) {
+    MotorInit* self = static_cast<MotorInit*>(ctx);
+
+    // Late answer or timeout from an earlier attempt (or a restart): drop it
+    uint32_t state = self->_checkState.load(std::memory_order_acquire);
+    if (checkGeneration(state) != generation || motorId != self->_motorId) {
+        return;
+    }
+
+    uint32_t bit = 0;
+    for (int i = 0; i < self->_checkCount; i++) {
+        if (self->_checkParam[i] != paramIndex) {
+            continue;
+        }
+        float expected = self->_checkValue[i];
+        float tol = 1e-3f * fmaxf(1.0f, fabsf(expected));
+        bool match = ok && fabsf(value - expected) <= tol;
+        bit = match ? (1u << i) : (1u << (i + CHECK_NACK_SHIFT));
+        break;
+    }
+    if (bit == 0) {
+        return;
+    }
+
+    // The table reads above only count if no resend started meanwhile: set
+    // the bit only while the generation is still the one we checked against
+    std::atomic_thread_fence(std::memory_order_acquire);
+    while (!self->_checkState.compare_exchange_weak(state, state | bit, std::memory_order_acq_rel,
+                                                    std::memory_order_acquire)) {
+        if (checkGeneration(state) != generation) {
+            return;
+        }
+    }
+}
+
+const RobstrideMotorStatus* MotorInit::findStatus() const {
+    for (int i = 0; i < g_motorManager.getMotorCount(); i++) {
+        if (g_motorManager.getMotorId(i) == _motorId) {
+            return &g_motorManager.getMotorStatus(i);
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+// =============================================================================
+// Motor Init Module
+// =============================================================================
+// Brings one arm motor up for POSITION_PP control without blocking:
+//
+//   stop (clear faults) -> [set zero] -> RUN_MODE -> PP/limit params -> enable
+//
+// Each step is queued on the CAN bus and only advances once the motor has
+// acknowledged it: feedback frames confirm stop/zero/enable, parameter
+// readback (MotorManager::requestParamRead) confirms RUN_MODE and the tuning
+// params. A step that isn't acknowledged within MOTOR_INIT_STEP_TIMEOUT_MS is
+// re-sent, up to MOTOR_INIT_MAX_ATTEMPTS times, after which the sequence
+// fails and may be restarted after MOTOR_INIT_RETRY_MS. Readbacks are tagged
+// with the attempt that asked, so a late answer or timeout can't acknowledge
+// or fail a later one.
+//
+// Usage:
+//   MotorInit init;
+//   init.start(motorId, setZero, spd, accel, cur);  // kick off (returns immediately)
+//   init.update();                                   // call every loop iteration
+//   if (init.isReady()) { ... send position commands ... }
+// =============================================================================
+
+#include <Arduino.h>
+#include <atomic>
+#include "robstride_protocol.h"
+
+class MotorInit {
+public:
+    enum State : uint8_t {
+        IDLE,           // No motor assigned
+        STOPPING,       // MOTOR_STOP sent, waiting for a non-RUNNING feedback
+        ZEROING,        // SET_MECHANICAL_ZERO sent, waiting for position ~0
+        SET_MODE,       // RUN_MODE written, waiting for readback
+        SET_PARAMS,     // LIMIT_CUR/PP_SPEED/PP_ACCEL/LIMIT_SPD written, waiting for readback
+        ENABLING,       // MOTOR_ENABLE sent, waiting for RUNNING feedback
+        READY,          // Motor is up in POSITION_PP
+        FAILED          // A step timed out MOTOR_INIT_MAX_ATTEMPTS times
+    };
+
+    // Start (or restart) the sequence for a motor. Non-blocking.
+    void start(uint8_t motorId, bool setZero, float speedLimit, float accel, float currentLimit);
+
+    // Advance the sequence. Call every loop iteration.
+    void update();
+
+    // Forget the motor and return to IDLE (e.g. after the motor was stopped).
+    void reset();
+
+    State getState() const { return _state; }
+    uint8_t getMotorId() const { return _motorId; }
+    bool isReady() const { return _state == READY; }
+    bool isBusy() const { return _state != IDLE && _state != READY && _state != FAILED; }
+
+    // FAILED and the retry backoff has elapsed
+    bool canRetry() const;
+
+private:
+    uint8_t _motorId = 0;
+    bool _setZero = false;
+    float _speedLimit = 0.0f;
+    float _accel = 0.0f;
+    float _currentLimit = 0.0f;
+
+    State _state = IDLE;
+    unsigned long _stepStartMs = 0;
+    uint32_t _stepStartUs = 0;      // Feedback must arrive after this to count
+    int _attempts = 0;
+    unsigned long _failedMs = 0;
+
+    // Readback checks for SET_MODE / SET_PARAMS. The table is written by
+    // update() and read by the CAN task in onReadback(). _checkState packs
+    // the attempt's generation with the results: every send bumps it, reads
+    // are tagged with it, and answers for an older attempt are dropped. An
+    // odd generation means the table is being rewritten and matches no read.
+    static const int MAX_CHECKS = 4;
+    uint16_t _checkParam[MAX_CHECKS];
+    float _checkValue[MAX_CHECKS];
+    int _checkCount = 0;
+    uint8_t _requestedMask = 0;             // Reads successfully queued
+    std::atomic<uint32_t> _checkState{0};   // Generation << 8 | nack << 4 | ack
+
+    void enterStep(State state);
+    void sendStep();
+    bool stepAcked();
+    void requestChecks();
+    void addCheck(uint16_t paramIndex, float value);
+
+    // Latest feedback for our motor, or nullptr if it isn't on the bus
+    const RobstrideMotorStatus* findStatus() const;
+
+    static void onReadback(uint8_t motorId, uint16_t paramIndex, bool ok, float value,
+                           void* ctx, uint32_t generation);
+};
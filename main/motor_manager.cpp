@@ -11,6 +11,9 @@
 #include "debug_log.h"
 
 #include <driver/twai.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <Preferences.h>
 #include <cstring>
 
@@ -34,22 +37,59 @@ void MotorManager::begin() {
     _motorCount = 0;
     memset(_motorIds, 0, sizeof(_motorIds));
     memset(_motorStatus, 0, sizeof(_motorStatus));
+    memset(_lastReportArmMs, 0, sizeof(_lastReportArmMs));
+    memset(_history, 0, sizeof(_history));
+    memset(&_view, 0, sizeof(_view));
+    memset(_paramCache, 0, sizeof(_paramCache));
+    portMUX_INITIALIZE(&_txMux);
+    _txHead = 0;
+    _txTail = 0;
 
     if (!initTwai()) {
         LOG_ERROR(TAG, "TWAI initialization failed! Motors will not be available.");
         return;
     }
 
-    LOG_INFO(TAG, "TWAI driver started. Scanning for motors...");
-    scanMotors();
+    // Discovery runs on the CAN task; motors appear in the snapshot as
+    // they answer, so setup() doesn't wait for the sweep.
+    LOG_INFO(TAG, "TWAI driver started. Starting motor discovery...");
+    startScan();
+    publishSnapshot();
+
+    // Hand the bus over to the CAN task
+    BaseType_t result = xTaskCreatePinnedToCore(
+        canTaskFunc,            // Task function
+        "can",                  // Name
+        CAN_TASK_STACK,         // Stack size
+        this,                   // Parameter (MotorManager instance)
+        CAN_TASK_PRIORITY,      // Priority
+        &_canTask,              // Task handle
+        CAN_TASK_CORE           // Core ID
+    );
+
+    if (result != pdPASS) {
+        LOG_ERROR(TAG, "Failed to create CAN task");
+        _canTask = nullptr;
+        return;
+    }
 
-    if (_motorCount > 0) {
-        LOG_INFO(TAG, "Found %d motor(s). Reading initial voltage...", _motorCount);
-        // Kick off first VBUS read
-        _lastVbusPollMs = 0;
-    } else {
-        LOG_WARN(TAG, "No motors found on CAN bus. Check wiring and power.");
+    // Alerts reach the CAN task through this relay (see canAlertTaskFunc)
+    result = xTaskCreatePinnedToCore(
+        canAlertTaskFunc,
+        "can_alerts",
+        CAN_ALERT_TASK_STACK,
+        this,
+        CAN_ALERT_TASK_PRIORITY,
+        &_canAlertTask,
+        CAN_TASK_CORE
+    );
+    if (result != pdPASS) {
+        // The CAN task still runs every CAN_TASK_IDLE_MS and on each command
+        LOG_ERROR(TAG, "Failed to create CAN alert task");
+        _canAlertTask = nullptr;
     }
+
+    LOG_INFO(TAG, "CAN task started on CPU%d (prio %d)", CAN_TASK_CORE, CAN_TASK_PRIORITY);
 }
 
 void MotorManager::poll() {
@@ -57,65 +97,80 @@ void MotorManager::poll() {
         return;
     }
 
-    // Process all pending CAN messages (non-blocking)
-    twai_message_t msg;
-    int count = 0;
-    while (twai_receive(&msg, 0) == ESP_OK) {
-        if (msg.extd) {
-            processMessage(msg.identifier, msg.data, msg.data_length_code);
-        }
-        count++;
-        // Safety limit to avoid blocking the loop too long
-        if (count >= 50) {
-            break;
+    // Remember which motors were running so we can spot re-inits
+    uint8_t prevRunning[MAX_MOTORS];
+    int prevRunningCount = 0;
+    for (int i = 0; i < _view.count; i++) {
+        if (_view.status[i].enabled) {
+            prevRunning[prevRunningCount++] = _view.ids[i];
         }
     }
 
-    // Check for parameter read timeout
-    if (_paramReadPending) {
-        unsigned long now = millis();
-        if (now - _paramReadStartMs > 200) {
-            LOG_DEBUG(TAG, "Parameter read timeout for motor %d, param 0x%04X",
-                      _paramReadMotorId, _paramReadIndex);
-            _paramReadPending = false;
+    // Coherent copy of the CAN task's latest table
+    _published.load(&_view);
+
+    // Drop cached params for motors that left RUNNING (power cycle, fault,
+    // external stop) -- whatever we wrote before is gone, so the next
+    // commands must go out in full.
+    for (int p = 0; p < prevRunningCount; p++) {
+        bool stillRunning = false;
+        for (int i = 0; i < _view.count; i++) {
+            if (_view.ids[i] == prevRunning[p]) {
+                stillRunning = _view.status[i].enabled;
+                break;
+            }
+        }
+        if (!stillRunning) {
+            invalidateParamCache(prevRunning[p]);
         }
     }
 
-    // Periodic status pings to keep position/velocity/torque live
-    pollStatus();
-
-    // Check for stale or disconnected motors
-    checkStaleness();
-
-    // Periodic voltage polling
-    pollVoltage();
+    // Release cache rows for motors that are no longer on the bus
+    for (int r = 0; r < MAX_MOTORS; r++) {
+        uint8_t id = _paramCache[r].motorId;
+        if (id == 0) {
+            continue;
+        }
+        bool present = false;
+        for (int i = 0; i < _view.count; i++) {
+            if (_view.ids[i] == id) {
+                present = true;
+                break;
+            }
+        }
+        if (!present) {
+            memset(&_paramCache[r], 0, sizeof(_paramCache[r]));
+        }
+    }
 }
 
 void MotorManager::rescan() {
     if (!_running) {
         return;
     }
-    LOG_INFO(TAG, "Re-scanning CAN bus for motors...");
-    _motorCount = 0;
-    memset(_motorIds, 0, sizeof(_motorIds));
-    memset(_motorStatus, 0, sizeof(_motorStatus));
-    scanMotors();
+    LOG_INFO(TAG, "Re-scan requested");
+    _scanning.store(true, std::memory_order_release);
+    _rescanRequested.store(true, std::memory_order_release);
+}
+
+bool MotorManager::isScanning() const {
+    return _scanning.load(std::memory_order_acquire);
 }
 
 int MotorManager::getMotorCount() const {
-    return _motorCount;
+    return _view.count;
 }
 
 const RobstrideMotorStatus& MotorManager::getMotorStatus(int index) const {
-    if (index >= 0 && index < _motorCount) {
-        return _motorStatus[index];
+    if (index >= 0 && index < _view.count) {
+        return _view.status[index];
     }
     return EMPTY_STATUS;
 }
 
 uint8_t MotorManager::getMotorId(int index) const {
-    if (index >= 0 && index < _motorCount) {
-        return _motorIds[index];
+    if (index >= 0 && index < _view.count) {
+        return _view.ids[index];
     }
     return 0;
 }
@@ -124,6 +179,44 @@ bool MotorManager::isRunning() const {
     return _running;
 }
 
+uint32_t MotorManager::getFeedbackAgeUs(int index) const {
+    if (index < 0 || index >= _view.count || _view.status[index].lastRxUs == 0) {
+        return UINT32_MAX;
+    }
+    return (uint32_t)esp_timer_get_time() - _view.status[index].lastRxUs;
+}
+
+float MotorManager::getExtrapolatedPosition(int index) const {
+    if (index < 0 || index >= _view.count) {
+        return 0.0f;
+    }
+    const RobstrideMotorStatus& status = _view.status[index];
+    uint32_t ageUs = getFeedbackAgeUs(index);
+    if (ageUs > MOTOR_EXTRAPOLATE_MAX_US) {
+        ageUs = MOTOR_EXTRAPOLATE_MAX_US;
+    }
+    return status.position + status.velocity * (ageUs * 1e-6f);
+}
+
+void MotorManager::readTable(MotorTable* out) const {
+    _published.load(out);
+}
+
+bool MotorManager::readFeedback(uint8_t motorId, RobstrideMotorStatus* out) const {
+    bool found = false;
+    _published.read([&](const MotorTable& table) {
+        found = false;
+        for (int i = 0; i < table.count && i < MAX_MOTORS; i++) {
+            if (table.ids[i] == motorId) {
+                memcpy(out, &table.status[i], sizeof(*out));
+                found = true;
+                break;
+            }
+        }
+    });
+    return found;
+}
+
 // =============================================================================
 // Motor Role Configuration (NVS-persisted)
 // =============================================================================
@@ -160,9 +253,9 @@ const char* MotorManager::getRoleLabel(uint8_t motorId) const {
 
 const RobstrideMotorStatus& MotorManager::getLeftMotorStatus() const {
     if (_leftMotorId > 0) {
-        for (int i = 0; i < _motorCount; i++) {
-            if (_motorIds[i] == _leftMotorId) {
-                return _motorStatus[i];
+        for (int i = 0; i < _view.count; i++) {
+            if (_view.ids[i] == _leftMotorId) {
+                return _view.status[i];
             }
         }
     }
@@ -171,9 +264,9 @@ const RobstrideMotorStatus& MotorManager::getLeftMotorStatus() const {
 
 const RobstrideMotorStatus& MotorManager::getRightMotorStatus() const {
     if (_rightMotorId > 0) {
-        for (int i = 0; i < _motorCount; i++) {
-            if (_motorIds[i] == _rightMotorId) {
-                return _motorStatus[i];
+        for (int i = 0; i < _view.count; i++) {
+            if (_view.ids[i] == _rightMotorId) {
+                return _view.status[i];
             }
         }
     }
@@ -227,6 +320,11 @@ bool MotorManager::stopMotor(uint8_t motorId, bool clearFaults) {
     }
     uint32_t id = buildExtendedId(RobstrideComm::MOTOR_STOP, motorId);
     bool ok = sendMessage(id, data, 8);
+
+    // A stopped motor drops back to RESET and must be re-initialized, so
+    // nothing we wrote before can be assumed to still hold.
+    invalidateParamCache(motorId);
+
     if (ok) {
         LOG_INFO(TAG, "Stopped motor %d (clearFaults=%d)", motorId, clearFaults);
     }
@@ -242,6 +340,10 @@ bool MotorManager::setMechanicalZero(uint8_t motorId) {
     data[0] = 1;  // Required: data[0]=1 to confirm zero set
     uint32_t id = buildExtendedId(RobstrideComm::SET_MECHANICAL_ZERO, motorId);
     bool ok = sendMessage(id, data, 8);
+
+    // LOC_REF values are relative to the old zero -- force them to be resent
+    invalidateParamCache(motorId);
+
     if (ok) {
         LOG_INFO(TAG, "Set mechanical zero for motor %d", motorId);
     }
@@ -253,16 +355,14 @@ bool MotorManager::writeFloatParam(uint8_t motorId, uint16_t paramIndex, float v
         return false;
     }
 
-    uint8_t data[8] = {0};
-    // data[0-1]: parameter index (little-endian)
-    data[0] = paramIndex & 0xFF;
-    data[1] = (paramIndex >> 8) & 0xFF;
-    // data[4-7]: float value (little-endian IEEE 754)
-    memcpy(&data[4], &value, sizeof(float));
+    uint8_t data[8];
+    packFloatParam(data, paramIndex, value);
 
     uint32_t id = buildExtendedId(RobstrideComm::SET_SINGLE_PARAM, motorId);
     bool ok = sendMessage(id, data, 8);
     if (ok) {
+        // Keep the cache coherent with uncached writes
+        storeCachedParam(motorId, paramIndex, value);
         LOG_DEBUG(TAG, "Wrote float param 0x%04X = %.4f to motor %d",
                   paramIndex, value, motorId);
     }
@@ -290,6 +390,259 @@ bool MotorManager::writeUint8Param(uint8_t motorId, uint16_t paramIndex, uint8_t
     return ok;
 }
 
+// =============================================================================
+// Cached Command Layer
+// =============================================================================
+
+bool MotorManager::writeFloatParamCached(uint8_t motorId, uint16_t paramIndex, float value) {
+    if (!_running) {
+        return false;
+    }
+
+    const ParamCacheEntry* cached = findCachedParam(motorId, paramIndex);
+    if (cached && cached->value == value) {
+        return true;  // Motor already holds this value
+    }
+    return writeFloatParam(motorId, paramIndex, value);
+}
+
+bool MotorManager::sendPositionBatch(const PositionCommand* cmds, int count, float ppSpeed) {
+    if (!_running || cmds == nullptr || count <= 0) {
+        return false;
+    }
+
+    // Collect only the frames that would change something on the motor.
+    // Worst case is PP_SPEED + LOC_REF for every motor in the batch.
+    static const int MAX_BATCH_FRAMES = MAX_MOTORS * 2;
+    struct PendingWrite {
+        uint8_t motorId;
+        uint16_t paramIndex;
+        float value;
+    };
+    PendingWrite pending[MAX_BATCH_FRAMES];
+    twai_message_t frames[MAX_BATCH_FRAMES];
+    int pendingCount = 0;
+
+    // PP_SPEED first for every motor, then LOC_REF, so the profiler speed is
+    // in place before any of the new targets arrive.
+    for (int pass = 0; pass < 2; pass++) {
+        uint16_t paramIndex = (pass == 0) ? RobstrideParam::PP_SPEED : RobstrideParam::LOC_REF;
+        for (int i = 0; i < count && i < MAX_MOTORS; i++) {
+            float value = (pass == 0) ? ppSpeed : cmds[i].position;
+            const ParamCacheEntry* cached = findCachedParam(cmds[i].motorId, paramIndex);
+            if (cached && cached->value == value) {
+                continue;
+            }
+            PendingWrite& w = pending[pendingCount];
+            w.motorId = cmds[i].motorId;
+            w.paramIndex = paramIndex;
+            w.value = value;
+
+            uint8_t data[8];
+            packFloatParam(data, paramIndex, value);
+            buildFrame(frames[pendingCount],
+                       buildExtendedId(RobstrideComm::SET_SINGLE_PARAM, w.motorId), data, 8);
+            pendingCount++;
+        }
+    }
+
+    if (pendingCount == 0) {
+        return true;  // Nothing changed
+    }
+
+    // All-or-nothing: don't let half a batch out (one arm moving, one not)
+    if (!txRingPush(frames, pendingCount)) {
+        LOG_DEBUG(TAG, "Position batch deferred (%d frames, TX ring full)", pendingCount);
+        return false;
+    }
+
+    for (int i = 0; i < pendingCount; i++) {
+        storeCachedParam(pending[i].motorId, pending[i].paramIndex, pending[i].value);
+    }
+    return true;
+}
+
+void MotorManager::invalidateParamCache(uint8_t motorId) {
+    ParamCacheRow* row = findCacheRow(motorId, false);
+    if (row) {
+        memset(row->entries, 0, sizeof(row->entries));
+        row->nextEvict = 0;
+    }
+}
+
+MotorManager::ParamCacheRow* MotorManager::findCacheRow(uint8_t motorId, bool create) {
+    if (motorId == 0) {
+        return nullptr;
+    }
+    ParamCacheRow* freeRow = nullptr;
+    for (int r = 0; r < MAX_MOTORS; r++) {
+        if (_paramCache[r].motorId == motorId) {
+            return &_paramCache[r];
+        }
+        if (freeRow == nullptr && _paramCache[r].motorId == 0) {
+            freeRow = &_paramCache[r];
+        }
+    }
+    if (create && freeRow) {
+        memset(freeRow, 0, sizeof(*freeRow));
+        freeRow->motorId = motorId;
+        return freeRow;
+    }
+    return nullptr;
+}
+
+const MotorManager::ParamCacheEntry* MotorManager::findCachedParam(uint8_t motorId, uint16_t paramIndex) {
+    ParamCacheRow* row = findCacheRow(motorId, false);
+    if (row == nullptr) {
+        return nullptr;
+    }
+    for (int s = 0; s < PARAM_CACHE_SLOTS; s++) {
+        if (row->entries[s].paramIndex == paramIndex) {
+            return &row->entries[s];
+        }
+    }
+    return nullptr;
+}
+
+void MotorManager::storeCachedParam(uint8_t motorId, uint16_t paramIndex, float value) {
+    ParamCacheRow* row = findCacheRow(motorId, true);
+    if (row == nullptr) {
+        return;
+    }
+    int freeSlot = -1;
+    for (int s = 0; s < PARAM_CACHE_SLOTS; s++) {
+        if (row->entries[s].paramIndex == paramIndex) {
+            row->entries[s].value = value;
+            return;
+        }
+        if (freeSlot < 0 && row->entries[s].paramIndex == 0) {
+            freeSlot = s;
+        }
+    }
+    // Cache full: evict round-robin. Slots fill in order, so the victim is
+    // always the entry inserted longest ago.
+    if (freeSlot < 0) {
+        freeSlot = row->nextEvict;
+        row->nextEvict = (uint8_t)((row->nextEvict + 1) % PARAM_CACHE_SLOTS);
+    }
+    row->entries[freeSlot].paramIndex = paramIndex;
+    row->entries[freeSlot].value = value;
+}
+
+// =============================================================================
+// MIT Motion Control
+// =============================================================================
+
+bool MotorManager::sendMotionControl(uint8_t motorId, float position, float velocity,
+                                     float kp, float kd, float torque) {
+    MotionCommand cmd = { motorId, position, velocity, kp, kd, torque };
+    return sendMotionBatch(&cmd, 1);
+}
+
+bool MotorManager::sendMotionBatch(const MotionCommand* cmds, int count) {
+    if (!_running || cmds == nullptr || count <= 0) {
+        return false;
+    }
+    if (count > MAX_MOTORS) {
+        count = MAX_MOTORS;
+    }
+
+    twai_message_t frames[MAX_MOTORS];
+    for (int i = 0; i < count; i++) {
+        buildMotionFrame(frames[i], cmds[i]);
+    }
+
+    if (!txRingPush(frames, count)) {
+        LOG_DEBUG(TAG, "Motion batch dropped (%d frames, TX ring full)", count);
+        return false;
+    }
+    return true;
+}
+
+bool MotorManager::setRunMode(uint8_t motorId, uint8_t mode, bool enable) {
+    if (!_running) {
+        return false;
+    }
+
+    bool motion = (mode == RobstrideMode::OPERATION_CONTROL);
+
+    twai_message_t frames[3];
+    uint8_t data[8] = {0};
+    buildFrame(frames[0], buildExtendedId(RobstrideComm::MOTOR_STOP, motorId), data, 8);
+
+    // RUN_MODE is a uint8 param: index in data[0-1], value in data[4]
+    data[0] = RobstrideParam::RUN_MODE & 0xFF;
+    data[1] = (RobstrideParam::RUN_MODE >> 8) & 0xFF;
+    data[4] = mode;
+    buildFrame(frames[1], buildExtendedId(RobstrideComm::SET_SINGLE_PARAM, motorId), data, 8);
+
+    memset(data, 0, sizeof(data));
+    buildFrame(frames[2], buildExtendedId(RobstrideComm::MOTOR_ENABLE, motorId), data, 8);
+    int frameCount = enable ? 3 : 2;
+
+    // Entering MIT: stop pinging before the enable can land.
+    if (motion) {
+        setMotionModeFlag(motorId, true);
+    }
+
+    if (!txRingPush(frames, frameCount)) {
+        if (motion) {
+            setMotionModeFlag(motorId, false);
+        }
+        LOG_WARN(TAG, "Run mode switch for motor %d deferred (TX ring full)", motorId);
+        return false;
+    }
+
+    if (!motion) {
+        setMotionModeFlag(motorId, false);
+    }
+
+    // The stop resets the motor's setpoints -- resend everything afterwards
+    invalidateParamCache(motorId);
+
+    LOG_INFO(TAG, "Motor %d run mode -> %d%s", motorId, mode, enable ? "" : " (left stopped)");
+    return true;
+}
+
+void MotorManager::setMotionModeFlag(uint8_t motorId, bool motion) {
+    uint32_t bit = 1u << (motorId & 0x1F);
+    std::atomic<uint32_t>& word = _motionModeMask[(motorId >> 5) & 0x03];
+    if (motion) {
+        word.fetch_or(bit, std::memory_order_release);
+    } else {
+        word.fetch_and(~bit, std::memory_order_release);
+    }
+}
+
+bool MotorManager::isMotionMode(uint8_t motorId) const {
+    uint32_t bit = 1u << (motorId & 0x1F);
+    return (_motionModeMask[(motorId >> 5) & 0x03].load(std::memory_order_acquire) & bit) != 0;
+}
+
+void MotorManager::buildMotionFrame(twai_message_t& msg, const MotionCommand& cmd) {
+    const RobstrideMotorSpec& spec = ROBSTRIDE_DEFAULT_SPEC;
+
+    // Data bytes: big-endian uint16 pairs, same layout as MOTOR_FEEDBACK
+    uint16_t posU16 = floatToUint(cmd.position, -spec.positionLimit, spec.positionLimit, 16);
+    uint16_t velU16 = floatToUint(cmd.velocity, -spec.velocityLimit, spec.velocityLimit, 16);
+    uint16_t kpU16  = floatToUint(cmd.kp, 0.0f, spec.kpMax, 16);
+    uint16_t kdU16  = floatToUint(cmd.kd, 0.0f, spec.kdMax, 16);
+    uint16_t torU16 = floatToUint(cmd.torque, -spec.torqueLimit, spec.torqueLimit, 16);
+
+    uint8_t data[8];
+    data[0] = posU16 >> 8;
+    data[1] = posU16 & 0xFF;
+    data[2] = velU16 >> 8;
+    data[3] = velU16 & 0xFF;
+    data[4] = kpU16 >> 8;
+    data[5] = kpU16 & 0xFF;
+    data[6] = kdU16 >> 8;
+    data[7] = kdU16 & 0xFF;
+
+    // Feed-forward torque rides in CAN ID bits 8-23
+    buildFrame(msg, buildExtendedId(RobstrideComm::MOTION_CONTROL, cmd.motorId, torU16), data, 8);
+}
+
 // =============================================================================
 // TWAI Initialization
 // =============================================================================
@@ -323,9 +676,14 @@ bool MotorManager::initTwai() {
     generalConfig.rx_io = (gpio_num_t)PIN_CAN_RX;
     generalConfig.clkout_io = TWAI_IO_UNUSED;
     generalConfig.bus_off_io = TWAI_IO_UNUSED;
-    generalConfig.tx_queue_len = 16;
-    generalConfig.rx_queue_len = 32;
-    generalConfig.alerts_enabled = TWAI_ALERT_NONE;
+    generalConfig.tx_queue_len = CAN_TX_QUEUE_LEN;
+    generalConfig.rx_queue_len = CAN_RX_QUEUE_LEN;
+    // Alerts drive the CAN task (relayed by canAlertTaskFunc): it wakes when
+    // a frame arrives, a TX slot frees up, or the bus state changes.
+    generalConfig.alerts_enabled = TWAI_ALERT_RX_DATA | TWAI_ALERT_TX_SUCCESS |
+                                   TWAI_ALERT_TX_FAILED | TWAI_ALERT_TX_IDLE |
+                                   TWAI_ALERT_RX_QUEUE_FULL | TWAI_ALERT_ERR_PASS |
+                                   TWAI_ALERT_BUS_OFF | TWAI_ALERT_BUS_RECOVERED;
     generalConfig.clkout_divider = 0;
     generalConfig.intr_flags = 0;
 
@@ -360,106 +718,73 @@ bool MotorManager::initTwai() {
 // Motor Discovery
 // =============================================================================
 
-void MotorManager::scanMotors() {
-    if (!_running) {
-        return;
-    }
-
-    // Drain any pending messages first
-    twai_message_t drainMsg;
-    while (twai_receive(&drainMsg, 0) == ESP_OK) {
-        // discard
-    }
+void MotorManager::startScan() {
+    _scanPhase = SCAN_KNOWN;
+    _scanNextId = 1;
+    _scanPhaseMs = millis();
+    _scanning.store(true, std::memory_order_release);
+}
 
+bool MotorManager::sendProbe(uint8_t motorId) {
     uint8_t data[8] = {0};
+    return sendMessage(buildExtendedId(RobstrideComm::GET_ID, motorId), data, 8);
+}
 
-    // 1) Send broadcast GET_ID to address 0x7F
-    LOG_INFO(TAG, "Sending broadcast GET_ID...");
-    uint32_t broadcastId = buildExtendedId(RobstrideComm::GET_ID, 0x7F);
-    sendMessage(broadcastId, data, 8);
-    delay(20);
-
-    // 2) Send individual GET_ID probes in batches (1-127)
-    //    Batching avoids TX queue overflow.
-    LOG_INFO(TAG, "Probing motor IDs 1-127...");
-    for (int batch = 0; batch < 4; batch++) {
-        int startId = batch * 32 + 1;
-        int endId = (batch + 1) * 32;
-        if (endId > 127) {
-            endId = 127;
-        }
-
-        for (int i = startId; i <= endId; i++) {
-            // Skip our own master ID
-            if ((uint8_t)i == _masterId) {
-                continue;
-            }
+void MotorManager::stepScan() {
+    switch (_scanPhase) {
+        case SCAN_IDLE:
+            return;
 
-            uint32_t probeId = buildExtendedId(RobstrideComm::GET_ID, (uint8_t)i);
-            if (!sendMessage(probeId, data, 8)) {
-                // TX queue probably full, wait and drain
-                delay(10);
-                twai_message_t rxMsg;
-                while (twai_receive(&rxMsg, 0) == ESP_OK) {
-                    if (rxMsg.extd) {
-                        processMessage(rxMsg.identifier, rxMsg.data, rxMsg.data_length_code);
-                    }
-                }
-                // Retry
-                sendMessage(probeId, data, 8);
+        case SCAN_KNOWN:
+            // The arms we already know about go first so they answer (and
+            // get armed for reporting) within a few milliseconds of boot.
+            if (_leftMotorId > 0) {
+                sendProbe(_leftMotorId);
             }
+            if (_rightMotorId > 0 && _rightMotorId != _leftMotorId) {
+                sendProbe(_rightMotorId);
+            }
+            // Broadcast GET_ID to address 0x7F
+            sendProbe(0x7F);
+            LOG_INFO(TAG, "Discovery: probed saved IDs (L=%d R=%d), sweeping 1-127...",
+                     _leftMotorId, _rightMotorId);
+            _scanPhase = SCAN_SWEEP;
+            break;
 
-            // Drain RX every 8 probes to keep up
-            if (i % 8 == 0) {
-                delay(2);
-                twai_message_t rxMsg;
-                while (twai_receive(&rxMsg, 0) == ESP_OK) {
-                    if (rxMsg.extd) {
-                        processMessage(rxMsg.identifier, rxMsg.data, rxMsg.data_length_code);
+        case SCAN_SWEEP: {
+            // Only take a slice of the TX ring so commands can still get out
+            int budget = CAN_SCAN_PROBES_PER_PASS;
+            while (budget > 0 && _scanNextId <= 127 && txRingFree() > TX_RING_LEN / 2) {
+                uint8_t id = _scanNextId;
+                if (id != _masterId && id != _leftMotorId && id != _rightMotorId) {
+                    if (!sendProbe(id)) {
+                        break;  // Retry this ID next pass
                     }
+                    budget--;
                 }
+                _scanNextId++;
             }
-        }
-
-        // Drain between batches
-        delay(20);
-        twai_message_t rxMsg;
-        while (twai_receive(&rxMsg, 0) == ESP_OK) {
-            if (rxMsg.extd) {
-                processMessage(rxMsg.identifier, rxMsg.data, rxMsg.data_length_code);
+            if (_scanNextId > 127) {
+                _scanPhase = SCAN_SETTLE;
+                _scanPhaseMs = millis();
             }
+            break;
         }
-    }
 
-    // 3) Wait for remaining responses
-    LOG_INFO(TAG, "Waiting for scan responses...");
-    unsigned long scanStart = millis();
-    while (millis() - scanStart < CAN_SCAN_TIMEOUT_MS) {
-        twai_message_t rxMsg;
-        esp_err_t result = twai_receive(&rxMsg, pdMS_TO_TICKS(10));
-        if (result == ESP_OK && rxMsg.extd) {
-            uint32_t canId = rxMsg.identifier;
-            uint8_t commType = (canId >> 24) & 0x1F;
-            uint8_t motorId = (canId >> 8) & 0xFF;
-
-            // Accept GET_ID or MOTOR_FEEDBACK responses as discovery
-            if (commType == RobstrideComm::GET_ID || commType == RobstrideComm::MOTOR_FEEDBACK) {
-                if (motorId != _masterId && motorId > 0 && motorId <= 127) {
-                    int idx = addMotor(motorId);
-                    if (idx >= 0) {
-                        LOG_INFO(TAG, "Discovered motor ID: %d", motorId);
-                    }
-                }
+        case SCAN_SETTLE:
+            if (millis() - _scanPhaseMs < CAN_SCAN_TIMEOUT_MS) {
+                break;
             }
-
-            // Also process feedback if present
-            processMessage(canId, rxMsg.data, rxMsg.data_length_code);
-        }
-    }
-
-    LOG_INFO(TAG, "Scan complete. Found %d motor(s):", _motorCount);
-    for (int i = 0; i < _motorCount; i++) {
-        LOG_INFO(TAG, "  Motor[%d]: CAN ID = %d", i, _motorIds[i]);
+            LOG_INFO(TAG, "Scan complete. Found %d motor(s):", _motorCount);
+            for (int i = 0; i < _motorCount; i++) {
+                LOG_INFO(TAG, "  Motor[%d]: CAN ID = %d", i, _motorIds[i]);
+            }
+            if (_motorCount == 0) {
+                LOG_WARN(TAG, "No motors found on CAN bus. Check wiring and power.");
+            }
+            _scanPhase = SCAN_IDLE;
+            _scanning.store(false, std::memory_order_release);
+            break;
     }
 }
 
@@ -490,9 +815,12 @@ int MotorManager::addMotor(uint8_t motorId) {
     }
 
     int idx = _motorCount;
+    LOG_INFO(TAG, "Discovered motor ID: %d", motorId);
     _motorIds[idx] = motorId;
     memset(&_motorStatus[idx], 0, sizeof(RobstrideMotorStatus));
     _motorStatus[idx].lastUpdateMs = millis();  // Mark discovery time for staleness tracking
+    _lastReportArmMs[idx] = 0;                  // Arm active reporting on the next pass
+    memset(&_history[idx], 0, sizeof(_history[idx]));
     _motorCount++;
     return idx;
 }
@@ -513,6 +841,16 @@ uint32_t MotorManager::buildExtendedId(uint8_t commType, uint8_t motorId, uint16
 
 bool MotorManager::sendMessage(uint32_t id, const uint8_t* data, uint8_t len) {
     twai_message_t msg;
+    buildFrame(msg, id, data, len);
+
+    if (!txRingPush(&msg, 1)) {
+        LOG_DEBUG(TAG, "CAN TX ring full (ID: 0x%08X)", id);
+        return false;
+    }
+    return true;
+}
+
+void MotorManager::buildFrame(twai_message_t& msg, uint32_t id, const uint8_t* data, uint8_t len) {
     memset(&msg, 0, sizeof(msg));
     msg.identifier = id;
     msg.extd = 1;
@@ -521,26 +859,206 @@ bool MotorManager::sendMessage(uint32_t id, const uint8_t* data, uint8_t len) {
     if (data && len > 0) {
         memcpy(msg.data, data, len);
     }
+}
 
-    esp_err_t result = twai_transmit(&msg, pdMS_TO_TICKS(50));
-    if (result != ESP_OK) {
-        LOG_DEBUG(TAG, "CAN TX failed (ID: 0x%08X, err: %s)", id, esp_err_to_name(result));
-        return false;
+// =============================================================================
+// TX Ring
+// =============================================================================
+// Any context may push (main loop, balance/drive tasks, web handlers, the
+// CAN task itself). A push only notifies the CAN task; frames leave the ring
+// in order through flushTx() on that task alone, which hands them to the
+// TWAI driver with a zero timeout and resumes on the next TX_SUCCESS alert
+// when the driver queue is full.
+
+int MotorManager::txRingFree() {
+    portENTER_CRITICAL(&_txMux);
+    int used = (int)(_txHead - _txTail);
+    portEXIT_CRITICAL(&_txMux);
+    return TX_RING_LEN - used;
+}
+
+bool MotorManager::txRingPush(const twai_message_t* msgs, int count) {
+    bool ok = false;
+    portENTER_CRITICAL(&_txMux);
+    if ((int)(_txHead - _txTail) + count <= TX_RING_LEN) {
+        for (int i = 0; i < count; i++) {
+            _txRing[_txHead % TX_RING_LEN] = msgs[i];
+            _txHead++;
+        }
+        ok = true;
+    }
+    portEXIT_CRITICAL(&_txMux);
+
+    // The CAN task flushes at the end of every pass anyway
+    if (ok && _canTask != nullptr && xTaskGetCurrentTaskHandle() != _canTask) {
+        xTaskNotifyGive(_canTask);
+    }
+    return ok;
+}
+
+void MotorManager::flushTx() {
+    for (;;) {
+        twai_message_t msg;
+        bool have = false;
+        portENTER_CRITICAL(&_txMux);
+        if (_txTail != _txHead) {
+            msg = _txRing[_txTail % TX_RING_LEN];
+            have = true;
+        }
+        portEXIT_CRITICAL(&_txMux);
+        if (!have) {
+            return;
+        }
+
+        esp_err_t result = twai_transmit(&msg, 0);
+        if (result == ESP_ERR_TIMEOUT) {
+            return;  // Driver queue full -- TX_SUCCESS alert will resume us
+        }
+        if (result == ESP_OK) {
+            // Start the RTT clock for frames the motor answers with
+            // feedback. Keep the oldest outstanding stamp.
+            uint8_t commType = (msg.identifier >> 24) & 0x1F;
+            if (commType == RobstrideComm::MOTION_CONTROL ||
+                commType == RobstrideComm::MOTOR_ENABLE ||
+                commType == RobstrideComm::MOTOR_STOP) {
+                uint32_t expected = 0;
+                uint32_t sentUs = (uint32_t)esp_timer_get_time() | 1;
+                _cmdSentUs[msg.identifier & 0x7F].compare_exchange_strong(
+                    expected, sentUs, std::memory_order_relaxed);
+            }
+        } else {
+            // Bus off / stopped: drop the frame rather than wedge the ring
+            LOG_DEBUG(TAG, "CAN TX failed (ID: 0x%08X, err: %s)",
+                      msg.identifier, esp_err_to_name(result));
+        }
+
+        portENTER_CRITICAL(&_txMux);
+        _txTail++;
+        portEXIT_CRITICAL(&_txMux);
+    }
+}
+
+// =============================================================================
+// CAN Task
+// =============================================================================
+
+void MotorManager::drainRx(int maxFrames) {
+    twai_message_t msg;
+    int count = 0;
+    while (count < maxFrames && twai_receive(&msg, 0) == ESP_OK) {
+        // Stamp at dequeue, before any parsing, so the time reflects arrival
+        uint32_t rxUs = (uint32_t)esp_timer_get_time();
+        if (msg.extd) {
+            processMessage(msg.identifier, msg.data, msg.data_length_code, rxUs);
+        }
+        count++;
+    }
+}
+
+void MotorManager::publishSnapshot() {
+    MotorTable* table = _published.beginWrite();
+    table->count = _motorCount;
+    memcpy(table->ids, _motorIds, sizeof(_motorIds));
+    memcpy(table->status, _motorStatus, sizeof(_motorStatus));
+    _published.endWrite();
+}
+
+void MotorManager::canTaskFunc(void* param) {
+    MotorManager* self = static_cast<MotorManager*>(param);
+
+    LOG_INFO(TAG, "CAN task running on core %d", xPortGetCoreID());
+
+    for (;;) {
+        // Sleep until a frame is queued or the relay forwards a TWAI alert.
+        // The timeout bounds how late the periodic work (pings, staleness,
+        // VBUS) can run.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CAN_TASK_IDLE_MS));
+        uint32_t alerts = self->_pendingAlerts.exchange(0, std::memory_order_acquire);
+
+        if (alerts & TWAI_ALERT_BUS_OFF) {
+            LOG_WARN(TAG, "CAN bus-off -- initiating recovery");
+            twai_initiate_recovery();
+        }
+        if (alerts & TWAI_ALERT_BUS_RECOVERED) {
+            LOG_INFO(TAG, "CAN bus recovered -- restarting driver");
+            twai_start();
+        }
+        if (alerts & TWAI_ALERT_ERR_PASS) {
+            LOG_WARN(TAG, "CAN controller error-passive");
+        }
+        if (alerts & TWAI_ALERT_RX_QUEUE_FULL) {
+            LOG_DEBUG(TAG, "CAN RX queue full");
+        }
+
+        // Queued commands first, then always drain: RX_DATA only fires
+        // once per batch of frames
+        self->flushTx();
+        self->drainRx(CAN_RX_QUEUE_LEN);
+
+        if (self->_rescanRequested.exchange(false, std::memory_order_acquire)) {
+            LOG_INFO(TAG, "Re-scanning CAN bus for motors...");
+            self->_motorCount = 0;
+            memset(self->_motorIds, 0, sizeof(self->_motorIds));
+            memset(self->_motorStatus, 0, sizeof(self->_motorStatus));
+            self->startScan();
+        }
+
+        // Advance discovery (no-op when idle)
+        self->stepScan();
+
+        // Fail parameter reads that went unanswered
+        self->expireParamReads();
+
+        // Keep every motor actively reporting position/velocity/torque
+        self->maintainReporting();
+
+        // Check for stale or disconnected motors
+        self->checkStaleness();
+
+        // Periodic voltage polling
+        self->pollVoltage();
+
+        // Frames queued by this pass (responses, pings, probes)
+        self->flushTx();
+
+        self->publishSnapshot();
+    }
+}
+
+void MotorManager::canAlertTaskFunc(void* param) {
+    MotorManager* self = static_cast<MotorManager*>(param);
+
+    for (;;) {
+        uint32_t alerts = 0;
+        if (twai_read_alerts(&alerts, portMAX_DELAY) != ESP_OK) {
+            vTaskDelay(1);  // Driver not running
+            continue;
+        }
+        self->_pendingAlerts.fetch_or(alerts, std::memory_order_release);
+        xTaskNotifyGive(self->_canTask);
     }
-    return true;
+}
+
+void MotorManager::packFloatParam(uint8_t* data, uint16_t paramIndex, float value) {
+    memset(data, 0, 8);
+    // data[0-1]: parameter index (little-endian)
+    data[0] = paramIndex & 0xFF;
+    data[1] = (paramIndex >> 8) & 0xFF;
+    // data[4-7]: float value (little-endian IEEE 754)
+    memcpy(&data[4], &value, sizeof(float));
 }
 
 // =============================================================================
 // Message Processing
 // =============================================================================
 
-void MotorManager::processMessage(uint32_t canId, const uint8_t* data, uint8_t len) {
+void MotorManager::processMessage(uint32_t canId, const uint8_t* data, uint8_t len, uint32_t rxUs) {
     uint8_t commType = (canId >> 24) & 0x1F;
     uint8_t motorId = (canId >> 8) & 0xFF;
 
     switch (commType) {
         case RobstrideComm::MOTOR_FEEDBACK:
-            parseMotorFeedback(motorId, canId, data);
+            parseMotorFeedback(motorId, canId, data, rxUs);
             break;
 
         case RobstrideComm::GET_SINGLE_PARAM:
@@ -570,7 +1088,7 @@ void MotorManager::processMessage(uint32_t canId, const uint8_t* data, uint8_t l
     }
 }
 
-void MotorManager::parseMotorFeedback(uint8_t motorId, uint32_t canId, const uint8_t* data) {
+void MotorManager::parseMotorFeedback(uint8_t motorId, uint32_t canId, const uint8_t* data, uint32_t rxUs) {
     int idx = findMotorIndex(motorId);
     if (idx < 0) {
         // Unknown motor -- try to add it
@@ -608,24 +1126,79 @@ void MotorManager::parseMotorFeedback(uint8_t motorId, uint32_t canId, const uin
     status.hasFault = (errorCode != 0);
     status.enabled = (pattern == RobstrideState::RUNNING);
     status.lastUpdateMs = millis();
+
+    recordFeedbackTiming(idx, motorId, rxUs);
+}
+
+void MotorManager::recordFeedbackTiming(int idx, uint8_t motorId, uint32_t rxUs) {
+    RobstrideMotorStatus& status = _motorStatus[idx];
+    FeedbackHistory& hist = _history[idx];
+
+    status.lastRxUs = rxUs;
+
+    // Round trip from the oldest outstanding command. Anything older than
+    // the re-arm interval went unanswered -- drop it rather than report it.
+    uint32_t sentUs = _cmdSentUs[motorId & 0x7F].exchange(0, std::memory_order_relaxed);
+    if (sentUs != 0) {
+        uint32_t rtt = rxUs - sentUs;
+        if (rtt < MOTOR_STATUS_POLL_MS * 1000UL) {
+            status.rttUs = rtt;
+        }
+    }
+
+    hist.rxUs[hist.head] = rxUs;
+    hist.head = (hist.head + 1) % FEEDBACK_HISTORY_LEN;
+    if (hist.count < FEEDBACK_HISTORY_LEN) {
+        hist.count++;
+    }
+    if (hist.count < 3) {
+        return;
+    }
+
+    // Oldest -> newest intervals
+    uint32_t intervals[FEEDBACK_HISTORY_LEN - 1];
+    int n = hist.count - 1;
+    int start = (hist.head + FEEDBACK_HISTORY_LEN - hist.count) % FEEDBACK_HISTORY_LEN;
+    uint64_t sum = 0;
+    for (int k = 0; k < n; k++) {
+        uint32_t a = hist.rxUs[(start + k) % FEEDBACK_HISTORY_LEN];
+        uint32_t b = hist.rxUs[(start + k + 1) % FEEDBACK_HISTORY_LEN];
+        intervals[k] = b - a;
+        sum += intervals[k];
+    }
+    uint32_t mean = (uint32_t)(sum / n);
+
+    uint64_t dev = 0;
+    for (int k = 0; k < n; k++) {
+        dev += (intervals[k] > mean) ? (intervals[k] - mean) : (mean - intervals[k]);
+    }
+    status.intervalUs = mean;
+    status.jitterUs = (uint32_t)(dev / n);
 }
 
 void MotorManager::parseParameterResponse(uint8_t motorId, const uint8_t* data) {
     // Parameter index is in data[0-1] (little-endian)
     uint16_t paramIndex = (uint16_t)data[0] | ((uint16_t)data[1] << 8);
 
-    // Check if this is the parameter we're waiting for
-    if (_paramReadPending && paramIndex == _paramReadIndex && motorId == _paramReadMotorId) {
+    // Check if this is a parameter we're waiting for
+    int slot = findParamRead(motorId, paramIndex);
+    if (slot >= 0) {
+        ParamReadSlot& read = _paramReads[slot];
+
         // Float value in data[4-7] (little-endian IEEE 754)
-        memcpy(&_paramReadValue, &data[4], sizeof(float));
-        _paramReadPending = false;
+        float value;
+        memcpy(&value, &data[4], sizeof(float));
+        if (paramIndex == RobstrideParam::RUN_MODE) {
+            value = (float)data[4];  // uint8 param -- report the numeric value
+        }
+        _paramReadValue = value;
 
         // If this was a VBUS read, store it in the motor status
         if (paramIndex == RobstrideParam::VBUS) {
             int idx = findMotorIndex(motorId);
             if (idx >= 0) {
-                _motorStatus[idx].voltage = _paramReadValue;
-                LOG_DEBUG(TAG, "Motor %d VBUS: %.1fV", motorId, _paramReadValue);
+                _motorStatus[idx].voltage = value;
+                LOG_DEBUG(TAG, "Motor %d VBUS: %.1fV", motorId, value);
             }
         }
 
@@ -641,8 +1214,8 @@ void MotorManager::parseParameterResponse(uint8_t motorId, const uint8_t* data)
         if (paramIndex == RobstrideParam::PP_SPEED) {
             int idx = findMotorIndex(motorId);
             if (idx >= 0) {
-                _motorStatus[idx].ppSpeed = _paramReadValue;
-                LOG_INFO(TAG, "Motor %d PP_SPEED readback: %.2f rad/s", motorId, _paramReadValue);
+                _motorStatus[idx].ppSpeed = value;
+                LOG_INFO(TAG, "Motor %d PP_SPEED readback: %.2f rad/s", motorId, value);
             }
         }
 
@@ -650,8 +1223,8 @@ void MotorManager::parseParameterResponse(uint8_t motorId, const uint8_t* data)
         if (paramIndex == RobstrideParam::PP_ACCELERATION) {
             int idx = findMotorIndex(motorId);
             if (idx >= 0) {
-                _motorStatus[idx].ppAccel = _paramReadValue;
-                LOG_INFO(TAG, "Motor %d PP_ACCEL readback: %.2f rad/s^2", motorId, _paramReadValue);
+                _motorStatus[idx].ppAccel = value;
+                LOG_INFO(TAG, "Motor %d PP_ACCEL readback: %.2f rad/s^2", motorId, value);
             }
         }
 
@@ -659,8 +1232,8 @@ void MotorManager::parseParameterResponse(uint8_t motorId, const uint8_t* data)
         if (paramIndex == RobstrideParam::LIMIT_SPD) {
             int idx = findMotorIndex(motorId);
             if (idx >= 0) {
-                _motorStatus[idx].limitSpd = _paramReadValue;
-                LOG_INFO(TAG, "Motor %d LIMIT_SPD readback: %.2f rad/s", motorId, _paramReadValue);
+                _motorStatus[idx].limitSpd = value;
+                LOG_INFO(TAG, "Motor %d LIMIT_SPD readback: %.2f rad/s", motorId, value);
             }
         }
 
@@ -668,10 +1241,18 @@ void MotorManager::parseParameterResponse(uint8_t motorId, const uint8_t* data)
         if (paramIndex == RobstrideParam::LIMIT_CUR) {
             int idx = findMotorIndex(motorId);
             if (idx >= 0) {
-                _motorStatus[idx].limitCur = _paramReadValue;
-                LOG_INFO(TAG, "Motor %d LIMIT_CUR readback: %.2f A", motorId, _paramReadValue);
+                _motorStatus[idx].limitCur = value;
+                LOG_INFO(TAG, "Motor %d LIMIT_CUR readback: %.2f A", motorId, value);
             }
         }
+
+        ParamReadCallback callback = read.callback;
+        void* ctx = read.ctx;
+        uint32_t tag = read.tag;
+        read.state.store(PARAM_READ_IDLE, std::memory_order_release);
+        if (callback) {
+            callback(motorId, paramIndex, true, value, ctx, tag);
+        }
     }
 }
 
@@ -679,63 +1260,167 @@ void MotorManager::parseParameterResponse(uint8_t motorId, const uint8_t* data)
 // Parameter Reading
 // =============================================================================
 
-bool MotorManager::requestParameter(uint8_t motorId, uint16_t paramIndex) {
-    if (_paramReadPending) {
-        return false;  // Already waiting for a response
+bool MotorManager::requestParameter(uint8_t motorId, uint16_t paramIndex,
+                                    ParamReadCallback callback, void* ctx, uint32_t tag) {
+    // One read per (motor, param) at a time -- the response can't be told apart
+    if (findParamRead(motorId, paramIndex) >= 0) {
+        return false;
+    }
+
+    // Claim a free slot
+    int slot = -1;
+    for (int i = 0; i < PARAM_READ_SLOTS; i++) {
+        uint8_t expected = PARAM_READ_IDLE;
+        if (_paramReads[i].state.compare_exchange_strong(expected, PARAM_READ_CLAIMED,
+                                                         std::memory_order_acquire)) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) {
+        LOG_DEBUG(TAG, "Param read table full (motor %d, param 0x%04X)", motorId, paramIndex);
+        return false;
     }
 
+    ParamReadSlot& read = _paramReads[slot];
+    read.motorId = motorId;
+    read.paramIndex = paramIndex;
+    read.startMs = millis();
+    read.callback = callback;
+    read.ctx = ctx;
+    read.tag = tag;
+
     uint8_t data[8] = {0};
     data[0] = paramIndex & 0xFF;
     data[1] = (paramIndex >> 8) & 0xFF;
 
     uint32_t id = buildExtendedId(RobstrideComm::GET_SINGLE_PARAM, motorId);
-    if (!sendMessage(id, data, 8)) {
+    twai_message_t msg;
+    buildFrame(msg, id, data, 8);
+
+    // Arm before queueing so the response can't beat us to the match
+    read.state.store(PARAM_READ_IN_FLIGHT, std::memory_order_release);
+    if (!txRingPush(&msg, 1)) {
+        read.state.store(PARAM_READ_IDLE, std::memory_order_release);
         return false;
     }
-
-    _paramReadPending = true;
-    _paramReadIndex = paramIndex;
-    _paramReadMotorId = motorId;
-    _paramReadValue = 0;
-    _paramReadStartMs = millis();
     return true;
 }
 
+int MotorManager::findParamRead(uint8_t motorId, uint16_t paramIndex) const {
+    for (int i = 0; i < PARAM_READ_SLOTS; i++) {
+        const ParamReadSlot& read = _paramReads[i];
+        if (read.state.load(std::memory_order_acquire) == PARAM_READ_IN_FLIGHT &&
+            read.motorId == motorId && read.paramIndex == paramIndex) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void MotorManager::expireParamReads() {
+    unsigned long now = millis();
+    for (int i = 0; i < PARAM_READ_SLOTS; i++) {
+        ParamReadSlot& read = _paramReads[i];
+        if (read.state.load(std::memory_order_acquire) != PARAM_READ_IN_FLIGHT) {
+            continue;
+        }
+        if (now - read.startMs <= MOTOR_PARAM_READ_TIMEOUT_MS) {
+            continue;
+        }
+        LOG_DEBUG(TAG, "Parameter read timeout for motor %d, param 0x%04X",
+                  read.motorId, read.paramIndex);
+        uint8_t motorId = read.motorId;
+        uint16_t paramIndex = read.paramIndex;
+        ParamReadCallback callback = read.callback;
+        void* ctx = read.ctx;
+        uint32_t tag = read.tag;
+        read.state.store(PARAM_READ_IDLE, std::memory_order_release);
+        if (callback) {
+            callback(motorId, paramIndex, false, 0.0f, ctx, tag);
+        }
+    }
+}
+
 // =============================================================================
-// Periodic Status Polling
+// Active Reporting
 // =============================================================================
 
-void MotorManager::pollStatus() {
-    if (_motorCount == 0) {
-        return;
+bool MotorManager::setReportPeriod(uint8_t motorId, uint16_t periodMs) {
+    if (motorId == 0 || motorId > 127) {
+        return false;
     }
-
-    unsigned long now = millis();
-    if (now - _lastStatusPollMs < MOTOR_STATUS_POLL_MS) {
-        return;
+    if (periodMs < RobstrideReport::MIN_PERIOD_MS) {
+        periodMs = RobstrideReport::MIN_PERIOD_MS;
     }
-    _lastStatusPollMs = now;
+    _reportPeriodMs[motorId].store(periodMs, std::memory_order_relaxed);
+    return _running && armReporting(motorId);
+}
 
-    // Round-robin: ping one motor per interval
-    if (_statusPollMotorIndex >= _motorCount) {
-        _statusPollMotorIndex = 0;
+bool MotorManager::armReporting(uint8_t motorId) {
+    uint16_t periodMs = _reportPeriodMs[motorId & 0x7F].load(std::memory_order_relaxed);
+    if (periodMs == 0) {
+        periodMs = MOTOR_REPORT_PERIOD_MS;
     }
+    if (periodMs < RobstrideReport::MIN_PERIOD_MS) {
+        periodMs = RobstrideReport::MIN_PERIOD_MS;
+    }
+    uint16_t steps = 1 + (periodMs - RobstrideReport::MIN_PERIOD_MS) / RobstrideReport::PERIOD_STEP_MS;
 
-    uint8_t motorId = _motorIds[_statusPollMotorIndex];
-    _statusPollMotorIndex++;
+    twai_message_t frames[2];
 
-    // Send a zero-torque MOTION_CONTROL frame (type 0x01).
-    // This is the standard way to request status from Robstride motors
-    // (same as sirwart/robstride Python SDK's get_motor_status).
-    // The motor responds with MOTOR_FEEDBACK (type 0x02) containing
-    // live position, velocity, torque, and temperature.
-    // Data bytes are all zero (zero position, zero velocity, zero kp, zero kd).
-    // Torque is encoded in the CAN ID extra bits, also zero.
+    // EPSCAN_TIME is a uint16 param: index in data[0-1], value LE in data[4-5]
     uint8_t data[8] = {0};
-    // buildExtendedId for MOTION_CONTROL puts extraData (torque uint16) in bits 8-23
-    // With extraData=0, this is a zero-torque, zero-everything command.
-    uint32_t id = ((uint32_t)RobstrideComm::MOTION_CONTROL << 24) | ((uint32_t)0x0000 << 8) | motorId;
-    sendMessage(id, data, 8);
+    data[0] = RobstrideParam::EPSCAN_TIME & 0xFF;
+    data[1] = (RobstrideParam::EPSCAN_TIME >> 8) & 0xFF;
+    data[4] = steps & 0xFF;
+    data[5] = (steps >> 8) & 0xFF;
+    buildFrame(frames[0], buildExtendedId(RobstrideComm::SET_SINGLE_PARAM, motorId), data, 8);
+
+    const uint8_t enable[8] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x01, 0x00};
+    buildFrame(frames[1], buildExtendedId(RobstrideComm::PROACTIVE_REPORT_SET, motorId), enable, 8);
+
+    if (!txRingPush(frames, 2)) {
+        return false;
+    }
+    LOG_DEBUG(TAG, "Motor %d active reporting armed (%u ms)", motorId, periodMs);
+    return true;
+}
+
+void MotorManager::maintainReporting() {
+    unsigned long now = millis();
+
+    for (int i = 0; i < _motorCount; i++) {
+        uint8_t motorId = _motorIds[i];
+        bool neverArmed = (_lastReportArmMs[i] == 0);
+        bool quiet = (now - _motorStatus[i].lastUpdateMs >= MOTOR_STATUS_POLL_MS);
+
+        if (!neverArmed && (!quiet || now - _lastReportArmMs[i] < MOTOR_STATUS_POLL_MS)) {
+            continue;
+        }
+
+        // New motor, or one that stopped reporting (power cycle loses the
+        // setting). Re-arm, and ping so we hear back even if it can't report.
+        if (!armReporting(motorId)) {
+            continue;  // TX ring full -- try again next pass
+        }
+        _lastReportArmMs[i] = now;
+
+        // Motors under MIT control already report back on every setpoint, and
+        // a zero-gain ping would momentarily release them.
+        if (isMotionMode(motorId)) {
+            continue;
+        }
+
+        // Send a zero-torque MOTION_CONTROL frame (type 0x01).
+        // This is the standard way to request status from Robstride motors
+        // (same as sirwart/robstride Python SDK's get_motor_status).
+        // The motor responds with MOTOR_FEEDBACK (type 0x02) containing
+        // live position, velocity, torque, and temperature.
+        uint8_t data[8] = {0};
+        uint32_t id = buildExtendedId(RobstrideComm::MOTION_CONTROL, motorId, 0x0000);
+        sendMessage(id, data, 8);
+    }
 }
 
 // =============================================================================
@@ -791,6 +1476,8 @@ void MotorManager::removeMotor(int index) {
     for (int i = index; i < _motorCount - 1; i++) {
         _motorIds[i] = _motorIds[i + 1];
         _motorStatus[i] = _motorStatus[i + 1];
+        _lastReportArmMs[i] = _lastReportArmMs[i + 1];
+        _history[i] = _history[i + 1];
     }
     _motorCount--;
 
@@ -798,10 +1485,7 @@ void MotorManager::removeMotor(int index) {
     _motorIds[_motorCount] = 0;
     memset(&_motorStatus[_motorCount], 0, sizeof(RobstrideMotorStatus));
 
-    // Fix round-robin indices if they pointed past the removed entry
-    if (_statusPollMotorIndex > _motorCount) {
-        _statusPollMotorIndex = 0;
-    }
+    // Fix round-robin index if it pointed past the removed entry
     if (_vbusPollMotorIndex > _motorCount) {
         _vbusPollMotorIndex = 0;
     }
@@ -821,11 +1505,6 @@ void MotorManager::pollVoltage() {
         return;
     }
 
-    // Don't start a new read if one is pending
-    if (_paramReadPending) {
-        return;
-    }
-
     _lastVbusPollMs = now;
 
     // Round-robin through motors
@@ -842,12 +1521,25 @@ void MotorManager::pollVoltage() {
 // Public Parameter Read API
 // =============================================================================
 
-bool MotorManager::requestParamRead(uint8_t motorId, uint16_t paramIndex) {
-    return requestParameter(motorId, paramIndex);
+bool MotorManager::requestParamRead(uint8_t motorId, uint16_t paramIndex,
+                                    ParamReadCallback callback, void* ctx, uint32_t tag) {
+    if (!_running) {
+        return false;
+    }
+    return requestParameter(motorId, paramIndex, callback, ctx, tag);
 }
 
 bool MotorManager::isParamReadPending() const {
-    return _paramReadPending;
+    for (int i = 0; i < PARAM_READ_SLOTS; i++) {
+        if (_paramReads[i].state.load(std::memory_order_acquire) != PARAM_READ_IDLE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MotorManager::isParamReadPending(uint8_t motorId, uint16_t paramIndex) const {
+    return findParamRead(motorId, paramIndex) >= 0;
 }
 
 float MotorManager::getLastParamReadValue() const {
@@ -4,19 +4,41 @@
 // Motor Manager Module
 // =============================================================================
 // Manages Robstride motors over CAN bus via ESP32 TWAI peripheral.
-// Handles motor discovery, status polling, and feedback parsing.
+// Handles motor discovery, active status reporting, and feedback parsing.
 //
 // The TJA1051T/3 transceiver on the Mini CAN Unit converts TWAI signals
 // to/from the physical CAN bus. The ESP32 handles the CAN protocol.
 //
+// All bus I/O runs on a dedicated FreeRTOS task pinned to CAN_TASK_CORE.
+// The task sleeps on its task notification, dispatches RX frames as they
+// arrive and owns the motor table. After every wakeup it publishes the table
+// through a SeqLock (seqlock.h); poll() copies the latest consistent
+// snapshot for the caller, so feedback latency no longer depends on how
+// long loop() takes.
+//
+// Commands never block: frames go into a TX ring and the caller notifies
+// the CAN task, the only context that calls twai_transmit(). A caller that
+// is preempted can't hold up anyone else's frames.
+//
+// twai_read_alerts() can't wait on a notification too, so a small relay
+// task blocks in it and forwards the alerts (RX data, TX done, bus state)
+// as a notification to the CAN task.
+//
+// Discovery is a non-blocking state machine on the same task: the NVS-saved
+// left/right IDs are probed first, then the rest of the ID space is swept a
+// few probes per wakeup. Motors become usable as soon as they answer.
+//
 // Usage:
 //   MotorManager motors;
-//   motors.begin();          // Call once in setup() -- inits TWAI, scans bus
-//   motors.poll();           // Call every loop iteration -- processes CAN RX
+//   motors.begin();          // Call once in setup() -- inits TWAI, starts task + discovery
+//   motors.poll();           // Call every loop iteration -- refreshes status snapshot
 // =============================================================================
 
 #include <Arduino.h>
+#include <atomic>
+#include <driver/twai.h>
 #include "robstride_protocol.h"
+#include "seqlock.h"
 
 class MotorManager {
 public:
@@ -24,13 +46,17 @@ public:
     // Must be called after config pins are available.
     void begin();
 
-    // Process incoming CAN messages. Call every loop iteration.
-    // Non-blocking -- returns immediately if no messages pending.
+    // Refresh the caller-side status snapshot from the CAN task.
+    // Call every loop iteration. Non-blocking (copies ~0.5KB).
     void poll();
 
     // Re-scan the bus for motors (can be called anytime).
+    // The scan itself runs on the CAN task.
     void rescan();
 
+    // Is a discovery sweep still in progress?
+    bool isScanning() const;
+
     // ---- Status Accessors ----
 
     // Number of discovered motors (0 if none found or CAN not running).
@@ -46,6 +72,40 @@ public:
     // Is the TWAI driver running?
     bool isRunning() const;
 
+    // ---- Feedback Timing ----
+    // Each status carries lastRxUs / intervalUs / jitterUs / rttUs (see
+    // RobstrideMotorStatus). rttUs measures from the moment a frame the motor
+    // answers with feedback (MIT setpoint, enable, stop) is handed to the
+    // driver to the next feedback frame from that motor -- with active
+    // reporting on, that can be a periodic report, so treat it as an upper
+    // bound on the transport delay rather than an exact figure.
+
+    // Age of the motor's latest feedback in microseconds.
+    uint32_t getFeedbackAgeUs(int index) const;
+
+    // Position extrapolated from the latest feedback to now using the
+    // reported velocity. Age is capped at MOTOR_EXTRAPOLATE_MAX_US so a
+    // stale motor doesn't run away.
+    float getExtrapolatedPosition(int index) const;
+
+    // Latest published feedback for a motor CAN ID, read straight from the
+    // CAN task's snapshot. Unlike the accessors above (which read the copy
+    // refreshed by poll()), this is safe from any task. Returns false if
+    // the motor isn't on the bus.
+    bool readFeedback(uint8_t motorId, RobstrideMotorStatus* out) const;
+
+    // Whole motor table as last published by the CAN task
+    static const int MAX_MOTORS = 8;
+    struct MotorTable {
+        int count;
+        uint8_t ids[MAX_MOTORS];
+        RobstrideMotorStatus status[MAX_MOTORS];
+    };
+
+    // Coherent copy of the latest published table. Safe from any task --
+    // use it instead of getMotorStatus() outside loop().
+    void readTable(MotorTable* out) const;
+
     // ---- Motor Role Configuration (persisted to NVS) ----
 
     // Get/set the CAN ID assigned to left motor (0 = unassigned)
@@ -85,28 +145,132 @@ public:
     // Used for RUN_MODE, etc.
     bool writeUint8Param(uint8_t motorId, uint16_t paramIndex, uint8_t value);
 
-    // Request an async parameter read from a motor (GET_SINGLE_PARAM).
-    // Returns false if a read is already pending. Result arrives via CAN
-    // and is stored in motor status (for known params) and _paramReadValue.
-    bool requestParamRead(uint8_t motorId, uint16_t paramIndex);
+    // Called on the CAN task when a param read completes (ok=true) or times
+    // out after MOTOR_PARAM_READ_TIMEOUT_MS (ok=false, value=0). ctx and tag
+    // are passed back as given to requestParamRead(); the tag lets a caller
+    // tell which of its requests an answer belongs to. Keep it short.
+    typedef void (*ParamReadCallback)(uint8_t motorId, uint16_t paramIndex,
+                                      bool ok, float value, void* ctx, uint32_t tag);
 
-    // Check if an async parameter read is still pending.
+    // Request an async parameter read from a motor (GET_SINGLE_PARAM).
+    // Up to PARAM_READ_SLOTS reads can be in flight at once, keyed by
+    // (motor, param). Returns false if that exact read is already in flight,
+    // the table is full or the TX ring is full. Results are stored in motor
+    // status (for known params), in getLastParamReadValue(), and passed to
+    // the optional callback.
+    bool requestParamRead(uint8_t motorId, uint16_t paramIndex,
+                          ParamReadCallback callback = nullptr, void* ctx = nullptr,
+                          uint32_t tag = 0);
+
+    // Check if any async parameter read is still pending.
     bool isParamReadPending() const;
 
+    // Check if a specific (motor, param) read is still pending.
+    bool isParamReadPending(uint8_t motorId, uint16_t paramIndex) const;
+
     // Get the float value from the last completed parameter read.
     float getLastParamReadValue() const;
 
+    // ---- Cached Command Layer ----
+    // Tracks the last value written per (motor, param) so repeated commands
+    // with an unchanged value don't put redundant frames on the bus. The cache
+    // for a motor is cleared whenever it is stopped, zeroed, re-discovered or
+    // drops out of RUNNING, so the next write after a re-init always goes out.
+
+    // One POSITION_PP target for sendPositionBatch().
+    struct PositionCommand {
+        uint8_t motorId;
+        float position;     // LOC_REF in motor space (rad)
+    };
+
+    // Write a float parameter only if it differs from the cached value.
+    // Returns true if the motor already holds the value or the frame was queued.
+    bool writeFloatParamCached(uint8_t motorId, uint16_t paramIndex, float value);
+
+    // Queue PP_SPEED (only where changed) + LOC_REF (only where changed) for
+    // several motors as one back-to-back batch. The batch is all-or-nothing:
+    // if the TX ring can't take every frame, nothing is sent and the cache is
+    // left untouched so the next call retries. Returns true if queued.
+    bool sendPositionBatch(const PositionCommand* cmds, int count, float ppSpeed);
+
+    // Forget all cached parameter values for a motor.
+    void invalidateParamCache(uint8_t motorId);
+
+    // ---- Active Reporting ----
+    // Every discovered motor is switched to active reporting
+    // (PROACTIVE_REPORT_SET, comm type 0x18) at MOTOR_REPORT_PERIOD_MS, so
+    // status arrives without any polling traffic. Replies to command frames
+    // (e.g. MIT setpoints) update the status the same way. A motor that goes
+    // quiet for MOTOR_STATUS_POLL_MS (power cycle, older firmware) is re-armed
+    // and pinged until it reports again.
+
+    // Set the active report period for one motor (ms, >= 10, 5 ms steps).
+    // Takes effect immediately and is re-applied whenever the motor is re-armed.
+    bool setReportPeriod(uint8_t motorId, uint16_t periodMs);
+
+    // ---- MIT Motion Control (OPERATION_CONTROL) ----
+    // One MOTION_CONTROL frame (comm type 0x01) carries the whole setpoint:
+    // position, velocity, kp, kd in the data bytes and feed-forward torque
+    // in the CAN ID. The motor answers every frame with MOTOR_FEEDBACK, so a
+    // control loop streaming these gets fresh status each tick for free.
+    // The motor must be in RobstrideMode::OPERATION_CONTROL (see setRunMode).
+
+    // One MIT setpoint for sendMotionBatch(). Values are clamped to the
+    // motor spec ranges before packing.
+    struct MotionCommand {
+        uint8_t motorId;
+        float position;     // rad
+        float velocity;     // rad/s
+        float kp;           // Position stiffness (0 = pure damping/torque)
+        float kd;           // Velocity damping
+        float torque;       // Feed-forward torque (Nm)
+    };
+
+    // Send a single MIT setpoint. Returns true if the frame was queued.
+    bool sendMotionControl(uint8_t motorId, float position, float velocity,
+                           float kp, float kd, float torque);
+
+    // Queue MIT setpoints for several motors back-to-back (all-or-nothing,
+    // like sendPositionBatch). Returns true if queued.
+    bool sendMotionBatch(const MotionCommand* cmds, int count);
+
+    // Switch a motor's control mode (RobstrideMode). The motor has to be
+    // stopped for RUN_MODE to take, so this queues stop -> RUN_MODE -> enable
+    // as one batch and drops the param cache. With enable = false the enable
+    // frame is left out and the motor stays stopped in the new mode. While a
+    // motor is in OPERATION_CONTROL the CAN task stops sending its zero-gain
+    // status pings, which would otherwise go limp between setpoints.
+    // Returns false (nothing queued) if the TX ring is full.
+    bool setRunMode(uint8_t motorId, uint8_t mode, bool enable = true);
+
 private:
     // TWAI state
     bool _running = false;
     uint8_t _masterId = ROBSTRIDE_MASTER_ID;
 
-    // Discovered motors (fixed-size array, no heap allocation)
-    static const int MAX_MOTORS = 8;
+    // ---- CAN-task-owned motor table ----
+    // Only touched by the CAN task (and by begin() before the task starts).
     int _motorCount = 0;
     uint8_t _motorIds[MAX_MOTORS];
     RobstrideMotorStatus _motorStatus[MAX_MOTORS];
 
+    // ---- Snapshot publication (CAN task -> control code) ----
+    SeqLock<MotorTable> _published;         // Written by the CAN task
+    MotorTable _view;                       // Caller-side copy, refreshed by poll()
+
+    // ---- Caller-side parameter cache (keyed by motor CAN ID) ----
+    struct ParamCacheEntry {
+        uint16_t paramIndex;    // 0 = empty slot
+        float value;
+    };
+    static const int PARAM_CACHE_SLOTS = 6;
+    struct ParamCacheRow {
+        uint8_t motorId;        // 0 = unused row
+        uint8_t nextEvict;      // Round-robin victim once every slot is used
+        ParamCacheEntry entries[PARAM_CACHE_SLOTS];
+    };
+    ParamCacheRow _paramCache[MAX_MOTORS];
+
     // Motor role assignments (persisted to NVS)
     uint8_t _leftMotorId = 0;    // 0 = unassigned
     uint8_t _rightMotorId = 0;   // 0 = unassigned
@@ -115,28 +279,87 @@ private:
     void loadConfig();
     void saveConfig();
 
-    // Status polling (GET_ID pings to trigger feedback with live position)
-    unsigned long _lastStatusPollMs = 0;
-    int _statusPollMotorIndex = 0;  // Round-robin through motors
+    // ---- Motors in OPERATION_CONTROL (bit per CAN ID, read by CAN task) ----
+    std::atomic<uint32_t> _motionModeMask[4] = {};
+    void setMotionModeFlag(uint8_t motorId, bool motion);
+    bool isMotionMode(uint8_t motorId) const;
+
+    // ---- CAN task ----
+    TaskHandle_t _canTask = nullptr;
+    TaskHandle_t _canAlertTask = nullptr;
+    std::atomic<uint32_t> _pendingAlerts{0};   // TWAI alerts relayed, not yet handled
+    std::atomic<bool> _rescanRequested{false};
+
+    // ---- Discovery state machine (CAN-task-owned) ----
+    enum ScanPhase : uint8_t {
+        SCAN_IDLE,      // Not scanning
+        SCAN_KNOWN,     // Probe NVS left/right IDs + broadcast
+        SCAN_SWEEP,     // Probe remaining IDs a few per pass
+        SCAN_SETTLE     // Wait CAN_SCAN_TIMEOUT_MS for late replies
+    };
+    ScanPhase _scanPhase = SCAN_IDLE;
+    uint8_t _scanNextId = 1;
+    unsigned long _scanPhaseMs = 0;
+    std::atomic<bool> _scanning{false};   // Mirrors _scanPhase != SCAN_IDLE for callers
+
+    // ---- TX ring (multi-producer, drained by the CAN task only) ----
+    static const int TX_RING_LEN = 32;
+    twai_message_t _txRing[TX_RING_LEN];
+    uint32_t _txHead = 0;                   // Next slot to write (guarded by _txMux)
+    uint32_t _txTail = 0;                   // Next slot to send (guarded by _txMux)
+    portMUX_TYPE _txMux;
+
+    // Active reporting. Periods are keyed by CAN ID (0 = config default) so
+    // control code can set them; re-arm times are CAN-task-owned per slot.
+    std::atomic<uint16_t> _reportPeriodMs[128] = {};
+    unsigned long _lastReportArmMs[MAX_MOTORS];  // 0 = never armed
+
+    // ---- Feedback timing ----
+    // Per-slot arrival history (CAN-task-owned) for interval/jitter stats.
+    static const int FEEDBACK_HISTORY_LEN = 8;
+    struct FeedbackHistory {
+        uint32_t rxUs[FEEDBACK_HISTORY_LEN];
+        uint8_t head;    // Next slot to write
+        uint8_t count;   // Valid samples (<= FEEDBACK_HISTORY_LEN)
+    };
+    FeedbackHistory _history[MAX_MOTORS];
+
+    // When a feedback-eliciting command went out, keyed by CAN ID
+    // (written when the CAN task hands it to the driver, consumed on RX).
+    // 0 = nothing outstanding; stored values are forced odd to stay non-zero.
+    std::atomic<uint32_t> _cmdSentUs[128] = {};
 
     // Voltage polling
     unsigned long _lastVbusPollMs = 0;
     int _vbusPollMotorIndex = 0;   // Round-robin through motors
 
-    // Parameter read state (for async VBUS reads)
-    bool _paramReadPending = false;
-    uint16_t _paramReadIndex = 0;
-    uint8_t _paramReadMotorId = 0;
-    float _paramReadValue = 0;
-    unsigned long _paramReadStartMs = 0;
+    // In-flight parameter reads. A slot is claimed with a CAS on its state so
+    // any context can start a read; only the CAN task completes or expires it.
+    static const int PARAM_READ_SLOTS = 16;
+    static const uint8_t PARAM_READ_IDLE = 0;
+    static const uint8_t PARAM_READ_CLAIMED = 1;    // Fields being filled in
+    static const uint8_t PARAM_READ_IN_FLIGHT = 2;  // Waiting for the response
+    struct ParamReadSlot {
+        std::atomic<uint8_t> state{PARAM_READ_IDLE};
+        uint8_t motorId;
+        uint16_t paramIndex;
+        unsigned long startMs;
+        ParamReadCallback callback;
+        void* ctx;
+        uint32_t tag;
+    };
+    ParamReadSlot _paramReads[PARAM_READ_SLOTS];
+    float _paramReadValue = 0;          // Value of the most recent completed read
 
     // ---- Internal Methods ----
 
     // Initialize TWAI driver
     bool initTwai();
 
-    // Scan for motors on the bus
-    void scanMotors();
+    // Start / advance the discovery state machine
+    void startScan();
+    void stepScan();
+    bool sendProbe(uint8_t motorId);
 
     // Find internal index for a motor ID (-1 if not found)
     int findMotorIndex(uint8_t motorId) const;
@@ -147,23 +370,67 @@ private:
     // Build extended CAN ID for Robstride protocol
     uint32_t buildExtendedId(uint8_t commType, uint8_t motorId, uint16_t extraData = 0);
 
-    // Send a CAN message
+    // Queue a CAN message on the TX ring and kick a flush. Never blocks.
+    // Returns false only if the ring is full.
     bool sendMessage(uint32_t id, const uint8_t* data, uint8_t len);
 
+    // Fill a TWAI extended-ID frame
+    static void buildFrame(twai_message_t& msg, uint32_t id, const uint8_t* data, uint8_t len);
+
+    // Pack an MIT setpoint into a MOTION_CONTROL frame
+    void buildMotionFrame(twai_message_t& msg, const MotionCommand& cmd);
+
+    // TX ring helpers
+    int txRingFree();
+    bool txRingPush(const twai_message_t* msgs, int count);   // All-or-nothing, wakes the CAN task
+    void flushTx();                                            // CAN task only
+
+    // Receive and dispatch pending RX frames (up to maxFrames)
+    void drainRx(int maxFrames);
+
+    // Copy the task-owned table into _published (CAN task only)
+    void publishSnapshot();
+
+    // CAN task body (static, receives MotorManager* as param)
+    static void canTaskFunc(void* param);
+
+    // Alert relay body: twai_read_alerts() -> _pendingAlerts + notification
+    static void canAlertTaskFunc(void* param);
+
+    // Fill an 8-byte SET_SINGLE_PARAM payload for a float parameter
+    static void packFloatParam(uint8_t* data, uint16_t paramIndex, float value);
+
+    // Param cache helpers (caller side, by motor CAN ID)
+    ParamCacheRow* findCacheRow(uint8_t motorId, bool create);
+    const ParamCacheEntry* findCachedParam(uint8_t motorId, uint16_t paramIndex);
+    void storeCachedParam(uint8_t motorId, uint16_t paramIndex, float value);
+
     // Process a single received CAN message
-    void processMessage(uint32_t canId, const uint8_t* data, uint8_t len);
+    void processMessage(uint32_t canId, const uint8_t* data, uint8_t len, uint32_t rxUs);
 
     // Parse motor feedback (comm type 0x02)
-    void parseMotorFeedback(uint8_t motorId, uint32_t canId, const uint8_t* data);
+    void parseMotorFeedback(uint8_t motorId, uint32_t canId, const uint8_t* data, uint32_t rxUs);
+
+    // Update arrival history / interval / jitter / RTT for a feedback frame
+    void recordFeedbackTiming(int idx, uint8_t motorId, uint32_t rxUs);
 
     // Parse parameter response
     void parseParameterResponse(uint8_t motorId, const uint8_t* data);
 
     // Request a parameter read from a motor
-    bool requestParameter(uint8_t motorId, uint16_t paramIndex);
+    bool requestParameter(uint8_t motorId, uint16_t paramIndex,
+                          ParamReadCallback callback = nullptr, void* ctx = nullptr,
+                          uint32_t tag = 0);
+
+    // Find an in-flight read slot for (motor, param), or -1
+    int findParamRead(uint8_t motorId, uint16_t paramIndex) const;
+
+    // Fail reads that have waited longer than MOTOR_PARAM_READ_TIMEOUT_MS
+    void expireParamReads();
 
-    // Periodic status pings (GET_ID to trigger feedback with live position)
-    void pollStatus();
+    // Keep every motor reporting: arm new ones, re-arm and ping quiet ones
+    void maintainReporting();
+    bool armReporting(uint8_t motorId);
 
     // Check for stale/disconnected motors
     void checkStaleness();
@@ -0,0 +1,215 @@
+// =============================================================================
+// Profiler Module - Implementation
+// =============================================================================
+
+#include "profiler.h"
+
+#include <cstring>
+
+// Samples above this land in the last bucket (~33 s)
+static const uint32_t MAX_SAMPLE_US = (1u << 25) - 1;
+
+static const char* const STAGE_NAMES[PROF_STAGE_COUNT] = {
+    "loop",
+    "m5",
+    "ctrl",
+    "imu",
+    "trim",
+    "selfRight",
+    "noseDown",
+    "stick",
+    "motor",
+    "wifi",
+    "display",
+    "render",
+    "drive",
+    "http",
+    "inHci",
+    "inParse",
+    "inLoop",
+    "inDrive",
+    "inServo",
+    "inCan",
+};
+
+// ---------------------------------------------------------------------------
+// Bucket layout
+// ---------------------------------------------------------------------------
+// 0..3 us get a bucket each. Above that, every power of two [2^m, 2^(m+1))
+// is split into 4 equal sub-buckets, indexed by the two bits below the MSB.
+
+int LatencyHistogram::bucketIndex(uint32_t us) {
+    if (us < 4) {
+        return (int)us;
+    }
+    if (us > MAX_SAMPLE_US) {
+        us = MAX_SAMPLE_US;
+    }
+    int msb = 31 - __builtin_clz(us);
+    int sub = (int)((us >> (msb - 2)) & 3);
+    return (msb - 1) * 4 + sub;
+}
+
+uint32_t LatencyHistogram::bucketLower(int index) {
+    if (index < 4) {
+        return (uint32_t)index;
+    }
+    int msb = index / 4 + 1;
+    int sub = index % 4;
+    return (uint32_t)(4 + sub) << (msb - 2);
+}
+
+uint32_t LatencyHistogram::bucketUpper(int index) {
+    if (index < 4) {
+        return (uint32_t)index + 1;
+    }
+    int msb = index / 4 + 1;
+    return bucketLower(index) + (1u << (msb - 2));
+}
+
+// ---------------------------------------------------------------------------
+// LatencyHistogram
+// ---------------------------------------------------------------------------
+
+void LatencyHistogram::record(uint32_t us) {
+    // Resets are requested by readers and applied here, by the only writer.
+    // Taking the flag before clearing means a reset() that lands meanwhile
+    // stays pending for the next sample instead of being lost.
+    if (_resetPending.exchange(false, std::memory_order_acq_rel)) {
+        clear();
+    }
+
+    std::atomic<uint32_t>& bucket = _buckets[bucketIndex(us)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _count.store(_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (us > _max.load(std::memory_order_relaxed)) {
+        _max.store(us, std::memory_order_relaxed);
+    }
+
+    _windowCount.store(_windowCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _windowSum.store(_windowSum.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+    if (_windowMaxResetPending.exchange(false, std::memory_order_acq_rel)) {
+        _windowMax.store(us, std::memory_order_relaxed);
+    } else if (us > _windowMax.load(std::memory_order_relaxed)) {
+        _windowMax.store(us, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::getStats(ProfileStats* out) const {
+    out->count = 0;
+    out->max = 0;
+    out->p50 = 0;
+    out->p90 = 0;
+    out->p99 = 0;
+    // Checked before the counters: a reset the writer hasn't applied yet
+    // reads as empty rather than as the stale totals
+    if (_resetPending.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    uint32_t counts[BUCKET_COUNT];
+    copyBuckets(counts);
+
+    uint32_t total = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        total += counts[i];
+    }
+
+    out->count = _count.load(std::memory_order_relaxed);
+    out->max = _max.load(std::memory_order_relaxed);
+    if (total == 0) {
+        return;
+    }
+
+    // Rank of each percentile (1-based, rounded up)
+    const uint32_t rank50 = (uint32_t)(((uint64_t)total * 50 + 99) / 100);
+    const uint32_t rank90 = (uint32_t)(((uint64_t)total * 90 + 99) / 100);
+    const uint32_t rank99 = (uint32_t)(((uint64_t)total * 99 + 99) / 100);
+
+    // Report the top of the bucket holding the rank, capped at the exact max.
+    // 0 is a real percentile (sub-us stages), so track which are set.
+    uint32_t seen = 0;
+    bool found50 = false;
+    bool found90 = false;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        seen += counts[i];
+        uint32_t top = bucketUpper(i) - 1;
+        if (top > out->max) {
+            top = out->max;
+        }
+        if (!found50 && seen >= rank50) { out->p50 = top; found50 = true; }
+        if (!found90 && seen >= rank90) { out->p90 = top; found90 = true; }
+        if (seen >= rank99) {
+            out->p99 = top;
+            break;
+        }
+    }
+}
+
+ProfileWindow LatencyHistogram::takeWindow() {
+    // Read-only on the writer's counters: count/sum as differences from
+    // the last call, max restarted by the writer on its next sample
+    uint32_t count = _windowCount.load(std::memory_order_relaxed);
+    uint32_t sum = _windowSum.load(std::memory_order_relaxed);
+
+    ProfileWindow w;
+    w.count = count - _takenCount;
+    w.sumUs = sum - _takenSum;
+    w.maxUs = 0;
+    // A writer mid-sample may not have taken up the last restart yet; the
+    // max then reads 0 for this window rather than a stale value
+    if (w.count > 0 && !_windowMaxResetPending.load(std::memory_order_acquire)) {
+        w.maxUs = _windowMax.load(std::memory_order_relaxed);
+        _windowMaxResetPending.store(true, std::memory_order_release);
+    }
+    _takenCount = count;
+    _takenSum = sum;
+    return w;
+}
+
+void LatencyHistogram::reset() {
+    _resetPending.store(true, std::memory_order_release);
+}
+
+void LatencyHistogram::clear() {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::copyBuckets(uint32_t* out) const {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        out[i] = _buckets[i].load(std::memory_order_relaxed);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Profiler
+// ---------------------------------------------------------------------------
+
+void Profiler::resetAll() {
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        _hist[i].reset();
+    }
+}
+
+const char* Profiler::stageName(ProfileStage stage) {
+    if (stage >= PROF_STAGE_COUNT) {
+        return "?";
+    }
+    return STAGE_NAMES[stage];
+}
+
+ProfileStage Profiler::stageFromName(const char* name) {
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        if (strcmp(name, STAGE_NAMES[i]) == 0) {
+            return (ProfileStage)i;
+        }
+    }
+    return PROF_STAGE_COUNT;
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+// =============================================================================
+// Profiler Module
+// =============================================================================
+// Per-stage latency histograms for the main loop, the drive task and the
+// HTTP handlers, so a jitter spike can be pinned on the stage that caused it
+// instead of showing up only in the loop's overall max.
+//
+// Each stage owns a log-bucketed histogram: 4 sub-buckets per power of two
+// (<= 25% relative error), 96 buckets covering 0 us .. ~33 s. From the
+// buckets the profiler reports p50/p90/p99; max and count are exact.
+//
+// Two views of the same samples:
+//   - cumulative (since boot or resetAll()) -- histograms, served at /metrics
+//   - window (since the last takeWindow()) -- count/sum/max, drained by the
+//     loop's periodic timing log (the only window reader)
+//
+// The input stages are not scoped timers: they are the gaps between
+// timestamps a controller report collects on its way from the Bluetooth
+// controller to the servo and CAN outputs, so a slow stick response can be
+// blamed on the BT stack, the loop or the drive task.
+//
+// Lock-free: each stage has exactly one writer (the loop, the drive task or
+// the httpd task), which updates its counters with relaxed atomic
+// load/store -- no read-modify-write instructions on the hot path. Readers
+// on other tasks see a slightly skewed but never torn snapshot, and never
+// write the writer's counters: resets only set a flag that the writer
+// applies on its next sample. Window count and sum run on forever and
+// takeWindow() reports the difference from its previous call; the window
+// max is restarted through a flag like the cumulative reset.
+//
+// Usage:
+//   {
+//       PROFILE_SCOPE(PROF_STAGE_WIFI);     // times until end of scope
+//       g_wifiManager.loop();
+//   }
+//   g_profiler.getStats(PROF_STAGE_WIFI, &stats);
+// =============================================================================
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <atomic>
+#include "config.h"
+
+enum ProfileStage : uint8_t {
+    PROF_STAGE_LOOP,            // Whole loop() iteration
+    PROF_STAGE_M5,              // M5.update()
+    PROF_STAGE_CTRL,            // Bluepad32 controller poll
+    PROF_STAGE_IMU,             // IMU snapshot from the balance task
+    PROF_STAGE_TRIM,            // D-pad trim / zeroing
+    PROF_STAGE_SELF_RIGHT,      // Self-righting state machine
+    PROF_STAGE_NOSE_DOWN,       // Nose-down state machine
+    PROF_STAGE_STICK,           // Left-stick arm control
+    PROF_STAGE_MOTOR,           // CAN poll + motor init sequencers
+    PROF_STAGE_WIFI,            // WiFi reconnect handling
+    PROF_STAGE_DISPLAY,         // Display snapshot publish
+    PROF_STAGE_RENDER,          // Display task frame (CPU0)
+    PROF_STAGE_DRIVE,           // Drive task tick (CPU0)
+    PROF_STAGE_HTTP,            // HTTP handlers (httpd task)
+
+    // Input latency: one sample per controller report, measured from
+    // timestamps carried with it (see ControllerState)
+    PROF_STAGE_IN_HCI,          // VHCI callback -> BTstack thread picks the packet
+    PROF_STAGE_IN_PARSE,        // BTstack pickup -> parsed report in the mailbox
+    PROF_STAGE_IN_LOOP,         // Mailbox -> loop() publishes the ControllerState
+    PROF_STAGE_IN_DRIVE,        // Mailbox publish -> drive task uses it
+    PROF_STAGE_IN_SERVO,        // End to end: VHCI callback -> LEDC duty written
+    PROF_STAGE_IN_CAN,          // End to end: VHCI callback -> arm CAN command
+    PROF_STAGE_COUNT
+};
+
+// Percentiles and totals for one stage (all times in us)
+struct ProfileStats {
+    uint32_t count;
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+};
+
+// Window totals since the previous takeWindow()
+struct ProfileWindow {
+    uint32_t count;
+    uint32_t sumUs;
+    uint32_t maxUs;
+};
+
+class LatencyHistogram {
+public:
+    static const int BUCKET_COUNT = 96;
+
+    // Single writer only
+    void record(uint32_t us);
+
+    void getStats(ProfileStats* out) const;
+
+    // Totals since the previous call. One reader only.
+    ProfileWindow takeWindow();
+
+    // Clear the cumulative counts (any task; applied by the next record())
+    void reset();
+
+    // Copy the bucket counts (BUCKET_COUNT entries)
+    void copyBuckets(uint32_t* out) const;
+
+    // Bucket index for a sample, and the [lower, upper) range of a bucket
+    static int bucketIndex(uint32_t us);
+    static uint32_t bucketLower(int index);
+    static uint32_t bucketUpper(int index);
+
+private:
+    std::atomic<uint32_t> _buckets[BUCKET_COUNT] = {};
+    std::atomic<uint32_t> _count{0};
+    std::atomic<uint32_t> _max{0};
+
+    // Window: count/sum never reset (wrap is fine for differences)
+    std::atomic<uint32_t> _windowCount{0};
+    std::atomic<uint32_t> _windowSum{0};
+    std::atomic<uint32_t> _windowMax{0};
+
+    std::atomic<bool> _resetPending{false};
+    std::atomic<bool> _windowMaxResetPending{false};
+
+    // Window reader's position (takeWindow() only)
+    uint32_t _takenCount = 0;
+    uint32_t _takenSum = 0;
+
+    void clear();
+};
+
+class Profiler {
+public:
+    void record(ProfileStage stage, uint32_t us) {
+#if PROFILER_ENABLED
+        _hist[stage].record(us);
+#endif
+    }
+
+    void getStats(ProfileStage stage, ProfileStats* out) const { _hist[stage].getStats(out); }
+    ProfileWindow takeWindow(ProfileStage stage) { return _hist[stage].takeWindow(); }
+    const LatencyHistogram& getHistogram(ProfileStage stage) const { return _hist[stage]; }
+
+    // Clear the cumulative histograms (windows are left to their reader)
+    void resetAll();
+
+    static const char* stageName(ProfileStage stage);
+
+    // Stage by name ("wifi", "drive", ...); PROF_STAGE_COUNT if unknown
+    static ProfileStage stageFromName(const char* name);
+
+private:
+    LatencyHistogram _hist[PROF_STAGE_COUNT];
+};
+
+extern Profiler g_profiler;
+
+// ---------------------------------------------------------------------------
+// Scoped timer -- records the time from construction to end of scope
+// ---------------------------------------------------------------------------
+class ScopedTimer {
+public:
+    explicit ScopedTimer(ProfileStage stage)
+        : _stage(stage), _startUs((uint32_t)esp_timer_get_time()) {}
+
+    ~ScopedTimer() {
+        g_profiler.record(_stage, (uint32_t)esp_timer_get_time() - _startUs);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    ProfileStage _stage;
+    uint32_t _startUs;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(stage) ScopedTimer PROFILE_CONCAT(_profScope, __LINE__)(stage)
+#else
+#define PROFILE_SCOPE(stage) do {} while (0)
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+
+// =============================================================================
+// Robot Status
+// =============================================================================
+// Attitude and state-machine summary owned by loop(), published once per
+// tick through a SeqLock so the web server and the telemetry task read a
+// coherent set instead of separately updated globals.
+// =============================================================================
+
+#include <Arduino.h>
+#include "seqlock.h"
+
+struct RobotStatus {
+    float pitch;                // rad (0 = level, negative = nose-down)
+    bool upsideDown;            // Gravity axis flipped vs boot reference
+    uint8_t selfRightState;     // SelfRightState (sketch.cpp)
+    uint8_t noseDownState;      // NoseDownState (sketch.cpp)
+};
+
+// Written by loop() only (defined in sketch.cpp)
+extern SeqLock<RobotStatus> g_robotStatus;
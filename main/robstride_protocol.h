@@ -98,7 +98,20 @@ namespace RobstrideParam {
     // Position mode (PP) parameters
     static const uint16_t PP_SPEED         = 0x7024;  // PP max speed (float, rad/s)
     static const uint16_t PP_ACCELERATION  = 0x7025;  // PP acceleration (float, rad/s^2)
-    static const uint16_t SPD_ACCELERATION = 0x7026;  // Speed mode accel (float, rad/s^2)
+    static const uint16_t SPD_ACCELERATION = 0x7022;  // Speed mode accel (float, rad/s^2)
+
+    // Reporting
+    static const uint16_t EPSCAN_TIME      = 0x7026;  // Active report period (uint16, 1=10ms, +1=+5ms)
+}
+
+// =============================================================================
+// Active Reporting (comm type 0x18)
+// =============================================================================
+// Request data: 01 02 03 04 05 06 <enable> 00. While enabled, the motor sends
+// MOTOR_FEEDBACK frames on its own every EPSCAN_TIME period.
+namespace RobstrideReport {
+    static const uint16_t MIN_PERIOD_MS  = 10;   // EPSCAN_TIME = 1
+    static const uint16_t PERIOD_STEP_MS = 5;    // Each EPSCAN_TIME step adds 5 ms
 }
 
 // =============================================================================
@@ -177,4 +190,11 @@ struct RobstrideMotorStatus {
     bool hasFault;       // Whether any fault bits are set
     bool stale;          // No feedback received recently (motor may be disconnected)
     unsigned long lastUpdateMs;  // millis() of last feedback received
+
+    // Feedback timing (esp_timer microseconds, low 32 bits -- compare with
+    // unsigned subtraction). Stamped when the frame leaves the TWAI RX queue.
+    uint32_t lastRxUs;           // Arrival of the latest feedback frame
+    uint32_t intervalUs;         // Mean feedback interval over the recent history
+    uint32_t jitterUs;           // Mean absolute deviation from intervalUs
+    uint32_t rttUs;              // Last command -> feedback round trip (0 = none yet)
 };
@@ -0,0 +1,92 @@
+#pragma once
+
+// =============================================================================
+// SeqLock
+// =============================================================================
+// Single-writer publication of a plain-data struct to readers on any task or
+// core, without a mutex. Readers always get a coherent copy -- never half of
+// one update and half of the next.
+//
+// Double-buffered: the value lives in two slots and a sequence counter
+// points at the current one. The writer fills the other slot, then advances
+// the counter to it. A reader copies the current slot and retries only if
+// the counter moved during the copy (the writer finished a publish and may
+// be refilling the slot being copied). Unlike an odd/even seqlock, a reader
+// never waits for a write in progress -- so a reader that preempts the
+// writer on the same core cannot spin.
+//
+// T must be trivially copyable. The writer may touch the back slot in place
+// (beginWrite/endWrite) but must rewrite every field: the slot still holds
+// the value from two publishes ago.
+//
+// Usage:
+//   SeqLock<BalanceState> _published;
+//   _published.store(_state);                // Writer task
+//   BalanceState s = _published.load();      // Any task
+// =============================================================================
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a plain-data type");
+
+public:
+    // ---- Writer (one task only) ----
+
+    // Publish a copy of value
+    void store(const T& value) {
+        memcpy(beginWrite(), &value, sizeof(T));
+        endWrite();
+    }
+
+    // Back slot to fill in place; publish it with endWrite()
+    T* beginWrite() {
+        uint32_t seq = _seq.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return &_slots[(seq + 1) & 1];
+    }
+
+    void endWrite() {
+        uint32_t seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_release);
+    }
+
+    // ---- Readers (any task) ----
+
+    T load() const {
+        T out;
+        load(&out);
+        return out;
+    }
+
+    // Copy the latest value; returns its sequence number
+    uint32_t load(T* out) const {
+        return read([out](const T& value) { memcpy(out, &value, sizeof(T)); });
+    }
+
+    // Run fn on the latest value, repeating it if the value changed
+    // underneath. fn must only copy out of the value (it may see a torn
+    // one on a pass that gets retried). Returns the sequence number read.
+    template <typename Fn>
+    uint32_t read(Fn fn) const {
+        uint32_t seqBefore;
+        uint32_t seqAfter;
+        do {
+            seqBefore = _seq.load(std::memory_order_acquire);
+            fn(_slots[seqBefore & 1]);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            seqAfter = _seq.load(std::memory_order_relaxed);
+        } while (seqBefore != seqAfter);
+        return seqBefore;
+    }
+
+    // Number of publishes so far
+    uint32_t sequence() const { return _seq.load(std::memory_order_acquire); }
+
+private:
+    T _slots[2] = {};
+    std::atomic<uint32_t> _seq{0};
+};
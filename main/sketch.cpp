@@ -18,8 +18,13 @@
 #include "controller_manager.h"
 #include "drive_manager.h"
 #include "motor_manager.h"
+#include "motor_init.h"
+#include "balance_manager.h"
+#include "flight_recorder.h"
+#include "profiler.h"
 #include "robstride_protocol.h"
 #include "display_manager.h"
+#include "robot_status.h"
 #include "settings_manager.h"
 
 #include "esp_coexist.h"
@@ -32,6 +37,9 @@ WebServerManager g_webServer;
 // g_controllerManager is defined in controller_manager.cpp
 DriveManager g_driveManager;
 MotorManager g_motorManager;
+BalanceManager g_balanceManager;
+FlightRecorder g_flightRecorder;
+Profiler g_profiler;
 DisplayManager g_displayManager;
 SettingsManager g_settingsManager;
 
@@ -39,7 +47,7 @@ SettingsManager g_settingsManager;
 static bool s_webServerStarted = false;
 
 // ---------------------------------------------------------------------------
-// Motor trim state (extern-accessible for display_manager)
+// Motor trim state
 // ---------------------------------------------------------------------------
 float g_trimTargetLeft = 0.0f;
 float g_trimTargetRight = 0.0f;
@@ -56,10 +64,15 @@ static unsigned long s_lastTrimStepMs = 0;
 static const unsigned long SYS_DEBOUNCE_MS = 500;
 static unsigned long s_lastSysMs = 0;
 
-// Track which motor CAN IDs have been initialized for trim.
-// Stored as CAN IDs (not bools) so we can detect when a motor changes.
-static uint8_t s_trimInitLeftId = 0;
-static uint8_t s_trimInitRightId = 0;
+// Async init/recovery sequence per arm. Each remembers which CAN ID it
+// brought up so we can detect when a motor changes.
+static MotorInit s_leftInit;
+static MotorInit s_rightInit;
+
+// Sys-button zero: waiting for the motors to report the new zero before
+// commanding them to hold it.
+static bool s_sysZeroPending = false;
+static unsigned long s_sysZeroMs = 0;
 
 // Track which motors have been auto-zeroed at startup.
 // On first connect we assume arms are in front and set mechanical zero.
@@ -101,6 +114,7 @@ static const ArmPreset TRIGGER_TARGETS[] = {
 // ---------------------------------------------------------------------------
 static float s_basePosition = 0.0f;          // Accumulated Y-axis jog position (rad)
 static unsigned long s_lastStickUpdateMs = 0; // Rate limiter
+static uint32_t s_canTracedRxUs = 0;           // Last report traced to an arm command
 static uint16_t s_prevButtons = 0;            // For button edge detection
 static int s_homePresetIndex = 0;             // Current home preset (0-3)
 static float s_zeroOffset = 0.0f;            // Accumulated zero-point offset from L3 resets
@@ -108,16 +122,13 @@ static float s_zeroOffset = 0.0f;            // Accumulated zero-point offset fr
 // ---------------------------------------------------------------------------
 // IMU state
 // ---------------------------------------------------------------------------
-volatile bool g_isUpsideDown = false;         // Cross-core flag for drive inversion
-static float s_referenceAccelX = 0.0f;        // Captured at boot (gravity axis reference)
+// Loop-side copies of the balance task's latest snapshot (see updateIMU)
+static bool s_isUpsideDown = false;           // Drive inversion (pushed to DriveManager)
 static float s_pitchAngle = 0.0f;             // Current pitch in radians (0=level, neg=nose-down)
-static float s_gyroPitchRate = 0.0f;          // Gyro pitch rate for PID D-term (rad/s)
-static unsigned long s_lastImuMs = 0;
+static float s_gyroPitchRate = 0.0f;          // Gyro pitch rate (rad/s)
 
-// Web-accessible copies of state (read by web_server.cpp)
-float g_pitchAngleForWeb = 0.0f;
-int g_selfRightStateForWeb = 0;
-int g_noseDownStateForWeb = 0;
+// Published once per tick for the web server and telemetry
+SeqLock<RobotStatus> g_robotStatus;
 
 // ---------------------------------------------------------------------------
 // Self-righting state machine (Select button)
@@ -134,14 +145,8 @@ enum NoseDownState { ND_IDLE, ND_SELF_RIGHTING, ND_TIPPING, ND_BALANCING, ND_EXI
 static NoseDownState s_noseDownState = ND_IDLE;
 static unsigned long s_noseDownMs = 0;        // Timestamp for state transitions
 static unsigned long s_balanceStartMs = 0;    // When PID balancing began
-static float s_rampProgress = 0.0f;          // Pitch-gated ramp [0..1] (replaces time-based ramp)
-static unsigned long s_lastRampMs = 0;       // Last time we advanced the ramp
 static bool s_prevXBtn = false;               // Edge detection for X button
-
-// PID state for nose-down balance
-static float s_pidIntegral = 0.0f;
-static float s_pidPrevError = 0.0f;
-
+// (Ramp + PID state live on the balance task -- see balance_manager.h)
 // Nose-down self-righting sub-state (reuses SR logic)
 enum NdSelfRightSub { NDSR_PREP, NDSR_PUSH, NDSR_DONE };
 static NdSelfRightSub s_ndSrSub = NDSR_PREP;
@@ -189,12 +194,11 @@ void setup() {
 
     LOG_INFO("Main", "M5Unified initialized");
 
-    // Capture IMU reference orientation (robot is flat and level at boot)
-    // Axis mapping: X = vertical (gravity), Y = forward, Z = lateral (roll)
-    M5.Imu.update();
-    auto imuData = M5.Imu.getImuData();
-    s_referenceAccelX = imuData.accel.x;
-    LOG_INFO("Main", "IMU reference accelX=%.3f", s_referenceAccelX);
+    // PSRAM ring for per-tick balance records (before the balance task starts)
+    g_flightRecorder.begin();
+
+    // Capture IMU reference orientation and start the IMU/balance task (CPU1)
+    g_balanceManager.begin();
 
     // Initialize display
     g_displayManager.begin();
@@ -233,52 +237,13 @@ void setup() {
 //   System=0x01
 // ---------------------------------------------------------------------------
 
-static void initMotorForTrim(uint8_t motorId, bool setZero) {
-    // Stop motor first to ensure clean RESET state, clearing any faults
-    g_motorManager.stopMotor(motorId, true);
-    delay(10);
-
-    // On first connect, assume arms are in front and set current position as zero
-    if (setZero) {
-        g_motorManager.setMechanicalZero(motorId);
-        LOG_INFO("Trim", "Auto-zeroed motor %d (arms assumed in front)", motorId);
-        delay(10);
-    }
-
-    // Set run mode to Position PP (interpolated position control)
-    g_motorManager.writeUint8Param(motorId, RobstrideParam::RUN_MODE,
-                                   RobstrideMode::POSITION_PP);
-    delay(10);
-
-    // Set PP mode parameters:
-    //   PP_SPEED        - max velocity during profiled move
-    //   PP_ACCELERATION  - accel/decel rate (higher = snappier)
-    //   LIMIT_CUR       - motor current limit
-    //   LIMIT_SPD       - general safety speed backstop
-    float spdLimit = g_settingsManager.getMotorSpeedLimit();
-    float accel    = g_settingsManager.getMotorAcceleration();
-    float curLimit = g_settingsManager.getMotorCurrentLimit();
-    g_motorManager.writeFloatParam(motorId, RobstrideParam::LIMIT_CUR, curLimit);
-    delay(10);
-    g_motorManager.writeFloatParam(motorId, RobstrideParam::PP_SPEED, spdLimit);
-    delay(10);
-    g_motorManager.writeFloatParam(motorId, RobstrideParam::PP_ACCELERATION, accel);
-    delay(10);
-    g_motorManager.writeFloatParam(motorId, RobstrideParam::LIMIT_SPD, spdLimit);
-    delay(10);
-
-    // Enable the motor
-    g_motorManager.enableMotor(motorId);
-    LOG_INFO("Trim", "Init motor %d (stop%s->PP->enable, spd=%.1f accel=%.1f cur=%.1f)",
-             motorId, setZero ? "->zero" : "", spdLimit, accel, curLimit);
-}
-
-// Check if a motor is in RUNNING state. If not (e.g. after power cycle),
-// re-initialize it for trim. Returns true if the motor is ready.
+// Check if a motor is up and RUNNING in POSITION_PP. If not (first use,
+// power cycle, fault, role change), kick off its async init sequence and
+// return false until the motor has acknowledged every step -- the main loop
+// keeps running at full rate meanwhile.
 // autoZeroTracker persists across reconnects (never reset) so we only
 // set mechanical zero once per boot, assuming arms start in front.
-static bool ensureMotorReady(uint8_t motorId, uint8_t& initTracker,
-                             uint8_t& autoZeroTracker) {
+static bool ensureMotorReady(uint8_t motorId, MotorInit& init, uint8_t& autoZeroTracker) {
     int idx = -1;
     for (int i = 0; i < g_motorManager.getMotorCount(); i++) {
         if (g_motorManager.getMotorId(i) == motorId) {
@@ -299,20 +264,27 @@ static bool ensureMotorReady(uint8_t motorId, uint8_t& initTracker,
         return false;
     }
 
-    // If motor is already running and we've initialized this ID, it's ready
-    if (status.enabled && initTracker == motorId) {
-        return true;
+    if (init.getMotorId() == motorId) {
+        if (init.isReady()) {
+            // Only the very first successful init after boot sets zero
+            autoZeroTracker = motorId;
+            if (status.enabled) {
+                return true;
+            }
+            // Dropped out of RUNNING (power cycle, fault) -- fall through to re-init
+        } else if (init.isBusy()) {
+            return false;
+        } else if (init.getState() == MotorInit::FAILED && !init.canRetry()) {
+            return false;
+        }
     }
 
-    // Motor is not running (RESET after power cycle, fault, etc.) -- re-init
-    // Only set mechanical zero on the very first initialization after boot
     bool needsZero = (autoZeroTracker != motorId);
-    initMotorForTrim(motorId, needsZero);
-    initTracker = motorId;
-    if (needsZero) {
-        autoZeroTracker = motorId;
-    }
-    return true;
+    init.start(motorId, needsZero,
+               g_settingsManager.getMotorSpeedLimit(),
+               g_settingsManager.getMotorAcceleration(),
+               g_settingsManager.getMotorCurrentLimit());
+    return false;
 }
 
 // Resolve the CAN ID for the "left" motor.
@@ -343,8 +315,9 @@ static uint8_t resolveRightMotorId() {
     return 0;
 }
 
-// Forward declaration
+// Forward declarations
 static void sendMotorPosition(uint8_t motorId, float position);
+static void sendArmPositions(uint8_t leftId, float leftTarget, uint8_t rightId, float rightTarget);
 
 static void processTrim() {
     // Get the first connected controller's state
@@ -363,8 +336,9 @@ static void processTrim() {
                 LOG_INFO("Trim", "Controller lost -- stopped right motor (ID %d)", rightId);
             }
             // Reset trim and stick state so motors get re-initialized on reconnect
-            s_trimInitLeftId = 0;
-            s_trimInitRightId = 0;
+            s_leftInit.reset();
+            s_rightInit.reset();
+            s_sysZeroPending = false;
             g_trimTargetLeft = 0.0f;
             g_trimTargetRight = 0.0f;
             s_basePosition = 0.0f;
@@ -390,6 +364,15 @@ static void processTrim() {
     s_prevDpad = dpad;
     s_prevMiscButtons = misc;
 
+    // Self-righting and nose-down own the arms while active (MIT mode when
+    // balancing): no nudges, re-init or re-zeroing until both are idle --
+    // same guard as processStickControl(). A zero still waiting for its
+    // hold command is dropped, the mode has moved the arms since.
+    if (s_selfRightState != SR_IDLE || s_noseDownState != ND_IDLE) {
+        s_sysZeroPending = false;
+        return;
+    }
+
     unsigned long now = millis();
 
     // Resolve motor IDs (explicit role or fallback to discovered index)
@@ -403,7 +386,7 @@ static void processTrim() {
         if (now - s_lastTrimStepMs >= TRIM_REPEAT_MS) {
             // D-pad Up: nudge left motor positive
             if (dpad & 0x01) {
-                if (leftId > 0 && ensureMotorReady(leftId, s_trimInitLeftId, s_autoZeroedLeftId)) {
+                if (leftId > 0 && ensureMotorReady(leftId, s_leftInit, s_autoZeroedLeftId)) {
                     g_trimTargetLeft += TRIM_STEP_RAD;
                     sendMotorPosition(leftId, g_trimTargetLeft);
                     LOG_INFO("Trim", "Left motor (ID %d) target: %.3f rad", leftId, g_trimTargetLeft);
@@ -412,7 +395,7 @@ static void processTrim() {
 
             // D-pad Down: nudge left motor negative
             if (dpad & 0x02) {
-                if (leftId > 0 && ensureMotorReady(leftId, s_trimInitLeftId, s_autoZeroedLeftId)) {
+                if (leftId > 0 && ensureMotorReady(leftId, s_leftInit, s_autoZeroedLeftId)) {
                     g_trimTargetLeft -= TRIM_STEP_RAD;
                     sendMotorPosition(leftId, g_trimTargetLeft);
                     LOG_INFO("Trim", "Left motor (ID %d) target: %.3f rad", leftId, g_trimTargetLeft);
@@ -421,7 +404,7 @@ static void processTrim() {
 
             // D-pad Right: nudge right motor positive
             if (dpad & 0x04) {
-                if (rightId > 0 && ensureMotorReady(rightId, s_trimInitRightId, s_autoZeroedRightId)) {
+                if (rightId > 0 && ensureMotorReady(rightId, s_rightInit, s_autoZeroedRightId)) {
                     g_trimTargetRight += TRIM_STEP_RAD;
                     sendMotorPosition(rightId, -g_trimTargetRight);
                     LOG_INFO("Trim", "Right motor (ID %d) target: %.3f rad", rightId, g_trimTargetRight);
@@ -430,7 +413,7 @@ static void processTrim() {
 
             // D-pad Left: nudge right motor negative
             if (dpad & 0x08) {
-                if (rightId > 0 && ensureMotorReady(rightId, s_trimInitRightId, s_autoZeroedRightId)) {
+                if (rightId > 0 && ensureMotorReady(rightId, s_rightInit, s_autoZeroedRightId)) {
                     g_trimTargetRight -= TRIM_STEP_RAD;
                     sendMotorPosition(rightId, -g_trimTargetRight);
                     LOG_INFO("Trim", "Right motor (ID %d) target: %.3f rad", rightId, g_trimTargetRight);
@@ -461,19 +444,41 @@ static void processTrim() {
             LOG_INFO("Trim", "Set mechanical zero on right motor (ID %d)", rightId);
         }
 
-        // Give the motors time to process the zero-set before sending position
-        delay(250);
+        // The hold-at-zero command goes out once the motors confirm the new
+        // zero (see below) instead of stalling the loop here.
+        s_sysZeroPending = true;
+        s_sysZeroMs = now;
+        s_lastSysMs = now;
+    }
 
-        // Command motors to hold at position 0 (the new zero)
-        if (leftId > 0) {
-            sendMotorPosition(leftId, 0.0f);
-        }
-        if (rightId > 0) {
-            sendMotorPosition(rightId, 0.0f);
+    // --- Sys button follow-up: hold at the new zero once acknowledged ---
+    if (s_sysZeroPending) {
+        bool leftDone = (leftId == 0);
+        bool rightDone = (rightId == 0);
+        for (int i = 0; i < g_motorManager.getMotorCount(); i++) {
+            uint8_t id = g_motorManager.getMotorId(i);
+            const RobstrideMotorStatus& status = g_motorManager.getMotorStatus(i);
+            bool zeroed = (now - status.lastUpdateMs < now - s_sysZeroMs) &&
+                          fabsf(status.position) < MOTOR_INIT_ZERO_TOL_RAD;
+            if (id == leftId && zeroed) {
+                leftDone = true;
+            }
+            if (id == rightId && zeroed) {
+                rightDone = true;
+            }
         }
 
-        s_lastSysMs = now;
-        LOG_INFO("Trim", "All position state reset to zero.");
+        if ((leftDone && rightDone) || now - s_sysZeroMs >= SYS_ZERO_SETTLE_MS) {
+            // Command motors to hold at position 0 (the new zero)
+            if (leftId > 0) {
+                sendMotorPosition(leftId, 0.0f);
+            }
+            if (rightId > 0) {
+                sendMotorPosition(rightId, 0.0f);
+            }
+            s_sysZeroPending = false;
+            LOG_INFO("Trim", "All position state reset to zero (%lu ms).", now - s_sysZeroMs);
+        }
     }
 }
 
@@ -481,67 +486,52 @@ static void processTrim() {
 // IMU update -- 100Hz polling, pitch angle, upside-down detection
 // ---------------------------------------------------------------------------
 static void updateIMU() {
-    unsigned long now = millis();
-    if (now - s_lastImuMs < IMU_UPDATE_MS) {
-        return;
-    }
-    s_lastImuMs = now;
-
-    M5.Imu.update();
-    auto data = M5.Imu.getImuData();
-
-    // Axis mapping (from empirical data):
-    //   X = vertical (gravity): +1g level, -1g upside-down
-    //   Y = forward:            -1g nose-up, +1g nose-down
-    //   Z = lateral (roll):     +1g left-side-down
-
-    // Pitch angle: 0 = level, negative = nose tilting down, +90 = nose up, -90 = nose down
-    s_pitchAngle = atan2f(-data.accel.y, data.accel.x);
-
-    // Store gyro pitch rate for PID D-term
-    // Pitch rotation is around the Z axis (lateral axis)
-    // Convert from degrees/s to radians/s
-    s_gyroPitchRate = data.gyro.z * (PI / 180.0f);
-
-    // Upside-down detection with hysteresis using accel.x (gravity axis)
-    // If accel.x has opposite sign from reference AND exceeds threshold -> upside down
-    // If same sign AND exceeds threshold -> right side up
-    // Otherwise hold previous value
-    if ((data.accel.x * s_referenceAccelX) < 0.0f && fabsf(data.accel.x) > IMU_FLIP_THRESHOLD) {
-        g_isUpsideDown = true;
-    } else if ((data.accel.x * s_referenceAccelX) > 0.0f && fabsf(data.accel.x) > IMU_FLIP_THRESHOLD) {
-        g_isUpsideDown = false;
-    }
-    // else: hold previous value (hysteresis in the dead zone)
-
-    // Periodic IMU telemetry log (every 500ms)
-    static unsigned long s_lastImuLogMs = 0;
-    if (now - s_lastImuLogMs >= 500) {
-        s_lastImuLogMs = now;
-        float pitchDeg = s_pitchAngle * (180.0f / PI);
-        LOG_INFO("IMU", "pitch=%.1f deg  accel=(%.2f,%.2f,%.2f)  gyro=(%.1f,%.1f,%.1f)  flip=%s",
-                 pitchDeg,
-                 data.accel.x, data.accel.y, data.accel.z,
-                 data.gyro.x, data.gyro.y, data.gyro.z,
-                 g_isUpsideDown ? "YES" : "no");
-    }
+    // IMU read, pitch and flip detection run on the balance task; take the
+    // latest snapshot for this loop iteration.
+    BalanceState imu = g_balanceManager.getState();
+    s_pitchAngle = imu.pitch;
+    s_gyroPitchRate = imu.gyroPitchRate;
+    s_isUpsideDown = imu.upsideDown;
 }
 
 // Forward declaration (defined below processStickControl)
 static void commandArms(float leftTarget, float rightTarget);
 
 // ---------------------------------------------------------------------------
-// Helper: send position command to a single motor, always including speed.
+// Helper: send position command to a single motor, including speed if needed.
 // In POSITION_PP mode the motor's trajectory planner uses PP_SPEED (0x7024)
 // to cap the velocity during profiled moves. LIMIT_SPD (0x7017) is a general
 // safety limit and does NOT control the PP profiler speed.
-// We write PP_SPEED before every position command so the user's speed setting
-// is always respected, even after a motor fault/reconnect.
+// MotorManager caches the last PP_SPEED/LOC_REF written per motor and only
+// resends what changed; the cache is dropped on stop/zero/fault/reconnect, so
+// the user's speed setting is still re-applied after a motor re-init.
 // ---------------------------------------------------------------------------
 static void sendMotorPosition(uint8_t motorId, float position) {
-    float spd = g_settingsManager.getMotorSpeedLimit();
-    g_motorManager.writeFloatParam(motorId, RobstrideParam::PP_SPEED, spd);
-    g_motorManager.writeFloatParam(motorId, RobstrideParam::LOC_REF, position);
+    MotorManager::PositionCommand cmd = { motorId, position };
+    g_motorManager.sendPositionBatch(&cmd, 1, g_settingsManager.getMotorSpeedLimit());
+}
+
+// ---------------------------------------------------------------------------
+// Helper: send target-space positions to both arms as one back-to-back batch.
+// Motors that aren't assigned (ID 0) or can't be made ready are skipped.
+// ---------------------------------------------------------------------------
+static void sendArmPositions(uint8_t leftId, float leftTarget, uint8_t rightId, float rightTarget) {
+    MotorManager::PositionCommand cmds[2];
+    int count = 0;
+    if (leftId > 0 && ensureMotorReady(leftId, s_leftInit, s_autoZeroedLeftId)) {
+        cmds[count].motorId = leftId;
+        cmds[count].position = leftTarget;
+        count++;
+    }
+    if (rightId > 0 && ensureMotorReady(rightId, s_rightInit, s_autoZeroedRightId)) {
+        // Right motor is negated
+        cmds[count].motorId = rightId;
+        cmds[count].position = -rightTarget;
+        count++;
+    }
+    if (count > 0) {
+        g_motorManager.sendPositionBatch(cmds, count, g_settingsManager.getMotorSpeedLimit());
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -626,6 +616,16 @@ static void processGroundSlap() {
 // L1 button:    cycle through home presets (Front, Up, Back, L-Front/R-Back)
 // R2 trigger:   interpolate from home position to trigger target
 // ---------------------------------------------------------------------------
+// Latency trace: first arm command issued from a new controller report
+// (sendMessage() queues the frames for the TWAI driver right away)
+static void traceArmCommand(const ControllerState& state) {
+    if (state.inputRxUs == 0 || state.inputRxUs == s_canTracedRxUs) {
+        return;
+    }
+    s_canTracedRxUs = state.inputRxUs;
+    g_profiler.record(PROF_STAGE_IN_CAN, (uint32_t)esp_timer_get_time() - state.inputRxUs);
+}
+
 static void processStickControl() {
     const ControllerState& state = g_controllerManager.getState(0);
     if (!state.connected) {
@@ -737,16 +737,8 @@ static void processStickControl() {
 
     // If a position-mode button is held, command arms directly and skip stick control
     if (btnPosHeld) {
-        if (leftId > 0) {
-            if (ensureMotorReady(leftId, s_trimInitLeftId, s_autoZeroedLeftId)) {
-                sendMotorPosition(leftId, btnPosLeft);
-            }
-        }
-        if (rightId > 0) {
-            if (ensureMotorReady(rightId, s_trimInitRightId, s_autoZeroedRightId)) {
-                sendMotorPosition(rightId, -btnPosRight);
-            }
-        }
+        sendArmPositions(leftId, btnPosLeft, rightId, btnPosRight);
+        traceArmCommand(state);
         return;
     }
 
@@ -806,35 +798,81 @@ static void processStickControl() {
     float rightTarget = homeRightPos + s_basePosition - difference / 2.0f + g_trimTargetRight + s_zeroOffset;
 
     // Ensure motors are ready and send position + speed commands
-    if (leftId > 0) {
-        if (ensureMotorReady(leftId, s_trimInitLeftId, s_autoZeroedLeftId)) {
-            sendMotorPosition(leftId, leftTarget);
-        }
-    }
-    if (rightId > 0) {
-        if (ensureMotorReady(rightId, s_trimInitRightId, s_autoZeroedRightId)) {
-            sendMotorPosition(rightId, -rightTarget);
-        }
-    }
+    sendArmPositions(leftId, leftTarget, rightId, rightTarget);
+    traceArmCommand(state);
 }
 
 // ---------------------------------------------------------------------------
 // Helper: command both arm motors to target positions (target space)
 // ---------------------------------------------------------------------------
+// Last target-space positions sent by commandArms() (resent after a
+// deferred run-mode switch)
+static float s_armTargetLeft = 0.0f;
+static float s_armTargetRight = 0.0f;
+
 static void commandArms(float leftTarget, float rightTarget) {
-    uint8_t leftId = resolveLeftMotorId();
-    uint8_t rightId = resolveRightMotorId();
-    if (leftId > 0) {
-        if (ensureMotorReady(leftId, s_trimInitLeftId, s_autoZeroedLeftId)) {
-            sendMotorPosition(leftId, leftTarget);
+    s_armTargetLeft = leftTarget;
+    s_armTargetRight = rightTarget;
+    sendArmPositions(resolveLeftMotorId(), leftTarget, resolveRightMotorId(), rightTarget);
+}
+
+// ---------------------------------------------------------------------------
+// MIT streaming for the balance loop
+// ---------------------------------------------------------------------------
+// While balancing, the arms run in OPERATION_CONTROL: each tick is a single
+// MOTION_CONTROL frame per arm (no PP_SPEED/LOC_REF pair, no trajectory
+// planner in the way) and the motor's reply doubles as its status update.
+// The frames themselves are sent by the balance task (balance_manager.cpp).
+// Everywhere else the arms stay in POSITION_PP.
+//
+// A switch only counts once setRunMode() has queued it. If the TX ring is
+// full the arm keeps its old mode, and retryArmsMode() tries again from the
+// next loop() iteration.
+static bool s_armsMitWanted = false;            // Mode the arms should be in
+static bool s_armsEnergize = true;              // Enable after switching (false: leave stopped)
+static bool s_armInMit[2] = {false, false};     // Mode each arm was switched to (L, R)
+
+// Queue the switch for every arm not yet in the wanted mode.
+// Returns true once both arms are in it.
+static bool applyArmsMode() {
+    uint8_t mode = s_armsMitWanted ? RobstrideMode::OPERATION_CONTROL : RobstrideMode::POSITION_PP;
+    uint8_t ids[2] = {resolveLeftMotorId(), resolveRightMotorId()};
+    bool settled = true;
+    for (int i = 0; i < 2; i++) {
+        if (s_armInMit[i] == s_armsMitWanted) {
+            continue;
         }
-    }
-    if (rightId > 0) {
-        if (ensureMotorReady(rightId, s_trimInitRightId, s_autoZeroedRightId)) {
-            // Right motor is negated
-            sendMotorPosition(rightId, -rightTarget);
+        if (ids[i] == 0 || g_motorManager.setRunMode(ids[i], mode, s_armsEnergize)) {
+            s_armInMit[i] = s_armsMitWanted;
+        } else {
+            settled = false;
         }
     }
+    return settled;
+}
+
+// Request a run mode for both arms. energize = false leaves them stopped in
+// the new mode (controller lost). Returns true once both arms have switched;
+// false means part of the switch is still pending.
+static bool setArmsMitMode(bool enable, bool energize = true) {
+    s_armsEnergize = energize;
+    if (s_armsMitWanted != enable) {
+        s_armsMitWanted = enable;
+        LOG_INFO("NoseDown", "Arms -> %s%s", enable ? "MIT streaming" : "position PP",
+                 energize ? "" : " (stopped)");
+    }
+    return applyArmsMode();
+}
+
+// Finish a switch that setArmsMitMode() could not queue. The stop in the
+// switch drops the PP setpoint, so the last arm targets are resent.
+static void retryArmsMode() {
+    if (s_armInMit[0] == s_armsMitWanted && s_armInMit[1] == s_armsMitWanted) {
+        return;
+    }
+    if (applyArmsMode() && !s_armsMitWanted && s_armsEnergize) {
+        commandArms(s_armTargetLeft, s_armTargetRight);
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -905,13 +943,17 @@ static void processSelfRight() {
 // Nose-down PID balance state machine (X button)
 // ---------------------------------------------------------------------------
 static void processNoseDown() {
+    retryArmsMode();
+
     const ControllerState& state = g_controllerManager.getState(0);
     if (!state.connected) {
-        // If controller lost during nose-down, abort
+        // If controller lost during nose-down, abort. processTrim() has
+        // already stopped the arms; switch them back to PP without
+        // re-enabling, so they stay slack.
         if (s_noseDownState != ND_IDLE) {
+            g_balanceManager.stopBalancing();
+            setArmsMitMode(false, false);
             s_noseDownState = ND_IDLE;
-            s_pidIntegral = 0.0f;
-            s_pidPrevError = 0.0f;
             LOG_INFO("NoseDown", "Aborted -- controller lost");
         }
         return;
@@ -927,7 +969,7 @@ static void processNoseDown() {
     switch (s_noseDownState) {
         case ND_IDLE: {
             if (xPressed) {
-                if (g_isUpsideDown) {
+                if (s_isUpsideDown) {
                     // Need to self-right first before tipping
                     commandArms(SELF_RIGHT_PREP_POS, SELF_RIGHT_PREP_POS);
                     s_ndSrSub = NDSR_PREP;
@@ -997,12 +1039,17 @@ static void processNoseDown() {
             if (pitchDeg > ND_PITCH_ENGAGED_DEG) {
                 s_pitchConfirmCount++;
                 if (s_pitchConfirmCount >= ND_PITCH_CONFIRM_COUNT) {
-                    // Confirmed! Start PID balance (arms only, no drive)
+                    // Confirmed! Start PID balance (arms only, no drive).
+                    // If an arm could not be switched to MIT, roll back to PP
+                    // at the tip pose and try again on the next tick.
+                    if (!setArmsMitMode(true)) {
+                        setArmsMitMode(false);
+                        commandArms(ND_TIP_LEFT, ND_TIP_RIGHT);
+                        LOG_WARN("NoseDown", "MIT switch deferred (CAN TX full), retrying");
+                        break;
+                    }
                     s_balanceStartMs = now;
-                    s_lastRampMs = now;
-                    s_rampProgress = 0.0f;
-                    s_pidIntegral = 0.0f;
-                    s_pidPrevError = 0.0f;
+                    g_balanceManager.startBalancing(resolveLeftMotorId(), resolveRightMotorId());
                     s_noseDownState = ND_BALANCING;
                     LOG_INFO("NoseDown", "Pitch %.1f deg confirmed -- PID engaged, ramping arms slowly", pitchDeg);
                 }
@@ -1013,6 +1060,7 @@ static void processNoseDown() {
 
             if (tipElapsed >= ND_TIP_TIMEOUT_MS) {
                 // Timeout -- couldn't reach balance, abort
+                setArmsMitMode(false);
                 commandArms(0.0f, 0.0f);
                 s_homePresetIndex = 0;
                 s_basePosition = 0.0f;
@@ -1030,12 +1078,11 @@ static void processNoseDown() {
                 float noseDownDeg = -s_pitchAngle * (180.0f / PI);  // positive when nose is down
                 if (noseDownDeg < ND_PITCH_LOST_DEG) {
                     LOG_INFO("NoseDown", "Lost balance (noseDown=%.1f deg) -- re-entering tipping", noseDownDeg);
+                    g_balanceManager.stopBalancing();
+                    setArmsMitMode(false);
                     commandArms(ND_TIP_LEFT, ND_TIP_RIGHT);
                     s_noseDownMs = now;
                     s_pitchConfirmCount = 0;
-                    s_rampProgress = 0.0f;
-                    s_pidIntegral = 0.0f;
-                    s_pidPrevError = 0.0f;
                     s_noseDownState = ND_TIPPING;
                     break;
                 }
@@ -1044,99 +1091,19 @@ static void processNoseDown() {
             // Check for X press to exit
             if (xPressed) {
                 // Capture current arm positions for smooth exit ramp
-                s_exitStartLeft  = ND_TIP_LEFT  + (ND_BALANCE_LEFT  - ND_TIP_LEFT)  * s_rampProgress;
-                s_exitStartRight = ND_TIP_RIGHT + (ND_BALANCE_RIGHT - ND_TIP_RIGHT) * s_rampProgress;
+                g_balanceManager.stopBalancing();
+                float rampProgress = g_balanceManager.getState().rampProgress;
+                s_exitStartLeft  = ND_TIP_LEFT  + (ND_BALANCE_LEFT  - ND_TIP_LEFT)  * rampProgress;
+                s_exitStartRight = ND_TIP_RIGHT + (ND_BALANCE_RIGHT - ND_TIP_RIGHT) * rampProgress;
 
+                setArmsMitMode(false);
                 s_noseDownMs = now;
                 s_noseDownState = ND_EXITING;
-                s_pidIntegral = 0.0f;
-                s_pidPrevError = 0.0f;
-                LOG_INFO("NoseDown", "Exiting -- sweeping arms to Front (ramp was %.0f%%)", s_rampProgress * 100.0f);
+                LOG_INFO("NoseDown", "Exiting -- sweeping arms to Front (ramp was %.0f%%)", rampProgress * 100.0f);
                 break;
             }
 
-            // Pitch-gated ramp: only advance when pitch error is small
-            {
-                float errorDeg = fabsf(ND_PITCH_SETPOINT - s_pitchAngle) * (180.0f / PI);
-                float rampDt = (float)(now - s_lastRampMs) / (float)ND_ARM_RAMP_MS;
-                s_lastRampMs = now;
-                if (errorDeg < ND_RAMP_ERROR_GATE_DEG) {
-                    // Pitch is close to setpoint -- advance ramp
-                    s_rampProgress += rampDt;
-                    if (s_rampProgress > 1.0f) { s_rampProgress = 1.0f; }
-                }
-                // else: pitch error too large, freeze ramp and let PID stabilize
-            }
-            float nominalLeft  = ND_TIP_LEFT  + (ND_BALANCE_LEFT  - ND_TIP_LEFT)  * s_rampProgress;
-            float nominalRight = ND_TIP_RIGHT + (ND_BALANCE_RIGHT - ND_TIP_RIGHT) * s_rampProgress;
-
-            // Compute world-frame angles from vertical for gain scheduling
-            float phiL = -(nominalLeft + PI);
-            float phiR = -(nominalRight + PI);
-            float sensL = -cosf(phiL);
-            float sensR = -cosf(phiR);
-            float totalSens = sensL + sensR;
-
-            // PID error
-            float error = ND_PITCH_SETPOINT - s_pitchAngle;
-            float dt = IMU_UPDATE_MS / 1000.0f;
-
-            // Integral with anti-windup
-            s_pidIntegral += error * dt;
-            if (s_pidIntegral > ND_PID_INTEGRAL_LIMIT) {
-                s_pidIntegral = ND_PID_INTEGRAL_LIMIT;
-            }
-            if (s_pidIntegral < -ND_PID_INTEGRAL_LIMIT) {
-                s_pidIntegral = -ND_PID_INTEGRAL_LIMIT;
-            }
-
-            // Derivative from gyro pitch rate (cleaner than differentiating accel)
-            float derivative = -s_gyroPitchRate;
-
-            // PID output
-            float pidOut = ND_PID_KP * error + ND_PID_KI * s_pidIntegral + ND_PID_KD * derivative;
-            if (pidOut > ND_PID_OUTPUT_LIMIT) { pidOut = ND_PID_OUTPUT_LIMIT; }
-            if (pidOut < -ND_PID_OUTPUT_LIMIT) { pidOut = -ND_PID_OUTPUT_LIMIT; }
-
-            s_pidPrevError = error;
-
-            // Gain-scheduled offset distribution
-            float leftTarget = nominalLeft;
-            float rightTarget = nominalRight;
-
-            if (fabsf(totalSens) > ND_MIN_SENSITIVITY) {
-                // Uniform mode: both arms move same direction, scaled by total sensitivity
-                float offset = pidOut / totalSens;
-                // Hard clamp to prevent arm position explosions near low-sensitivity zones
-                if (offset > ND_MAX_ARM_OFFSET) { offset = ND_MAX_ARM_OFFSET; }
-                if (offset < -ND_MAX_ARM_OFFSET) { offset = -ND_MAX_ARM_OFFSET; }
-                leftTarget  = nominalLeft  + offset;
-                rightTarget = nominalRight + offset;
-            } else {
-                // Differential mode: arms on opposite sides of zero-crossing
-                float diffSens = sensL - sensR;
-                if (fabsf(diffSens) > ND_MIN_SENSITIVITY) {
-                    float diffOffset = pidOut / diffSens;
-                    // Hard clamp to prevent arm position explosions
-                    if (diffOffset > ND_MAX_ARM_OFFSET) { diffOffset = ND_MAX_ARM_OFFSET; }
-                    if (diffOffset < -ND_MAX_ARM_OFFSET) { diffOffset = -ND_MAX_ARM_OFFSET; }
-                    leftTarget  = nominalLeft  + diffOffset;
-                    rightTarget = nominalRight - diffOffset;
-                }
-                // else: both sensitivities near zero, just follow ramp
-            }
-
-            commandArms(leftTarget, rightTarget);
-
-            // Periodic PID telemetry (every 250ms)
-            static unsigned long s_lastBalLogMs = 0;
-            if (now - s_lastBalLogMs >= 250) {
-                s_lastBalLogMs = now;
-                float pitchDeg = s_pitchAngle * (180.0f / PI);
-                LOG_INFO("NoseDown", "BAL: pitch=%.1f err=%.2f pid=%.2f ramp=%.0f%% nomL=%.2f nomR=%.2f armL=%.2f armR=%.2f sens=%.2f",
-                         pitchDeg, error, pidOut, s_rampProgress * 100.0f,
-                         nominalLeft, nominalRight, leftTarget, rightTarget, totalSens);
-            }
+            // Ramp, PID and MIT streaming run on the balance task
             break;
         }
 
@@ -1179,57 +1146,142 @@ static void processNoseDown() {
 }
 
 // ---------------------------------------------------------------------------
-// Loop timing instrumentation
+// Loop timing log -- per-stage avg/max over the last PROFILER_LOG_MS, drained
+// from the profiler's window counters (full histograms are at /metrics)
 // ---------------------------------------------------------------------------
-static unsigned long s_loopCount = 0;
 static unsigned long s_lastTimingLog = 0;
-static unsigned long s_totalLoopUs = 0;
-static unsigned long s_maxLoopUs = 0;
-static unsigned long s_totalM5Us = 0;
-static unsigned long s_totalCtrlUs = 0;
-static unsigned long s_totalWifiUs = 0;
-static unsigned long s_totalDisplayUs = 0;
-static unsigned long s_totalMotorUs = 0;
+
+static void logLoopTiming(unsigned long elapsedMs) {
+    ProfileWindow loopWin = g_profiler.takeWindow(PROF_STAGE_LOOP);
+    if (loopWin.count == 0) {
+        return;
+    }
+    unsigned long hz = ((unsigned long)loopWin.count * 1000) / elapsedMs;
+    LOG_INFO("Main", "Loop: %lu Hz, avg=%lu us, max=%lu us, n=%lu",
+             hz, (unsigned long)(loopWin.sumUs / loopWin.count),
+             (unsigned long)loopWin.maxUs, (unsigned long)loopWin.count);
+
+    // "name=avg/max" for every stage that ran in the window
+    char line[256];
+    int len = 0;
+    for (int i = PROF_STAGE_LOOP + 1; i < PROF_STAGE_COUNT; i++) {
+        ProfileStage stage = (ProfileStage)i;
+        ProfileWindow w = g_profiler.takeWindow(stage);
+        if (w.count == 0 || len >= (int)sizeof(line)) {
+            continue;
+        }
+        len += snprintf(line + len, sizeof(line) - len, " %s=%lu/%lu",
+                        Profiler::stageName(stage),
+                        (unsigned long)(w.sumUs / w.count), (unsigned long)w.maxUs);
+    }
+    LOG_INFO("Main", "  Stages avg/max us:%s", len > 0 ? line : " --");
+}
+
+// ---------------------------------------------------------------------------
+// Display snapshot
+// ---------------------------------------------------------------------------
+// Captures what the display shows and hands it to the display task. Called
+// once per loop tick; the WiFi/heap fields change slowly and cost a driver
+// call each, so they are refreshed only at the display rate.
+static void publishDisplaySnapshot() {
+    static DisplaySnapshot s_snap;
+    static unsigned long s_lastSystemMs = 0;
+
+    unsigned long now = millis();
+    s_snap.timeMs = (uint32_t)now;
+
+    if (s_lastSystemMs == 0 || now - s_lastSystemMs >= DISPLAY_UPDATE_MS) {
+        s_lastSystemMs = now;
+        s_snap.wifiConnected = g_wifiManager.isConnected();
+        s_snap.rssi = (int8_t)g_wifiManager.getRSSI();
+        g_wifiManager.formatIP(s_snap.ip, sizeof(s_snap.ip));
+        s_snap.freeHeap = ESP.getFreeHeap();
+    }
+
+    s_snap.controllerCount = (int8_t)g_controllerManager.getConnectedCount();
+    s_snap.hasController = false;
+    for (int i = 0; i < CONTROLLER_MAX_COUNT; i++) {
+        const ControllerState& state = g_controllerManager.getState(i);
+        if (state.connected) {
+            s_snap.controller = state;
+            s_snap.hasController = true;
+            break;
+        }
+    }
+
+    int motorCount = g_motorManager.getMotorCount();
+    s_snap.motorCount = (int8_t)motorCount;
+    s_snap.canRunning = g_motorManager.isRunning();
+    for (int i = 0; i < 2 && i < motorCount; i++) {
+        s_snap.motorIds[i] = g_motorManager.getMotorId(i);
+        s_snap.motors[i] = g_motorManager.getMotorStatus(i);
+        strncpy(s_snap.motorRoles[i], g_motorManager.getRoleLabel(s_snap.motorIds[i]),
+                sizeof(s_snap.motorRoles[i]) - 1);
+    }
+    s_snap.leftMotorId = g_motorManager.getLeftMotorId();
+    s_snap.rightMotorId = g_motorManager.getRightMotorId();
+    s_snap.trimLeft = g_trimTargetLeft;
+    s_snap.trimRight = g_trimTargetRight;
+
+    DriveOutputs drive = g_driveManager.getOutputs();
+    s_snap.leftPulse = drive.leftPulseUs;
+    s_snap.rightPulse = drive.rightPulseUs;
+
+    g_displayManager.publish(s_snap);
+}
 
 // ---------------------------------------------------------------------------
 // Arduino loop - runs repeatedly on CPU1
 // ---------------------------------------------------------------------------
 void loop() {
-    unsigned long loopStart = micros();
-    unsigned long t0, t1;
+    uint32_t loopStartUs = (uint32_t)esp_timer_get_time();
 
     // Update M5 button states
-    t0 = micros();
-    M5.update();
-    t1 = micros();
-    s_totalM5Us += (t1 - t0);
+    {
+        PROFILE_SCOPE(PROF_STAGE_M5);
+        M5.update();
+    }
 
     // 1. Poll Bluepad32 for controller input
-    t0 = micros();
-    g_controllerManager.update();
-    t1 = micros();
-    s_totalCtrlUs += (t1 - t0);
+    {
+        PROFILE_SCOPE(PROF_STAGE_CTRL);
+        g_controllerManager.update();
+    }
 
     // (Drive runs on its own FreeRTOS task on CPU0 -- no update() call needed)
 
-    // 1a. Update IMU: pitch angle, upside-down detection (100Hz internally rate-limited)
-    updateIMU();
+    // 1a. Take the latest IMU snapshot from the balance task (pitch, flip)
+    {
+        PROFILE_SCOPE(PROF_STAGE_IMU);
+        updateIMU();
+    }
 
     // 1a2. Push inversion flag to drive task
-    g_driveManager.setInverted(g_isUpsideDown);
+    g_driveManager.setInverted(s_isUpsideDown);
 
-    // 1b. Process motor trim (d-pad nudge + Sys zero)
-    processTrim();
+    // 1b. Process motor trim (d-pad nudge + Sys zero). Only the controller-lost
+    // stop runs while self-righting or nose-down is active.
+    {
+        PROFILE_SCOPE(PROF_STAGE_TRIM);
+        processTrim();
+    }
 
     // 1b2. Process self-righting (Select button)
-    processSelfRight();
+    {
+        PROFILE_SCOPE(PROF_STAGE_SELF_RIGHT);
+        processSelfRight();
+    }
 
     // 1b3. Process nose-down balance (X button)
-    processNoseDown();
+    {
+        PROFILE_SCOPE(PROF_STAGE_NOSE_DOWN);
+        processNoseDown();
+    }
 
     // 1c. Process left stick motor control (jog + difference)
     // Skipped when self-righting or nose-down mode is active to prevent interference
     if (s_selfRightState == SR_IDLE && s_noseDownState == ND_IDLE) {
+        PROFILE_SCOPE(PROF_STAGE_STICK);
         processStickControl();
     }
 
@@ -1241,36 +1293,41 @@ void loop() {
         uint8_t leftId = resolveLeftMotorId();
         uint8_t rightId = resolveRightMotorId();
         if (leftId > 0) {
-            g_motorManager.writeFloatParam(leftId, RobstrideParam::PP_SPEED, newSpd);
-            g_motorManager.writeFloatParam(leftId, RobstrideParam::PP_ACCELERATION, newAccel);
-            g_motorManager.writeFloatParam(leftId, RobstrideParam::LIMIT_CUR, newCur);
-            g_motorManager.writeFloatParam(leftId, RobstrideParam::LIMIT_SPD, newSpd);
+            g_motorManager.writeFloatParamCached(leftId, RobstrideParam::PP_SPEED, newSpd);
+            g_motorManager.writeFloatParamCached(leftId, RobstrideParam::PP_ACCELERATION, newAccel);
+            g_motorManager.writeFloatParamCached(leftId, RobstrideParam::LIMIT_CUR, newCur);
+            g_motorManager.writeFloatParamCached(leftId, RobstrideParam::LIMIT_SPD, newSpd);
         }
         if (rightId > 0) {
-            g_motorManager.writeFloatParam(rightId, RobstrideParam::PP_SPEED, newSpd);
-            g_motorManager.writeFloatParam(rightId, RobstrideParam::PP_ACCELERATION, newAccel);
-            g_motorManager.writeFloatParam(rightId, RobstrideParam::LIMIT_CUR, newCur);
-            g_motorManager.writeFloatParam(rightId, RobstrideParam::LIMIT_SPD, newSpd);
+            g_motorManager.writeFloatParamCached(rightId, RobstrideParam::PP_SPEED, newSpd);
+            g_motorManager.writeFloatParamCached(rightId, RobstrideParam::PP_ACCELERATION, newAccel);
+            g_motorManager.writeFloatParamCached(rightId, RobstrideParam::LIMIT_CUR, newCur);
+            g_motorManager.writeFloatParamCached(rightId, RobstrideParam::LIMIT_SPD, newSpd);
         }
         LOG_INFO("Main", "Motor params pushed: spd=%.1f accel=%.1f cur=%.1f", newSpd, newAccel, newCur);
     }
 
-    // Update web-accessible state copies
-    g_pitchAngleForWeb = s_pitchAngle;
-    g_selfRightStateForWeb = (int)s_selfRightState;
-    g_noseDownStateForWeb = (int)s_noseDownState;
+    // Publish state for the web server and telemetry
+    RobotStatus status;
+    status.pitch = s_pitchAngle;
+    status.upsideDown = s_isUpsideDown;
+    status.selfRightState = (uint8_t)s_selfRightState;
+    status.noseDownState = (uint8_t)s_noseDownState;
+    g_robotStatus.store(status);
 
     // 2. Poll CAN bus for motor feedback
-    t0 = micros();
-    g_motorManager.poll();
-    t1 = micros();
-    s_totalMotorUs += (t1 - t0);
+    {
+        PROFILE_SCOPE(PROF_STAGE_MOTOR);
+        g_motorManager.poll();
+        s_leftInit.update();
+        s_rightInit.update();
+    }
 
     // 3. Maintain WiFi connection (handles reconnect)
-    t0 = micros();
-    g_wifiManager.loop();
-    t1 = micros();
-    s_totalWifiUs += (t1 - t0);
+    {
+        PROFILE_SCOPE(PROF_STAGE_WIFI);
+        g_wifiManager.loop();
+    }
 
     // 4. Start web server once WiFi connects for the first time
     if (!s_webServerStarted && g_wifiManager.isConnected()) {
@@ -1279,26 +1336,24 @@ void loop() {
         LOG_INFO("Main", "Web dashboard: http://%s/", g_wifiManager.getIP().c_str());
     }
 
-    // 5. Update the display (rate-limited internally)
-    t0 = micros();
-    g_displayManager.update();
-    t1 = micros();
-    s_totalDisplayUs += (t1 - t0);
+    // 5. Hand the display task this tick's state (it renders on CPU0)
+    {
+        PROFILE_SCOPE(PROF_STAGE_DISPLAY);
+        publishDisplaySnapshot();
+    }
 
     // ---------------------------------------------------------------------------
-    // Periodic motor speed parameter readback (debug)
-    // Cycles through reading PP_SPEED and LIMIT_SPD from each motor every 5s.
-    // Results are stored in RobstrideMotorStatus and logged.
+    // Periodic motor tuning parameter readback (debug)
+    // Every 5s, requests PP_SPEED, PP_ACCEL, LIMIT_SPD, LIMIT_CUR and RUN_MODE
+    // from both arms in one burst (all reads are in flight at once).
+    // Results are stored in RobstrideMotorStatus and logged. Reads that can't
+    // be queued (table/ring full, still in flight) are picked up next round.
     // ---------------------------------------------------------------------------
     {
-        static unsigned long s_lastSpeedReadMs = 0;
-        static int s_paramReadStep = 0;
+        static unsigned long s_lastParamReadMs = 0;
         unsigned long now2 = millis();
-        if (now2 - s_lastSpeedReadMs >= 5000 && !g_motorManager.isParamReadPending()) {
-            uint8_t leftId = resolveLeftMotorId();
-            uint8_t rightId = resolveRightMotorId();
-            bool sent = false;
-            // Params to read per motor: PP_SPEED, PP_ACCEL, LIMIT_SPD, LIMIT_CUR, RUN_MODE
+        if (now2 - s_lastParamReadMs >= 5000) {
+            s_lastParamReadMs = now2;
             static const uint16_t paramsPerMotor[] = {
                 RobstrideParam::PP_SPEED,
                 RobstrideParam::PP_ACCELERATION,
@@ -1306,73 +1361,43 @@ void loop() {
                 RobstrideParam::LIMIT_CUR,
                 RobstrideParam::RUN_MODE
             };
-            static const int PARAMS_PER_MOTOR = 5;
-            static const int STEP_COUNT = PARAMS_PER_MOTOR * 2;  // left + right
-            for (int attempt = 0; attempt < STEP_COUNT && !sent; attempt++) {
-                int step = (s_paramReadStep + attempt) % STEP_COUNT;
-                uint8_t mId = (step < PARAMS_PER_MOTOR) ? leftId : rightId;
-                uint16_t param = paramsPerMotor[step % PARAMS_PER_MOTOR];
-                if (mId > 0) {
-                    sent = g_motorManager.requestParamRead(mId, param);
-                    if (sent) {
-                        s_paramReadStep = (step + 1) % STEP_COUNT;
-                        s_lastSpeedReadMs = now2;
-                    }
-                } else {
-                    s_paramReadStep = (step + 1) % STEP_COUNT;
+            const uint8_t armIds[2] = { resolveLeftMotorId(), resolveRightMotorId() };
+            for (int m = 0; m < 2; m++) {
+                if (armIds[m] == 0) {
+                    continue;
+                }
+                for (uint16_t param : paramsPerMotor) {
+                    g_motorManager.requestParamRead(armIds[m], param);
                 }
             }
         }
     }
 
-    // Measure total loop time
-    unsigned long loopUs = micros() - loopStart;
-    s_totalLoopUs += loopUs;
-    if (loopUs > s_maxLoopUs) {
-        s_maxLoopUs = loopUs;
-    }
-    s_loopCount++;
+    // Measure total loop time (excluding the timing log below)
+    g_profiler.record(PROF_STAGE_LOOP, (uint32_t)esp_timer_get_time() - loopStartUs);
 
-    // Log timing every 2 seconds
+    // Log timing every PROFILER_LOG_MS
     unsigned long now = millis();
-    if (now - s_lastTimingLog >= 2000) {
-        unsigned long count = s_loopCount;
-        if (count > 0) {
-            unsigned long avgUs = s_totalLoopUs / count;
-            unsigned long hz = (count * 1000) / (now - s_lastTimingLog);
-            LOG_INFO("Main", "Loop: %lu Hz, avg=%lu us, max=%lu us, n=%lu",
-                     hz, avgUs, s_maxLoopUs, count);
-            LOG_INFO("Main", "  M5=%lu us, Ctrl=%lu us, Motor=%lu us, WiFi=%lu us, Disp=%lu us (avg)",
-                     s_totalM5Us / count, s_totalCtrlUs / count,
-                     s_totalMotorUs / count,
-                     s_totalWifiUs / count, s_totalDisplayUs / count);
-            LOG_INFO("Main", "  Controllers=%d, Motors=%d, Heap=%lu",
-                     g_controllerManager.getConnectedCount(),
-                     g_motorManager.getMotorCount(),
-                     (unsigned long)ESP.getFreeHeap());
-            // Log motor parameter readback values (debug)
-            for (int mi = 0; mi < g_motorManager.getMotorCount(); mi++) {
-                const RobstrideMotorStatus& ms = g_motorManager.getMotorStatus(mi);
-                uint8_t mId = g_motorManager.getMotorId(mi);
-                const char* role = g_motorManager.getRoleLabel(mId);
-                LOG_INFO("Main", "  Motor %d [%s]: ppSpd=%.1f ppAcc=%.1f limSpd=%.1f limCur=%.1f vel=%.1f",
-                         mId, role, ms.ppSpeed, ms.ppAccel, ms.limitSpd, ms.limitCur, ms.velocity);
-            }
+    if (now - s_lastTimingLog >= PROFILER_LOG_MS) {
+        logLoopTiming(now - s_lastTimingLog);
+        LOG_INFO("Main", "  Controllers=%d, Motors=%d, Heap=%lu",
+                 g_controllerManager.getConnectedCount(),
+                 g_motorManager.getMotorCount(),
+                 (unsigned long)ESP.getFreeHeap());
+        // Log motor parameter readback values (debug)
+        for (int mi = 0; mi < g_motorManager.getMotorCount(); mi++) {
+            const RobstrideMotorStatus& ms = g_motorManager.getMotorStatus(mi);
+            uint8_t mId = g_motorManager.getMotorId(mi);
+            const char* role = g_motorManager.getRoleLabel(mId);
+            LOG_INFO("Main", "  Motor %d [%s]: ppSpd=%.1f ppAcc=%.1f limSpd=%.1f limCur=%.1f vel=%.1f",
+                     mId, role, ms.ppSpeed, ms.ppAccel, ms.limitSpd, ms.limitCur, ms.velocity);
         }
-        // Reset counters
-        s_loopCount = 0;
-        s_totalLoopUs = 0;
-        s_maxLoopUs = 0;
-        s_totalM5Us = 0;
-        s_totalCtrlUs = 0;
-        s_totalWifiUs = 0;
-        s_totalDisplayUs = 0;
-        s_totalMotorUs = 0;
         s_lastTimingLog = now;
     }
 
-    // Yield to RTOS to prevent watchdog trigger.
-    // Using yield() instead of delay(1) to avoid adding 1ms of unnecessary
-    // latency per loop iteration. yield() lets other tasks run without blocking.
-    yield();
+    // Sleep until the next controller report (Bluepad32 notifies this task)
+    // or LOOP_IDLE_WAIT_MS, whichever comes first. Input is handled as soon
+    // as it lands instead of spinning through empty polls with yield(), and
+    // the timeout keeps the state machines and CAN poll ticking at ~1 kHz.
+    g_controllerManager.waitForInput(LOOP_IDLE_WAIT_MS);
 }
@@ -104,6 +104,48 @@ static const char WEB_LOG_HTML[] PROGMEM = R"rawliteral(
   .telem-val.alert { color: #f87171; }
   .telem-val.ok { color: #4ade80; }
 
+  /* Flight recorder bar */
+  .recbar {
+    background: #14161e;
+    border-bottom: 1px solid #2a2d3a;
+    padding: 6px 16px;
+    display: flex;
+    align-items: center;
+    gap: 8px;
+    font-size: 12px;
+  }
+  .recbar .rec-label { color: #6b7280; }
+  .recbar .rec-state { color: #a5b4fc; font-weight: 600; min-width: 180px; }
+  .recbar .rec-state.armed { color: #4ade80; }
+  .recbar .rec-state.triggered { color: #fbbf24; }
+
+  /* Stage latency metrics */
+  .metrics {
+    background: #14161e;
+    border-bottom: 1px solid #2a2d3a;
+    padding: 6px 16px;
+    font-size: 12px;
+  }
+  .metrics .metrics-head {
+    display: flex;
+    align-items: center;
+    gap: 8px;
+  }
+  .metrics .metrics-label { color: #6b7280; flex: 1; }
+  .metrics table {
+    border-collapse: collapse;
+    margin-top: 4px;
+  }
+  .metrics th, .metrics td {
+    padding: 1px 10px 1px 0;
+    text-align: right;
+  }
+  .metrics th { color: #6b7280; font-weight: normal; }
+  .metrics td:first-child, .metrics th:first-child { text-align: left; color: #60a5fa; }
+  .metrics td.warn { color: #fbbf24; }
+  .metrics td.alert { color: #f87171; }
+  .metrics.collapsed table { display: none; }
+
   /* Filter bar */
   .filterbar {
     background: #14161e;
@@ -129,6 +171,16 @@ static const char WEB_LOG_HTML[] PROGMEM = R"rawliteral(
     outline: none;
     border-color: #3b82f6;
   }
+  .filterbar input.narrow { width: 90px; }
+  .filterbar select {
+    background: #1a1d27;
+    border: 1px solid #3a3d4a;
+    border-radius: 4px;
+    color: #c8ccd4;
+    padding: 3px 6px;
+    font-family: inherit;
+    font-size: 12px;
+  }
 
   /* Log area */
   .log-container {
@@ -215,6 +267,43 @@ static const char WEB_LOG_HTML[] PROGMEM = R"rawliteral(
   <div class="telem-item"><span class="telem-label">Uptime:</span><span class="telem-val" id="tUptime">--</span></div>
 </div>
 
+<div class="recbar">
+  <span class="rec-label">Recorder:</span>
+  <span class="rec-state" id="recState">--</span>
+  <button class="btn" id="btnRecArm">Arm</button>
+  <button class="btn" id="btnRecTrigger">Trigger</button>
+  <button class="btn" id="btnRecStop">Stop</button>
+  <a href="/recording.bin" class="btn primary" download>Download .bin</a>
+</div>
+
+<div class="metrics collapsed" id="metrics">
+  <div class="metrics-head">
+    <span class="metrics-label" id="metricsSummary">Stage latency: --</span>
+    <button class="btn" id="btnMetrics">Show</button>
+    <button class="btn" id="btnMetricsReset">Reset</button>
+  </div>
+  <table>
+    <thead><tr><th>stage</th><th>count</th><th>p50 us</th><th>p90 us</th><th>p99 us</th><th>max us</th></tr></thead>
+    <tbody id="metricsBody"></tbody>
+  </table>
+</div>
+
+<div class="filterbar">
+  <label>Device:</label>
+  <select id="srvLevel">
+    <option value="DEBUG">all levels</option>
+    <option value="INFO">INFO+</option>
+    <option value="WARN">WARN+</option>
+    <option value="ERROR">ERROR</option>
+  </select>
+  <input type="text" class="narrow" id="srvTag" placeholder="tag" />
+  <input type="text" class="narrow" id="srvPrefix" placeholder="message prefix" />
+  <label>Last:</label>
+  <input type="text" class="narrow" id="srvLines" value="500" />
+  <button class="btn" id="btnReload">Load</button>
+  <span id="historyInfo" style="color:#6b7280"></span>
+</div>
+
 <div class="filterbar">
   <label>Filter:</label>
   <input type="text" id="filterInput" placeholder="e.g. NoseDown, PID, error..." />
@@ -232,7 +321,9 @@ static const char WEB_LOG_HTML[] PROGMEM = R"rawliteral(
 (function() {
   // State
   let logLines = [];
-  let lastSeq = 0;
+  let lastSeq = null;     // null: next poll loads the newest lines (tail)
+  let polling = false;
+  let queryGen = 0;       // Bumped on reload; stale responses are dropped
   let paused = false;
   let autoScroll = true;
   let pollCount = 0;
@@ -339,31 +430,57 @@ static const char WEB_LOG_HTML[] PROGMEM = R"rawliteral(
     }
   }
 
+  // Device-side filters (level / tag / message prefix)
+  function serverQuery() {
+    let q = '&level=' + document.getElementById('srvLevel').value;
+    let tag = document.getElementById('srvTag').value.trim();
+    let prefix = document.getElementById('srvPrefix').value;
+    if (tag) q += '&tag=' + encodeURIComponent(tag);
+    if (prefix) q += '&prefix=' + encodeURIComponent(prefix);
+    return q;
+  }
+
   async function poll() {
-    if (paused) return;
+    if (paused || polling) return;
+    polling = true;
+    let gen = queryGen;
     try {
-      let resp = await fetch('/logs?since=' + lastSeq);
+      let url;
+      if (lastSeq === null) {
+        let lines = parseInt(document.getElementById('srvLines').value) || 500;
+        url = '/logs?limit=' + lines + serverQuery();
+      } else {
+        url = '/logs?since=' + lastSeq + serverQuery();
+      }
+      let resp = await fetch(url);
       if (!resp.ok) throw new Error('HTTP ' + resp.status);
       let data = await resp.json();
       connDot.classList.add('ok');
       connText.textContent = 'Connected';
       pollErrors = 0;
+      if (gen !== queryGen) {
+        polling = false;
+        return;
+      }
 
       if (data.entries && data.entries.length > 0) {
         addLines(data.entries);
       }
-      if (data.head !== undefined) {
-        lastSeq = data.head;
+      if (data.next !== undefined) {
+        lastSeq = data.next;
       }
       updateTelemetry(data);
       pollCount++;
       pollInfoEl.textContent = 'Poll #' + pollCount + ' | seq=' + lastSeq;
+      document.getElementById('historyInfo').textContent =
+        (data.head - data.oldest) + '/' + data.capacity + ' lines on device';
     } catch(e) {
       pollErrors++;
       connDot.classList.remove('ok');
       connText.textContent = 'Error (' + pollErrors + ')';
       pollInfoEl.textContent = 'Error: ' + e.message;
     }
+    polling = false;
   }
 
   function applyFilter() {
@@ -418,15 +535,108 @@ static const char WEB_LOG_HTML[] PROGMEM = R"rawliteral(
     });
   });
 
-  document.getElementById('btnClear').addEventListener('click', function() {
+  function clearLines() {
     logLines = [];
     container.innerHTML = '';
     lineCountEl.textContent = '0 lines';
     updateFilterCount();
+  }
+
+  document.getElementById('btnClear').addEventListener('click', clearLines);
+
+  // Re-query the device history with the current device-side filters
+  document.getElementById('btnReload').addEventListener('click', function() {
+    clearLines();
+    lastSeq = null;
+    queryGen++;
+    if (!polling) poll();
   });
 
   document.getElementById('filterInput').addEventListener('input', applyFilter);
 
+  // Flight recorder
+  const recStateEl = document.getElementById('recState');
+
+  function showRecorder(r) {
+    if (!r.available) {
+      recStateEl.textContent = 'unavailable (no PSRAM)';
+      recStateEl.className = 'rec-state';
+      return;
+    }
+    let secs = (r.count * r.periodUs / 1e6).toFixed(1);
+    recStateEl.textContent = r.state + ' -- ' + r.count + '/' + r.capacity + ' (' + secs + ' s)';
+    recStateEl.className = 'rec-state ' + r.state;
+  }
+
+  async function pollRecorder() {
+    try {
+      let resp = await fetch('/recording');
+      if (resp.ok) showRecorder(await resp.json());
+    } catch(e) {}
+  }
+
+  async function recCommand(cmd) {
+    try {
+      let resp = await fetch('/recording', {
+        method: 'POST',
+        headers: { 'Content-Type': 'application/json' },
+        body: JSON.stringify({ cmd: cmd })
+      });
+      if (resp.ok) showRecorder(await resp.json());
+    } catch(e) {}
+  }
+
+  document.getElementById('btnRecArm').addEventListener('click', function() { recCommand('arm'); });
+  document.getElementById('btnRecTrigger').addEventListener('click', function() { recCommand('trigger'); });
+  document.getElementById('btnRecStop').addEventListener('click', function() { recCommand('stop'); });
+
+  setInterval(pollRecorder, 1000);
+  pollRecorder();
+
+  // Stage latency metrics
+  const metricsEl = document.getElementById('metrics');
+  const metricsBody = document.getElementById('metricsBody');
+  const metricsSummary = document.getElementById('metricsSummary');
+
+  function latencyClass(us) {
+    if (us >= 20000) return 'alert';
+    if (us >= 5000) return 'warn';
+    return '';
+  }
+
+  function showMetrics(m) {
+    let worst = null;
+    let rows = '';
+    for (let i = 0; i < m.stages.length; i++) {
+      let st = m.stages[i];
+      if (st.name !== 'loop' && (!worst || st.max > worst.max)) worst = st;
+      rows += '<tr><td>' + st.name + '</td><td>' + st.count + '</td>' +
+        '<td>' + st.p50 + '</td><td>' + st.p90 + '</td>' +
+        '<td class="' + latencyClass(st.p99) + '">' + st.p99 + '</td>' +
+        '<td class="' + latencyClass(st.max) + '">' + st.max + '</td></tr>';
+    }
+    metricsBody.innerHTML = rows;
+    let loop = m.stages[0];
+    metricsSummary.textContent = 'Stage latency: loop p99=' + loop.p99 + ' us max=' + loop.max + ' us' +
+      (worst ? ' | worst stage: ' + worst.name + ' (' + worst.max + ' us)' : '');
+  }
+
+  async function pollMetrics(reset) {
+    try {
+      let resp = await fetch('/metrics' + (reset ? '?reset=1' : ''));
+      if (resp.ok) showMetrics(await resp.json());
+    } catch(e) {}
+  }
+
+  document.getElementById('btnMetrics').addEventListener('click', function() {
+    let collapsed = metricsEl.classList.toggle('collapsed');
+    this.textContent = collapsed ? 'Show' : 'Hide';
+  });
+  document.getElementById('btnMetricsReset').addEventListener('click', function() { pollMetrics(true); });
+
+  setInterval(function() { pollMetrics(false); }, 2000);
+  pollMetrics(false);
+
   // Poll loop - 4Hz
   setInterval(poll, 250);
   poll();
@@ -1,8 +1,8 @@
 // =============================================================================
 // Web Server Module - Implementation
 // =============================================================================
-// Simple HTTP server with polling-based status endpoint.
-// The web UI fetches /status at 10Hz via fetch().
+// HTTP server with a JSON status endpoint and the /ws telemetry stream.
+// The web UI decodes /ws frames and only fetches /status for strings.
 // =============================================================================
 
 #include "web_server.h"
@@ -15,14 +15,30 @@
 #include "web_ui.h"
 #include "web_config.h"
 #include "web_log.h"
+#include "web_telemetry.h"
+#include "flight_recorder.h"
+#include "profiler.h"
+#include "robot_status.h"
 #include "settings_manager.h"
 
+#include "json_writer.h"
+
 #include <esp_http_server.h>
+#include <esp_heap_caps.h>
 #include <ArduinoJson.h>
 
+#include <ctype.h>
+#include <strings.h>
+
 static const char* TAG = "WebServer";
 
 static httpd_handle_t s_server = NULL;
+static WebTelemetry s_telemetry;
+
+// Shared JSON response buffer. Allocated once in begin() and reused by every
+// handler -- all handlers run on the single httpd task, so there is never
+// more than one response being built at a time.
+static char* s_jsonBuf = nullptr;
 
 // External references
 extern WiFiManager g_wifiManager;
@@ -30,93 +46,161 @@ extern ControllerManager g_controllerManager;
 extern DriveManager g_driveManager;
 extern MotorManager g_motorManager;
 extern SettingsManager g_settingsManager;
-
-// IMU and state machine state (defined in sketch.cpp)
-extern volatile bool g_isUpsideDown;
-extern float g_pitchAngleForWeb;
-extern int g_selfRightStateForWeb;
-extern int g_noseDownStateForWeb;
+extern FlightRecorder g_flightRecorder;
 
 // ---------------------------------------------------------------------------
-// Build JSON status string
+// JSON responses
 // ---------------------------------------------------------------------------
-static String buildStatusJson() {
-    JsonDocument doc;
 
-    // WiFi status
-    JsonObject wifi = doc["wifi"].to<JsonObject>();
-    wifi["ssid"] = g_wifiManager.getSSID();
-    wifi["ip"] = g_wifiManager.getIP();
-    wifi["rssi"] = g_wifiManager.getRSSI();
+// Send a finished writer as the response body, or a 500 if it didn't fit
+static esp_err_t sendJson(httpd_req_t* req, const JsonWriter& w) {
+    if (w.overflowed()) {
+        LOG_WARN(TAG, "JSON response for %s exceeds %d bytes", req->uri, WEB_JSON_BUFFER_SIZE);
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Response too large");
+        return ESP_FAIL;
+    }
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_send(req, w.c_str(), w.length());
+    return ESP_OK;
+}
 
-    // Controller states
-    JsonArray controllers = doc["controllers"].to<JsonArray>();
+static void writeStatusJson(JsonWriter& w) {
+    w.beginObject();
+
+    // WiFi status
+    char ip[16];
+    g_wifiManager.formatIP(ip, sizeof(ip));
+    w.beginObject("wifi");
+    w.field("ssid", g_wifiManager.getSSID());
+    w.field("ip", ip);
+    w.field("rssi", g_wifiManager.getRSSI());
+    w.endObject();
+
+    // Controller states. Static: the httpd task is the only caller, and
+    // these snapshots are too big for its stack.
+    static ControllerStates controllers;
+    g_controllerManager.readStates(&controllers);
+    w.beginArray("controllers");
     for (int i = 0; i < CONTROLLER_MAX_COUNT; i++) {
-        const ControllerState& state = g_controllerManager.getState(i);
-        JsonObject ctrl = controllers.add<JsonObject>();
-        ctrl["id"] = i;
-        ctrl["connected"] = state.connected;
+        const ControllerState& state = controllers.slot[i];
+        w.beginObject();
+        w.field("id", i);
+        w.field("connected", state.connected);
         if (state.connected) {
-            ctrl["model"] = state.modelName;
-            ctrl["lx"] = state.lx;
-            ctrl["ly"] = state.ly;
-            ctrl["rx"] = state.rx;
-            ctrl["ry"] = state.ry;
-            ctrl["l2"] = state.l2;
-            ctrl["r2"] = state.r2;
-            ctrl["buttons"] = state.buttons;
-            ctrl["dpad"] = state.dpad;
+            w.field("model", state.modelName);
+            w.field("lx", state.lx);
+            w.field("ly", state.ly);
+            w.field("rx", state.rx);
+            w.field("ry", state.ry);
+            w.field("l2", state.l2);
+            w.field("r2", state.r2);
+            w.field("buttons", state.buttons);
+            w.field("dpad", state.dpad);
         }
+        w.endObject();
     }
+    w.endArray();
 
     // Drive outputs (servo PPM)
-    JsonObject drive = doc["drive"].to<JsonObject>();
-    drive["left"] = g_driveManager.getLeftPulse();
-    drive["right"] = g_driveManager.getRightPulse();
-    drive["leftDrive"] = serialized(String(g_driveManager.getLeftDrive(), 2));
-    drive["rightDrive"] = serialized(String(g_driveManager.getRightDrive(), 2));
+    DriveOutputs drive = g_driveManager.getOutputs();
+    w.beginObject("drive");
+    w.field("left", drive.leftPulseUs);
+    w.field("right", drive.rightPulseUs);
+    w.field("leftDrive", drive.leftDrive, 2);
+    w.field("rightDrive", drive.rightDrive, 2);
+    w.endObject();
 
     // CAN Motors
-    JsonArray motors = doc["motors"].to<JsonArray>();
-    int motorCount = g_motorManager.getMotorCount();
-    for (int i = 0; i < motorCount; i++) {
-        const RobstrideMotorStatus& status = g_motorManager.getMotorStatus(i);
-        JsonObject motor = motors.add<JsonObject>();
-        uint8_t motorCanId = g_motorManager.getMotorId(i);
-        motor["id"] = motorCanId;
-        motor["role"] = g_motorManager.getRoleLabel(motorCanId);
-        motor["position"] = serialized(String(status.position, 3));
-        motor["velocity"] = serialized(String(status.velocity, 2));
-        motor["torque"] = serialized(String(status.torque, 2));
-        motor["temperature"] = serialized(String(status.temperature, 1));
-        motor["voltage"] = serialized(String(status.voltage, 1));
-        motor["mode"] = status.mode;
-        motor["runMode"] = status.runMode;
-        motor["enabled"] = status.enabled;
-        motor["errorCode"] = status.errorCode;
-        motor["hasFault"] = status.hasFault;
-        motor["stale"] = status.stale;
-        motor["ppSpeed"] = serialized(String(status.ppSpeed, 2));
-        motor["ppAccel"] = serialized(String(status.ppAccel, 1));
-        motor["limitSpd"] = serialized(String(status.limitSpd, 2));
-        motor["limitCur"] = serialized(String(status.limitCur, 2));
-    }
-    doc["canRunning"] = g_motorManager.isRunning();
+    static MotorManager::MotorTable motors;
+    g_motorManager.readTable(&motors);
+    w.beginArray("motors");
+    for (int i = 0; i < motors.count; i++) {
+        const RobstrideMotorStatus& status = motors.status[i];
+        uint8_t motorCanId = motors.ids[i];
+        w.beginObject();
+        w.field("id", motorCanId);
+        w.field("role", g_motorManager.getRoleLabel(motorCanId));
+        w.field("position", status.position, 3);
+        w.field("velocity", status.velocity, 2);
+        w.field("torque", status.torque, 2);
+        w.field("temperature", status.temperature, 1);
+        w.field("voltage", status.voltage, 1);
+        w.field("mode", status.mode);
+        w.field("runMode", status.runMode);
+        w.field("enabled", status.enabled);
+        w.field("errorCode", status.errorCode);
+        w.field("hasFault", status.hasFault);
+        w.field("stale", status.stale);
+        w.field("ppSpeed", status.ppSpeed, 2);
+        w.field("ppAccel", status.ppAccel, 1);
+        w.field("limitSpd", status.limitSpd, 2);
+        w.field("limitCur", status.limitCur, 2);
+        w.field("intervalUs", (unsigned long)status.intervalUs);
+        w.field("jitterUs", (unsigned long)status.jitterUs);
+        w.field("rttUs", (unsigned long)status.rttUs);
+        w.endObject();
+    }
+    w.endArray();
+    w.field("canRunning", g_motorManager.isRunning());
 
     // Motor role config
-    JsonObject motorConfig = doc["motorConfig"].to<JsonObject>();
-    motorConfig["leftId"] = g_motorManager.getLeftMotorId();
-    motorConfig["rightId"] = g_motorManager.getRightMotorId();
+    w.beginObject("motorConfig");
+    w.field("leftId", g_motorManager.getLeftMotorId());
+    w.field("rightId", g_motorManager.getRightMotorId());
+    w.endObject();
 
     // System info
-    JsonObject sys = doc["system"].to<JsonObject>();
-    sys["uptime_s"] = (unsigned long)(millis() / 1000);
-    sys["free_heap"] = ESP.getFreeHeap();
-    sys["free_psram"] = ESP.getFreePsram();
-
-    String output;
-    serializeJson(doc, output);
-    return output;
+    w.beginObject("system");
+    w.field("uptime_s", (unsigned long)(millis() / 1000));
+    w.field("free_heap", (unsigned long)ESP.getFreeHeap());
+    w.field("free_psram", (unsigned long)ESP.getFreePsram());
+    w.endObject();
+
+    w.endObject();
+}
+
+// Motor role assignments (+ "ok" for POST replies)
+static void writeMotorConfigJson(JsonWriter& w, bool withDiscovered, bool withOk) {
+    w.beginObject();
+    w.field("leftId", g_motorManager.getLeftMotorId());
+    w.field("rightId", g_motorManager.getRightMotorId());
+
+    // Include list of discovered motor IDs for the dropdown
+    if (withDiscovered) {
+        w.beginArray("discovered");
+        static MotorManager::MotorTable motors;
+        g_motorManager.readTable(&motors);
+        for (int i = 0; i < motors.count; i++) {
+            w.value(motors.ids[i]);
+        }
+        w.endArray();
+    }
+    if (withOk) {
+        w.field("ok", true);
+    }
+    w.endObject();
+}
+
+// Button modes, presets and motor tuning (+ "ok" for POST replies)
+static void writeSettingsJson(JsonWriter& w, bool withOk) {
+    w.beginObject();
+    if (withOk) {
+        w.field("ok", true);
+    }
+    w.field("yMode",  g_settingsManager.getYMode());
+    w.field("yLeft",  g_settingsManager.getYLeft(), 3);
+    w.field("yRight", g_settingsManager.getYRight(), 3);
+    w.field("bMode",  g_settingsManager.getBMode());
+    w.field("bLeft",  g_settingsManager.getBLeft(), 3);
+    w.field("bRight", g_settingsManager.getBRight(), 3);
+    w.field("aMode",  g_settingsManager.getAMode());
+    w.field("aLeft",  g_settingsManager.getALeft(), 3);
+    w.field("aRight", g_settingsManager.getARight(), 3);
+    w.field("speedLimit",   g_settingsManager.getMotorSpeedLimit(), 3);
+    w.field("acceleration", g_settingsManager.getMotorAcceleration(), 3);
+    w.field("currentLimit", g_settingsManager.getMotorCurrentLimit(), 3);
+    w.endObject();
 }
 
 // ---------------------------------------------------------------------------
@@ -124,20 +208,21 @@ static String buildStatusJson() {
 // ---------------------------------------------------------------------------
 
 static esp_err_t root_handler(httpd_req_t* req) {
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
     httpd_resp_set_type(req, "text/html");
     httpd_resp_send(req, WEB_UI_HTML, strlen(WEB_UI_HTML));
     return ESP_OK;
 }
 
 static esp_err_t status_handler(httpd_req_t* req) {
-    String json = buildStatusJson();
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_send(req, json.c_str(), json.length());
-    return ESP_OK;
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
+    JsonWriter w(s_jsonBuf, WEB_JSON_BUFFER_SIZE);
+    writeStatusJson(w);
+    return sendJson(req, w);
 }
 
 static esp_err_t health_handler(httpd_req_t* req) {
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
     httpd_resp_set_type(req, "text/plain");
     httpd_resp_send(req, "ok", 2);
     return ESP_OK;
@@ -145,27 +230,15 @@ static esp_err_t health_handler(httpd_req_t* req) {
 
 // Config GET - return current motor config as JSON
 static esp_err_t config_get_handler(httpd_req_t* req) {
-    JsonDocument doc;
-    doc["leftId"] = g_motorManager.getLeftMotorId();
-    doc["rightId"] = g_motorManager.getRightMotorId();
-
-    // Include list of discovered motor IDs for the dropdown
-    JsonArray discovered = doc["discovered"].to<JsonArray>();
-    int count = g_motorManager.getMotorCount();
-    for (int i = 0; i < count; i++) {
-        discovered.add(g_motorManager.getMotorId(i));
-    }
-
-    String output;
-    serializeJson(doc, output);
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_send(req, output.c_str(), output.length());
-    return ESP_OK;
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
+    JsonWriter w(s_jsonBuf, WEB_JSON_BUFFER_SIZE);
+    writeMotorConfigJson(w, true, false);
+    return sendJson(req, w);
 }
 
 // Config POST - update motor role assignments
 static esp_err_t config_post_handler(httpd_req_t* req) {
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
     // Read body (limit to 256 bytes)
     char buf[256];
     int received = httpd_req_recv(req, buf, sizeof(buf) - 1);
@@ -191,21 +264,14 @@ static esp_err_t config_post_handler(httpd_req_t* req) {
     }
 
     // Return updated config
-    JsonDocument resp;
-    resp["leftId"] = g_motorManager.getLeftMotorId();
-    resp["rightId"] = g_motorManager.getRightMotorId();
-    resp["ok"] = true;
-
-    String output;
-    serializeJson(resp, output);
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_send(req, output.c_str(), output.length());
-    return ESP_OK;
+    JsonWriter w(s_jsonBuf, WEB_JSON_BUFFER_SIZE);
+    writeMotorConfigJson(w, false, true);
+    return sendJson(req, w);
 }
 
 // Settings page - serves the configuration UI
 static esp_err_t settings_handler(httpd_req_t* req) {
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
     extern const char WEB_CONFIG_HTML[];
     httpd_resp_set_type(req, "text/html");
     httpd_resp_send(req, WEB_CONFIG_HTML, strlen(WEB_CONFIG_HTML));
@@ -214,81 +280,183 @@ static esp_err_t settings_handler(httpd_req_t* req) {
 
 // Log viewer page
 static esp_err_t log_page_handler(httpd_req_t* req) {
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
     httpd_resp_set_type(req, "text/html");
     httpd_resp_send(req, WEB_LOG_HTML, strlen(WEB_LOG_HTML));
     return ESP_OK;
 }
 
-// Log streaming JSON endpoint: /logs?since=<seq>
-// Returns new log entries since the given sequence number, plus telemetry.
+// Decode %XX escapes and '+' in a query value, in place
+static void urlDecode(char* s) {
+    char* out = s;
+    for (; *s; s++) {
+        if (*s == '+') {
+            *out++ = ' ';
+        } else if (*s == '%' && isxdigit((unsigned char)s[1]) && isxdigit((unsigned char)s[2])) {
+            char hex[3] = { s[1], s[2], '\0' };
+            *out++ = (char)strtoul(hex, NULL, 16);
+            s += 2;
+        } else {
+            *out++ = *s;
+        }
+    }
+    *out = '\0';
+}
+
+struct LogFilter {
+    int maxLevel;               // Lines at this level or more severe
+    const char* tag;            // Exact tag (case-insensitive), "" = any
+    const char* prefix;         // Message prefix, "" = any
+    size_t prefixLen;
+};
+
+static bool logMatches(const LogLine& line, const LogFilter& filter) {
+    if (line.level > filter.maxLevel) {
+        return false;
+    }
+    if (filter.tag[0] != '\0' && strcasecmp(line.tag, filter.tag) != 0) {
+        return false;
+    }
+    return filter.prefixLen == 0 || strncmp(line.text, filter.prefix, filter.prefixLen) == 0;
+}
+
+// Log history: /logs?since=<seq>&limit=<n>&level=<name>&tag=<tag>&prefix=<text>
+// Returns up to `limit` matching lines from `since` on, oldest first; without
+// `since` (or after a reboot), the newest `limit` matching lines. "next" is
+// the since= for the following request. Streamed as a chunked response, so
+// a large limit costs handler time, not buffer space.
 static esp_err_t logs_handler(httpd_req_t* req) {
-    // Parse "since" query parameter
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
+
+    bool hasSince = false;
     uint32_t sinceSeq = 0;
-    char queryBuf[32];
+    int limit = WEB_LOGS_DEFAULT_LIMIT;
+    static char s_tagBuf[24];
+    static char s_prefixBuf[64];
+    s_tagBuf[0] = '\0';
+    s_prefixBuf[0] = '\0';
+    LogFilter filter = { LOG_LEVEL_DEBUG, s_tagBuf, s_prefixBuf, 0 };
+
+    char queryBuf[192];
     if (httpd_req_get_url_query_str(req, queryBuf, sizeof(queryBuf)) == ESP_OK) {
         char valBuf[16];
         if (httpd_query_key_value(queryBuf, "since", valBuf, sizeof(valBuf)) == ESP_OK) {
             sinceSeq = (uint32_t)strtoul(valBuf, NULL, 10);
+            hasSince = true;
+        }
+        if (httpd_query_key_value(queryBuf, "limit", valBuf, sizeof(valBuf)) == ESP_OK) {
+            limit = atoi(valBuf);
+            if (limit < 1) { limit = 1; }
+            if (limit > WEB_LOGS_MAX_LIMIT) { limit = WEB_LOGS_MAX_LIMIT; }
+        }
+        if (httpd_query_key_value(queryBuf, "level", valBuf, sizeof(valBuf)) == ESP_OK) {
+            filter.maxLevel = logLevelFromName(valBuf);
+            if (filter.maxLevel < 0) {
+                httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown level");
+                return ESP_FAIL;
+            }
+        }
+        if (httpd_query_key_value(queryBuf, "tag", s_tagBuf, sizeof(s_tagBuf)) == ESP_OK) {
+            urlDecode(s_tagBuf);
+        }
+        if (httpd_query_key_value(queryBuf, "prefix", s_prefixBuf, sizeof(s_prefixBuf)) == ESP_OK) {
+            urlDecode(s_prefixBuf);
+            filter.prefixLen = strlen(s_prefixBuf);
         }
     }
 
-    // Fetch new log entries from ring buffer
-    static const int MAX_BATCH = 30;
-    static LogEntry entries[MAX_BATCH];  // static to avoid stack overflow
-    int count = logRingGetSince(sinceSeq, entries, MAX_BATCH);
-
-    // Build JSON response
-    JsonDocument doc;
-    doc["head"] = logRingGetHead();
-
-    JsonArray arr = doc["entries"].to<JsonArray>();
-    for (int i = 0; i < count; i++) {
-        arr.add(entries[i].text);
+    static LogLine line;  // static to keep it off the httpd stack
+    uint32_t head = logHistoryGetHead();
+    uint32_t oldest = logHistoryGetOldest();
+
+    // A since= past the head is from before a reboot -- start over
+    uint32_t start;
+    if (hasSince && sinceSeq <= head) {
+        start = (sinceSeq > oldest) ? sinceSeq : oldest;
+    } else {
+        // Walk back to where the newest `limit` matches begin
+        start = head;
+        int found = 0;
+        while (start > oldest && found < limit) {
+            start--;
+            if (logHistoryRead(start, &line) && logMatches(line, filter)) {
+                found++;
+            }
+        }
     }
 
+    // Header: everything but the entries; the array is left open
+    JsonWriter w(s_jsonBuf, WEB_JSON_BUFFER_SIZE);
+    w.beginObject();
+    w.field("head", (unsigned long)head);
+    w.field("oldest", (unsigned long)oldest);
+    w.field("capacity", (unsigned long)logHistoryGetCapacity());
+
     // Telemetry snapshot
-    doc["pitch"] = g_pitchAngleForWeb;
-    doc["flipped"] = (bool)g_isUpsideDown;
-    doc["sr"] = g_selfRightStateForWeb;
-    doc["nd"] = g_noseDownStateForWeb;
-    doc["driveL"] = g_driveManager.getLeftDrive();
-    doc["driveR"] = g_driveManager.getRightDrive();
-    doc["uptime"] = (unsigned long)(millis() / 1000);
-
-    String output;
-    serializeJson(doc, output);
+    RobotStatus robot = g_robotStatus.load();
+    DriveOutputs drive = g_driveManager.getOutputs();
+    w.field("pitch", robot.pitch, 4);
+    w.field("flipped", robot.upsideDown);
+    w.field("sr", (int)robot.selfRightState);
+    w.field("nd", (int)robot.noseDownState);
+    w.field("driveL", drive.leftDrive, 3);
+    w.field("driveR", drive.rightDrive, 3);
+    w.field("uptime", (unsigned long)(millis() / 1000));
+    w.beginArray("entries");
+
     httpd_resp_set_type(req, "application/json");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_send(req, output.c_str(), output.length());
-    return ESP_OK;
+    if (httpd_resp_send_chunk(req, w.c_str(), w.length()) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    // Entries, batched into the shared buffer. Flush while there is still
+    // room for a fully escaped line.
+    static const size_t FLUSH_AT = WEB_JSON_BUFFER_SIZE - (6 * LOG_LINE_MAX_LEN + 32);
+    size_t used = 0;
+    int sent = 0;
+    uint32_t seq = start;
+    for (; seq < head && sent < limit; seq++) {
+        if (!logHistoryRead(seq, &line) || !logMatches(line, filter)) {
+            continue;
+        }
+        char text[LOG_LINE_MAX_LEN];
+        logFormatLine(line, text, sizeof(text));
+
+        if (used > FLUSH_AT) {
+            if (httpd_resp_send_chunk(req, s_jsonBuf, used) != ESP_OK) {
+                return ESP_FAIL;
+            }
+            used = 0;
+        }
+        if (sent > 0) {
+            s_jsonBuf[used++] = ',';
+        }
+        JsonWriter lw(s_jsonBuf + used, WEB_JSON_BUFFER_SIZE - used);
+        lw.value(text);
+        used += lw.length();
+        sent++;
+    }
+
+    used += snprintf(s_jsonBuf + used, WEB_JSON_BUFFER_SIZE - used,
+                     "],\"next\":%lu}", (unsigned long)seq);
+    if (httpd_resp_send_chunk(req, s_jsonBuf, used) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
 }
 
 // Settings data GET - return current modes, presets, and speed limit as JSON
 static esp_err_t settingsdata_get_handler(httpd_req_t* req) {
-    JsonDocument doc;
-    doc["yMode"]  = g_settingsManager.getYMode();
-    doc["yLeft"]  = g_settingsManager.getYLeft();
-    doc["yRight"] = g_settingsManager.getYRight();
-    doc["bMode"]  = g_settingsManager.getBMode();
-    doc["bLeft"]  = g_settingsManager.getBLeft();
-    doc["bRight"] = g_settingsManager.getBRight();
-    doc["aMode"]  = g_settingsManager.getAMode();
-    doc["aLeft"]  = g_settingsManager.getALeft();
-    doc["aRight"] = g_settingsManager.getARight();
-    doc["speedLimit"]   = g_settingsManager.getMotorSpeedLimit();
-    doc["acceleration"] = g_settingsManager.getMotorAcceleration();
-    doc["currentLimit"] = g_settingsManager.getMotorCurrentLimit();
-
-    String output;
-    serializeJson(doc, output);
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_send(req, output.c_str(), output.length());
-    return ESP_OK;
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
+    JsonWriter w(s_jsonBuf, WEB_JSON_BUFFER_SIZE);
+    writeSettingsJson(w, false);
+    return sendJson(req, w);
 }
 
 // Settings data POST - update modes, presets, and/or motor tuning
 static esp_err_t settingsdata_post_handler(httpd_req_t* req) {
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
     char buf[512];
     int received = httpd_req_recv(req, buf, sizeof(buf) - 1);
     if (received <= 0) {
@@ -340,29 +508,211 @@ static esp_err_t settingsdata_post_handler(httpd_req_t* req) {
     }
 
     // Return success with current state
-    JsonDocument resp;
-    resp["ok"] = true;
-    resp["yMode"]  = g_settingsManager.getYMode();
-    resp["yLeft"]  = g_settingsManager.getYLeft();
-    resp["yRight"] = g_settingsManager.getYRight();
-    resp["bMode"]  = g_settingsManager.getBMode();
-    resp["bLeft"]  = g_settingsManager.getBLeft();
-    resp["bRight"] = g_settingsManager.getBRight();
-    resp["aMode"]  = g_settingsManager.getAMode();
-    resp["aLeft"]  = g_settingsManager.getALeft();
-    resp["aRight"] = g_settingsManager.getARight();
-    resp["speedLimit"]   = g_settingsManager.getMotorSpeedLimit();
-    resp["acceleration"] = g_settingsManager.getMotorAcceleration();
-    resp["currentLimit"] = g_settingsManager.getMotorCurrentLimit();
-
-    String output;
-    serializeJson(resp, output);
-    httpd_resp_set_type(req, "application/json");
+    JsonWriter w(s_jsonBuf, WEB_JSON_BUFFER_SIZE);
+    writeSettingsJson(w, true);
+    return sendJson(req, w);
+}
+
+// Flight recorder status
+static void writeRecordingJson(JsonWriter& w) {
+    uint32_t written = g_flightRecorder.getWriteCount();
+    w.beginObject();
+    w.field("available", g_flightRecorder.isAvailable());
+    w.field("state", FlightRecorder::stateName(g_flightRecorder.getState()));
+    w.field("downloaded", g_flightRecorder.isDownloaded());
+    w.field("count", (unsigned long)(written - g_flightRecorder.getOldestSeq()));
+    w.field("written", (unsigned long)written);
+    w.field("capacity", (unsigned long)g_flightRecorder.getCapacity());
+    w.field("recordSize", (unsigned)sizeof(FlightRecord));
+    w.field("periodUs", IMU_UPDATE_MS * 1000);
+    w.endObject();
+}
+
+// Recorder status GET
+static esp_err_t recording_get_handler(httpd_req_t* req) {
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
+    JsonWriter w(s_jsonBuf, WEB_JSON_BUFFER_SIZE);
+    writeRecordingJson(w);
+    return sendJson(req, w);
+}
+
+// Recorder control POST - {"cmd": "arm" | "trigger" | "stop"}
+static esp_err_t recording_post_handler(httpd_req_t* req) {
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
+    char buf[64];
+    int received = httpd_req_recv(req, buf, sizeof(buf) - 1);
+    if (received <= 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Empty body");
+        return ESP_FAIL;
+    }
+    buf[received] = '\0';
+
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, buf);
+    if (err || !doc["cmd"].is<const char*>()) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+        return ESP_FAIL;
+    }
+
+    const char* cmd = doc["cmd"].as<const char*>();
+    if (strcmp(cmd, "arm") == 0) {
+        g_flightRecorder.arm();
+    } else if (strcmp(cmd, "trigger") == 0) {
+        g_flightRecorder.trigger();
+    } else if (strcmp(cmd, "stop") == 0) {
+        g_flightRecorder.stop();
+    } else {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown cmd");
+        return ESP_FAIL;
+    }
+
+    JsonWriter w(s_jsonBuf, WEB_JSON_BUFFER_SIZE);
+    writeRecordingJson(w);
+    return sendJson(req, w);
+}
+
+// Recording download: FlightRecordingHeader + records, oldest first,
+// streamed in chunks through the shared response buffer. Not profiled --
+// its duration is dominated by the client's download speed.
+static esp_err_t recording_bin_handler(httpd_req_t* req) {
+    if (!g_flightRecorder.isAvailable()) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Recorder unavailable");
+        return ESP_FAIL;
+    }
+
+    // A frozen capture downloaded in full may be replaced by the next
+    // automatic one (FlightRecorder::autoArm)
+    uint32_t captureId = g_flightRecorder.getCaptureId();
+    bool frozen = g_flightRecorder.getState() == FlightRecorder::STOPPED;
+
+    uint32_t end = g_flightRecorder.getWriteCount();
+    uint32_t seq = g_flightRecorder.getOldestSeq();
+
+    FlightRecordingHeader header;
+    header.magic = FLIGHT_REC_MAGIC;
+    header.version = FLIGHT_REC_VERSION;
+    header.recordSize = sizeof(FlightRecord);
+    header.recordCount = end - seq;
+    header.periodUs = IMU_UPDATE_MS * 1000;
+
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"recording.bin\"");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_send(req, output.c_str(), output.length());
+    if (httpd_resp_send_chunk(req, (const char*)&header, sizeof(header)) != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    FlightRecord* chunk = (FlightRecord*)s_jsonBuf;
+    const int perChunk = WEB_JSON_BUFFER_SIZE / sizeof(FlightRecord);
+    int n = 0;
+    uint32_t sent = 0;
+    uint32_t dropped = 0;
+    for (; seq < end; seq++) {
+        // Records overwritten while we stream (still recording) are skipped
+        if (!g_flightRecorder.readRecord(seq, &chunk[n])) {
+            dropped++;
+            continue;
+        }
+        n++;
+        if (n == perChunk) {
+            if (httpd_resp_send_chunk(req, (const char*)chunk, n * sizeof(FlightRecord)) != ESP_OK) {
+                return ESP_FAIL;
+            }
+            sent += n;
+            n = 0;
+        }
+    }
+    if (n > 0) {
+        if (httpd_resp_send_chunk(req, (const char*)chunk, n * sizeof(FlightRecord)) != ESP_OK) {
+            return ESP_FAIL;
+        }
+        sent += n;
+    }
+    httpd_resp_send_chunk(req, NULL, 0);
+
+    if (frozen && dropped == 0 && g_flightRecorder.getCaptureId() == captureId) {
+        g_flightRecorder.markDownloaded(captureId);
+    }
+
+    LOG_INFO(TAG, "Sent recording: %lu records (%lu overwritten during download)",
+             (unsigned long)sent, (unsigned long)dropped);
     return ESP_OK;
 }
 
+static void writeStageJson(JsonWriter& w, ProfileStage stage, bool withBuckets) {
+    ProfileStats stats;
+    g_profiler.getStats(stage, &stats);
+
+    w.beginObject();
+    w.field("name", Profiler::stageName(stage));
+    w.field("count", (unsigned long)stats.count);
+    w.field("p50", (unsigned long)stats.p50);
+    w.field("p90", (unsigned long)stats.p90);
+    w.field("p99", (unsigned long)stats.p99);
+    w.field("max", (unsigned long)stats.max);
+    if (withBuckets) {
+        // Non-empty buckets as [lowerUs, count]
+        uint32_t counts[LatencyHistogram::BUCKET_COUNT];
+        g_profiler.getHistogram(stage).copyBuckets(counts);
+        w.beginArray("buckets");
+        for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; i++) {
+            if (counts[i] == 0) {
+                continue;
+            }
+            w.beginArray();
+            w.value((unsigned long)LatencyHistogram::bucketLower(i));
+            w.value((unsigned long)counts[i]);
+            w.endArray();
+        }
+        w.endArray();
+    }
+    w.endObject();
+}
+
+// Stage latency metrics: /metrics[?stage=<name>][&reset=1]
+// All stages with p50/p90/p99/max (us); stage=<name> returns just that
+// stage with its histogram buckets. reset=1 clears the histograms after
+// this response has been built.
+static esp_err_t metrics_handler(httpd_req_t* req) {
+    PROFILE_SCOPE(PROF_STAGE_HTTP);
+
+    ProfileStage only = PROF_STAGE_COUNT;
+    bool reset = false;
+    char queryBuf[48];
+    if (httpd_req_get_url_query_str(req, queryBuf, sizeof(queryBuf)) == ESP_OK) {
+        char valBuf[16];
+        if (httpd_query_key_value(queryBuf, "stage", valBuf, sizeof(valBuf)) == ESP_OK) {
+            only = Profiler::stageFromName(valBuf);
+            if (only == PROF_STAGE_COUNT) {
+                httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Unknown stage");
+                return ESP_FAIL;
+            }
+        }
+        if (httpd_query_key_value(queryBuf, "reset", valBuf, sizeof(valBuf)) == ESP_OK) {
+            reset = (strcmp(valBuf, "1") == 0);
+        }
+    }
+
+    JsonWriter w(s_jsonBuf, WEB_JSON_BUFFER_SIZE);
+    w.beginObject();
+    w.field("uptimeMs", (unsigned long)millis());
+    w.beginArray("stages");
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+        ProfileStage stage = (ProfileStage)i;
+        if (only != PROF_STAGE_COUNT && stage != only) {
+            continue;
+        }
+        writeStageJson(w, stage, only != PROF_STAGE_COUNT);
+    }
+    w.endArray();
+    w.endObject();
+
+    if (reset) {
+        g_profiler.resetAll();
+    }
+    return sendJson(req, w);
+}
+
 // ---------------------------------------------------------------------------
 // Public methods
 // ---------------------------------------------------------------------------
@@ -374,10 +724,21 @@ void WebServerManager::begin() {
 
     LOG_INFO(TAG, "Starting web server on port %d...", WEB_SERVER_PORT);
 
+    // One long-lived response buffer instead of a JsonDocument + String per
+    // request -- keeps long sessions from fragmenting the internal heap
+    s_jsonBuf = (char*)heap_caps_malloc(WEB_JSON_BUFFER_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (s_jsonBuf == nullptr) {
+        s_jsonBuf = (char*)heap_caps_malloc(WEB_JSON_BUFFER_SIZE, MALLOC_CAP_8BIT);
+    }
+    if (s_jsonBuf == nullptr) {
+        LOG_ERROR(TAG, "Failed to allocate %d B JSON buffer", WEB_JSON_BUFFER_SIZE);
+        return;
+    }
+
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.server_port = WEB_SERVER_PORT;
     config.lru_purge_enable = true;
-    config.max_uri_handlers = 12;
+    config.max_uri_handlers = 18;
 
     esp_err_t ret = httpd_start(&s_server, &config);
     if (ret != ESP_OK) {
@@ -457,6 +818,35 @@ void WebServerManager::begin() {
     settingsdata_post_uri.handler = settingsdata_post_handler;
     httpd_register_uri_handler(s_server, &settingsdata_post_uri);
 
+    // Flight recorder status / control / download
+    httpd_uri_t recording_get_uri = {};
+    recording_get_uri.uri     = "/recording";
+    recording_get_uri.method  = HTTP_GET;
+    recording_get_uri.handler = recording_get_handler;
+    httpd_register_uri_handler(s_server, &recording_get_uri);
+
+    httpd_uri_t recording_post_uri = {};
+    recording_post_uri.uri     = "/recording";
+    recording_post_uri.method  = HTTP_POST;
+    recording_post_uri.handler = recording_post_handler;
+    httpd_register_uri_handler(s_server, &recording_post_uri);
+
+    httpd_uri_t recording_bin_uri = {};
+    recording_bin_uri.uri     = "/recording.bin";
+    recording_bin_uri.method  = HTTP_GET;
+    recording_bin_uri.handler = recording_bin_handler;
+    httpd_register_uri_handler(s_server, &recording_bin_uri);
+
+    // Per-stage latency histograms
+    httpd_uri_t metrics_uri = {};
+    metrics_uri.uri     = "/metrics";
+    metrics_uri.method  = HTTP_GET;
+    metrics_uri.handler = metrics_handler;
+    httpd_register_uri_handler(s_server, &metrics_uri);
+
+    // Binary telemetry WebSocket (/ws) + push task
+    s_telemetry.begin(s_server);
+
     _started = true;
     LOG_INFO(TAG, "Web server ready at http://%s:%d/",
              g_wifiManager.getIP().c_str(), WEB_SERVER_PORT);
@@ -3,10 +3,9 @@
 // =============================================================================
 // Web Server Module
 // =============================================================================
-// Uses ESP-IDF native httpd. Serves the embedded web UI at "/" and provides
-// a JSON status endpoint at /status that the UI polls at 4Hz.
-//
-// No WebSocket complexity - just simple HTTP GET requests.
+// Uses ESP-IDF native httpd. Serves the embedded web UI at "/", streams
+// binary telemetry over a WebSocket at /ws (see web_telemetry.h), and keeps
+// the JSON status endpoint at /status for strings and non-WebSocket clients.
 //
 // Usage:
 //   WebServerManager webServer;
@@ -0,0 +1,333 @@
+// =============================================================================
+// Web Telemetry Module - Implementation
+// =============================================================================
+// Packs status into a fixed binary frame (see web_telemetry.h for the
+// layout) on a low-priority task; the httpd task sends it to /ws clients.
+// =============================================================================
+
+#include "web_telemetry.h"
+#include "debug_log.h"
+#include "wifi_manager.h"
+#include "controller_manager.h"
+#include "drive_manager.h"
+#include "motor_manager.h"
+#include "balance_manager.h"
+#include "robot_status.h"
+
+#include <freertos/task.h>
+#include <cstring>
+
+static const char* TAG = "Telemetry";
+
+// External references
+extern WiFiManager g_wifiManager;
+extern ControllerManager g_controllerManager;
+extern DriveManager g_driveManager;
+extern MotorManager g_motorManager;
+extern BalanceManager g_balanceManager;
+
+// Frame sizing (must match the layout in web_telemetry.h)
+static const int HEADER_BYTES = 12 + 16 + 12 + 12;
+static const int CONTROLLER_RECORD_BYTES = 16;
+static const int MOTOR_RECORD_BYTES = 56;
+static const int MAX_FRAME_MOTORS = 8;
+static const int FRAME_BUFFER_BYTES = HEADER_BYTES
+                                    + CONTROLLER_RECORD_BYTES * CONTROLLER_MAX_COUNT
+                                    + MOTOR_RECORD_BYTES * MAX_FRAME_MOTORS;
+
+// Filled by the telemetry task, then read by the httpd task until
+// _sendPending is cleared
+static uint8_t s_frame[FRAME_BUFFER_BYTES];
+
+// ---------------------------------------------------------------------------
+// Little-endian field writers (ESP32 is little-endian; memcpy keeps the
+// unaligned stores legal)
+// ---------------------------------------------------------------------------
+static inline void putU8(uint8_t*& p, uint8_t v) { *p++ = v; }
+static inline void putU16(uint8_t*& p, uint16_t v) { memcpy(p, &v, 2); p += 2; }
+static inline void putI16(uint8_t*& p, int16_t v) { memcpy(p, &v, 2); p += 2; }
+static inline void putU32(uint8_t*& p, uint32_t v) { memcpy(p, &v, 4); p += 4; }
+static inline void putF32(uint8_t*& p, float v) { memcpy(p, &v, 4); p += 4; }
+
+// ---------------------------------------------------------------------------
+// Public methods
+// ---------------------------------------------------------------------------
+
+void WebTelemetry::begin(httpd_handle_t server) {
+    _server = server;
+    portMUX_INITIALIZE(&_clientLock);
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        _clientFds[i] = -1;
+    }
+
+    httpd_uri_t ws_uri = {};
+    ws_uri.uri          = "/ws";
+    ws_uri.method       = HTTP_GET;
+    ws_uri.handler      = wsHandler;
+    ws_uri.user_ctx     = this;
+    ws_uri.is_websocket = true;
+    httpd_register_uri_handler(_server, &ws_uri);
+
+    BaseType_t result = xTaskCreatePinnedToCore(
+        telemetryTaskFunc,          // Task function
+        "telemetry",                // Name
+        WEB_WS_TASK_STACK,          // Stack size
+        this,                       // Parameter (WebTelemetry instance)
+        WEB_WS_TASK_PRIORITY,       // Priority
+        NULL,                       // Task handle (not needed)
+        WEB_WS_TASK_CORE            // Core ID
+    );
+
+    if (result != pdPASS) {
+        LOG_ERROR(TAG, "Failed to create telemetry task");
+        return;
+    }
+
+    LOG_INFO(TAG, "WebSocket telemetry on /ws (%d Hz, %d B max frame)",
+             WEB_WS_RATE_HZ, FRAME_BUFFER_BYTES);
+}
+
+int WebTelemetry::getClientCount() const {
+    int count = 0;
+    portENTER_CRITICAL(&_clientLock);
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        if (_clientFds[i] >= 0) {
+            count++;
+        }
+    }
+    portEXIT_CRITICAL(&_clientLock);
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// Client list
+// ---------------------------------------------------------------------------
+
+void WebTelemetry::addClient(int fd) {
+    int slot = -1;
+    portENTER_CRITICAL(&_clientLock);
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        if (_clientFds[i] == fd) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && _clientFds[i] < 0) {
+            slot = i;
+        }
+    }
+    if (slot >= 0) {
+        _clientFds[slot] = fd;
+    }
+    portEXIT_CRITICAL(&_clientLock);
+
+    if (slot < 0) {
+        LOG_WARN(TAG, "Too many /ws clients, fd %d not streamed", fd);
+    } else {
+        LOG_INFO(TAG, "/ws client connected (fd %d)", fd);
+    }
+}
+
+void WebTelemetry::removeClient(int fd) {
+    portENTER_CRITICAL(&_clientLock);
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        if (_clientFds[i] == fd) {
+            _clientFds[i] = -1;
+        }
+    }
+    portEXIT_CRITICAL(&_clientLock);
+    LOG_INFO(TAG, "/ws client gone (fd %d)", fd);
+}
+
+// ---------------------------------------------------------------------------
+// WebSocket handler (runs on the httpd task)
+// ---------------------------------------------------------------------------
+
+esp_err_t WebTelemetry::wsHandler(httpd_req_t* req) {
+    WebTelemetry* self = static_cast<WebTelemetry*>(req->user_ctx);
+
+    // Handshake complete -- start streaming to this socket
+    if (req->method == HTTP_GET) {
+        self->addClient(httpd_req_to_sockfd(req));
+        return ESP_OK;
+    }
+
+    // Incoming frame: the only command is "hz=<n>"
+    uint8_t buf[16];
+    httpd_ws_frame_t frame = {};
+    frame.payload = buf;
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, sizeof(buf) - 1);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (frame.type == HTTPD_WS_TYPE_TEXT && frame.len > 3 &&
+        memcmp(buf, "hz=", 3) == 0) {
+        buf[frame.len] = '\0';
+        int hz = atoi((const char*)buf + 3);
+        if (hz < 1) { hz = 1; }
+        if (hz > WEB_WS_MAX_RATE_HZ) { hz = WEB_WS_MAX_RATE_HZ; }
+        self->_rateHz.store(hz, std::memory_order_relaxed);
+        LOG_INFO(TAG, "Telemetry rate set to %d Hz", hz);
+    }
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Task
+// ---------------------------------------------------------------------------
+
+void WebTelemetry::telemetryTaskFunc(void* param) {
+    WebTelemetry* self = static_cast<WebTelemetry*>(param);
+
+    TickType_t lastWake = xTaskGetTickCount();
+
+    for (;;) {
+        int hz = self->_rateHz.load(std::memory_order_relaxed);
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(1000 / hz));
+
+        if (self->getClientCount() == 0) {
+            continue;
+        }
+
+        // Previous frame still queued on the httpd task: skip this one
+        if (self->_sendPending.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        self->_frameLen = self->buildFrame(s_frame);
+        self->_sendPending.store(true, std::memory_order_release);
+        if (httpd_queue_work(self->_server, sendWork, self) != ESP_OK) {
+            self->_sendPending.store(false, std::memory_order_release);
+        }
+    }
+}
+
+// Runs on the httpd task (queued by the telemetry task)
+void WebTelemetry::sendWork(void* arg) {
+    WebTelemetry* self = static_cast<WebTelemetry*>(arg);
+    self->broadcast(s_frame, self->_frameLen);
+    self->_sendPending.store(false, std::memory_order_release);
+}
+
+int WebTelemetry::buildFrame(uint8_t* buf) {
+    // Coherent snapshots from each owner (this task is the only caller, so
+    // the big ones are static rather than on the stack)
+    static ControllerStates controllers;
+    static MotorManager::MotorTable motors;
+    BalanceState bal = g_balanceManager.getState();
+    RobotStatus robot = g_robotStatus.load();
+    DriveOutputs drive = g_driveManager.getOutputs();
+    g_controllerManager.readStates(&controllers);
+    g_motorManager.readTable(&motors);
+
+    int motorCount = motors.count;
+    if (motorCount > MAX_FRAME_MOTORS) {
+        motorCount = MAX_FRAME_MOTORS;
+    }
+
+    uint8_t flags = 0;
+    if (g_motorManager.isRunning()) { flags |= 0x01; }
+    if (bal.upsideDown)             { flags |= 0x02; }
+    if (bal.balancing)              { flags |= 0x04; }
+
+    uint8_t* p = buf;
+
+    // ---- Header ----
+    putU8(p, WEB_TELEMETRY_VERSION);
+    putU8(p, CONTROLLER_MAX_COUNT);
+    putU8(p, (uint8_t)motorCount);
+    putU8(p, flags);
+    putU32(p, ++_seq);
+    putU32(p, (uint32_t)millis());
+
+    // ---- Attitude + state ----
+    putF32(p, bal.pitch);
+    putF32(p, bal.gyroPitchRate);
+    putF32(p, bal.accelPitch);
+    putU8(p, robot.selfRightState);
+    putU8(p, robot.noseDownState);
+    putU8(p, (uint8_t)(int8_t)g_wifiManager.getRSSI());
+    putU8(p, 0);
+
+    // ---- Drive ----
+    putU16(p, drive.leftPulseUs);
+    putU16(p, drive.rightPulseUs);
+    putF32(p, drive.leftDrive);
+    putF32(p, drive.rightDrive);
+
+    // ---- System ----
+    putU32(p, ESP.getFreeHeap());
+    putU32(p, ESP.getFreePsram());
+    putU8(p, g_motorManager.getLeftMotorId());
+    putU8(p, g_motorManager.getRightMotorId());
+    putU16(p, 0);
+
+    // ---- Controllers ----
+    for (int i = 0; i < CONTROLLER_MAX_COUNT; i++) {
+        const ControllerState& c = controllers.slot[i];
+        putU8(p, c.connected ? 1 : 0);
+        putU8(p, c.dpad);
+        putI16(p, c.lx);
+        putI16(p, c.ly);
+        putI16(p, c.rx);
+        putI16(p, c.ry);
+        putI16(p, c.l2);
+        putI16(p, c.r2);
+        putU16(p, c.buttons);
+    }
+
+    // ---- Motors ----
+    for (int i = 0; i < motorCount; i++) {
+        const RobstrideMotorStatus& m = motors.status[i];
+        uint8_t mflags = 0;
+        if (m.enabled)  { mflags |= 0x01; }
+        if (m.hasFault) { mflags |= 0x02; }
+        if (m.stale)    { mflags |= 0x04; }
+
+        putU8(p, motors.ids[i]);
+        putU8(p, mflags);
+        putU8(p, m.mode);
+        putU8(p, m.runMode);
+        putU8(p, m.errorCode);
+        putU8(p, 0);
+        putU16(p, 0);
+        putF32(p, m.position);
+        putF32(p, m.velocity);
+        putF32(p, m.torque);
+        putF32(p, m.temperature);
+        putF32(p, m.voltage);
+        putF32(p, m.ppSpeed);
+        putF32(p, m.ppAccel);
+        putF32(p, m.limitSpd);
+        putF32(p, m.limitCur);
+        putU32(p, m.intervalUs);
+        putU32(p, m.jitterUs);
+        putU32(p, m.rttUs);
+    }
+
+    return (int)(p - buf);
+}
+
+// httpd task only
+void WebTelemetry::broadcast(const uint8_t* buf, int len) {
+    int fds[WEB_WS_MAX_CLIENTS];
+    portENTER_CRITICAL(&_clientLock);
+    memcpy(fds, _clientFds, sizeof(fds));
+    portEXIT_CRITICAL(&_clientLock);
+
+    httpd_ws_frame_t frame = {};
+    frame.type = HTTPD_WS_TYPE_BINARY;
+    frame.payload = (uint8_t*)buf;
+    frame.len = len;
+
+    for (int i = 0; i < WEB_WS_MAX_CLIENTS; i++) {
+        int fd = fds[i];
+        if (fd < 0) {
+            continue;
+        }
+        // The socket may have closed (or been reused for plain HTTP)
+        if (httpd_ws_get_fd_info(_server, fd) != HTTPD_WS_CLIENT_WEBSOCKET ||
+            httpd_ws_send_frame_async(_server, fd, &frame) != ESP_OK) {
+            removeClient(fd);
+        }
+    }
+}
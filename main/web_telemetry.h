@@ -0,0 +1,97 @@
+#pragma once
+
+// =============================================================================
+// Web Telemetry Module
+// =============================================================================
+// Binary telemetry stream over a WebSocket at /ws (esp_http_server's native
+// WebSocket support). A low-priority task packs one frame into a static
+// buffer at WEB_WS_RATE_HZ and hands it to the httpd task with
+// httpd_queue_work(), which pushes it to every connected client. The
+// dashboard no longer polls /status and nothing is allocated per frame.
+//
+// Every socket write happens on the httpd task, so a send never races the
+// server closing or reusing the fd, or writing its own ping/close frames.
+// While a frame is still queued the next one is skipped rather than
+// overwriting the buffer.
+//
+// A client may change the stream rate by sending a text message "hz=<n>"
+// (clamped to 1..WEB_WS_MAX_RATE_HZ). The rate is shared by all clients.
+//
+// Frame layout, version 1 (little-endian, no padding):
+//
+//   Header (12 B)
+//     u8  version           WEB_TELEMETRY_VERSION
+//     u8  controllerCount   Number of controller records that follow
+//     u8  motorCount        Number of motor records that follow
+//     u8  flags             bit0 canRunning, bit1 upsideDown, bit2 balancing
+//     u32 seq               Frame counter
+//     u32 uptimeMs
+//   Attitude + state (16 B)
+//     f32 pitch             rad (fused)
+//     f32 pitchRate         rad/s
+//     f32 accelPitch        rad (raw accelerometer)
+//     u8  selfRightState, u8 noseDownState, i8 rssi (dBm), u8 reserved
+//   Drive (12 B)
+//     u16 leftPulse, u16 rightPulse (us), f32 leftDrive, f32 rightDrive
+//   System (12 B)
+//     u32 freeHeap, u32 freePsram, u8 leftMotorId, u8 rightMotorId, u16 reserved
+//   Controller record (16 B) x controllerCount
+//     u8  connected, u8 dpad, i16 lx, ly, rx, ry, l2, r2, u16 buttons
+//   Motor record (56 B) x motorCount
+//     u8  id, u8 flags (bit0 enabled, bit1 fault, bit2 stale), u8 mode,
+//     u8  runMode, u8 errorCode, u8 reserved[3]
+//     f32 position, velocity, torque, temperature, voltage,
+//         ppSpeed, ppAccel, limitSpd, limitCur
+//     u32 intervalUs, jitterUs, rttUs
+//
+// Strings (SSID, IP, controller model names) are not streamed; the
+// dashboard still fetches /status for them when it (re)connects.
+//
+// Usage (from WebServerManager::begin):
+//   s_telemetry.begin(server);   // Registers /ws and starts the push task
+// =============================================================================
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_http_server.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+
+#define WEB_TELEMETRY_VERSION    1
+
+class WebTelemetry {
+public:
+    // Register the /ws handler on a running server and spawn the push task.
+    void begin(httpd_handle_t server);
+
+    // Number of connected WebSocket clients
+    int getClientCount() const;
+
+    // Current stream rate (Hz)
+    int getRateHz() const { return _rateHz.load(std::memory_order_relaxed); }
+
+private:
+    httpd_handle_t _server = NULL;
+
+    // Connected client sockets (-1 = free). Written only by the httpd task:
+    // added on handshake, removed when a send fails.
+    int _clientFds[WEB_WS_MAX_CLIENTS];
+    mutable portMUX_TYPE _clientLock;
+
+    std::atomic<int> _rateHz{WEB_WS_RATE_HZ};
+    uint32_t _seq = 0;
+
+    // Frame handed to the httpd task: set by the telemetry task when it
+    // queues the send, cleared by the httpd task once the frame is out
+    std::atomic<bool> _sendPending{false};
+    int _frameLen = 0;
+
+    void addClient(int fd);
+    void removeClient(int fd);
+    int buildFrame(uint8_t* buf);
+    void broadcast(const uint8_t* buf, int len);
+
+    static esp_err_t wsHandler(httpd_req_t* req);
+    static void sendWork(void* arg);
+    static void telemetryTaskFunc(void* param);
+};
@@ -266,6 +266,11 @@ static const char WEB_UI_HTML[] PROGMEM = R"rawliteral(
     text-align: center;
     margin-top: 12px;
   }
+  #pitch-plot {
+    width: 100%;
+    height: 90px;
+    display: block;
+  }
   .robot-diagram {
     display: flex;
     flex-direction: column;
@@ -366,6 +371,11 @@ static const char WEB_UI_HTML[] PROGMEM = R"rawliteral(
     </div>
   </div>
 
+  <div class="card">
+    <h2>Pitch <span id="pitch-val">--</span></h2>
+    <canvas id="pitch-plot" width="300" height="90"></canvas>
+  </div>
+
   <div class="card">
     <h2>Drive Output</h2>
     <div class="motor-row">
@@ -403,7 +413,15 @@ static const char WEB_UI_HTML[] PROGMEM = R"rawliteral(
   var statusEl = document.getElementById('poll-status');
   var ok = false;
   var fails = 0;
-
+  var ws = null;
+  var wsOpen = false;
+  var models = {};        // Controller model names by slot (strings aren't streamed)
+  var lastConnected = -1;
+  var pitchHistory = [];
+  var PITCH_HISTORY_LEN = 250;
+
+  // Full /status fetch: used for strings (WiFi, controller models) and as a
+  // fallback while the WebSocket is down
   function poll() {
     fetch('/status')
       .then(function(r) { return r.json(); })
@@ -411,8 +429,18 @@ static const char WEB_UI_HTML[] PROGMEM = R"rawliteral(
         ok = true;
         fails = 0;
         dot.classList.add('ok');
-        statusEl.textContent = 'Connected';
-        updateUI(d);
+        if (!wsOpen) statusEl.textContent = 'Connected (polling)';
+        if (d.controllers) {
+          for (var i = 0; i < d.controllers.length; i++) {
+            if (d.controllers[i].model) models[d.controllers[i].id] = d.controllers[i].model;
+          }
+        }
+        if (wsOpen) {
+          // Only take the string fields; live values come from /ws
+          updateUI({ wifi: d.wifi });
+        } else {
+          updateUI(d);
+        }
       })
       .catch(function() {
         fails++;
@@ -424,6 +452,142 @@ static const char WEB_UI_HTML[] PROGMEM = R"rawliteral(
       });
   }
 
+  // ---- Binary telemetry (/ws) ----
+  // Layout must match web_telemetry.h (version 1, little-endian)
+  var TELEMETRY_VERSION = 1;
+
+  function decodeFrame(buf) {
+    var v = new DataView(buf);
+    var o = 0;
+    function u8()  { var x = v.getUint8(o); o += 1; return x; }
+    function i8()  { var x = v.getInt8(o); o += 1; return x; }
+    function u16() { var x = v.getUint16(o, true); o += 2; return x; }
+    function i16() { var x = v.getInt16(o, true); o += 2; return x; }
+    function u32() { var x = v.getUint32(o, true); o += 4; return x; }
+    function f32() { var x = v.getFloat32(o, true); o += 4; return x; }
+
+    if (u8() !== TELEMETRY_VERSION) return null;
+    var nCtrl = u8();
+    var nMotor = u8();
+    var flags = u8();
+    var d = { seq: u32(), uptimeMs: u32() };
+    d.canRunning = !!(flags & 1);
+    d.flipped = !!(flags & 2);
+    d.balancing = !!(flags & 4);
+
+    d.pitch = f32();
+    d.pitchRate = f32();
+    d.accelPitch = f32();
+    d.sr = u8();
+    d.nd = u8();
+    var rssi = i8();
+    u8();
+
+    d.drive = { left: u16(), right: u16() };
+    d.drive.leftDrive = f32();
+    d.drive.rightDrive = f32();
+
+    d.system = { free_heap: u32(), free_psram: u32() };
+    d.system.uptime_s = Math.floor(d.uptimeMs / 1000);
+    var leftId = u8();
+    var rightId = u8();
+    u16();
+
+    d.controllers = [];
+    for (var c = 0; c < nCtrl; c++) {
+      var ctrl = { id: c, connected: !!u8(), dpad: u8() };
+      ctrl.lx = i16(); ctrl.ly = i16(); ctrl.rx = i16(); ctrl.ry = i16();
+      ctrl.l2 = i16(); ctrl.r2 = i16();
+      ctrl.buttons = u16();
+      ctrl.model = models[c];
+      d.controllers.push(ctrl);
+    }
+
+    d.motors = [];
+    for (var m = 0; m < nMotor; m++) {
+      var mot = { id: u8() };
+      var mf = u8();
+      mot.enabled = !!(mf & 1);
+      mot.hasFault = !!(mf & 2);
+      mot.stale = !!(mf & 4);
+      mot.mode = u8();
+      mot.runMode = u8();
+      mot.errorCode = u8();
+      u8(); u16();
+      mot.position = f32(); mot.velocity = f32(); mot.torque = f32();
+      mot.temperature = f32(); mot.voltage = f32();
+      mot.ppSpeed = f32(); mot.ppAccel = f32();
+      mot.limitSpd = f32(); mot.limitCur = f32();
+      mot.intervalUs = u32(); mot.jitterUs = u32(); mot.rttUs = u32();
+      mot.role = (mot.id === leftId) ? 'L' : ((mot.id === rightId) ? 'R' : '');
+      d.motors.push(mot);
+    }
+    if (rssi !== 0) d.rssi = rssi;
+    return d;
+  }
+
+  function connectWs() {
+    ws = new WebSocket('ws://' + location.host + '/ws');
+    ws.binaryType = 'arraybuffer';
+    ws.onopen = function() {
+      wsOpen = true;
+      lastConnected = -1;
+      dot.classList.add('ok');
+      statusEl.textContent = 'Connected (live)';
+      poll();
+    };
+    ws.onmessage = function(ev) {
+      if (typeof ev.data === 'string') return;
+      var d = decodeFrame(ev.data);
+      if (!d) return;
+
+      // Controller set changed: refresh model names from /status
+      var n = d.controllers.filter(function(c) { return c.connected; }).length;
+      if (n !== lastConnected) {
+        lastConnected = n;
+        poll();
+      }
+      if (d.rssi !== undefined) setText('wifi-rssi', d.rssi + ' dBm');
+      updatePitch(d.pitch);
+      updateUI(d);
+    };
+    ws.onclose = function() {
+      wsOpen = false;
+      statusEl.textContent = 'Live stream lost, polling...';
+      setTimeout(connectWs, 2000);
+    };
+    ws.onerror = function() {
+      ws.close();
+    };
+  }
+
+  function updatePitch(pitch) {
+    var deg = pitch * 180 / Math.PI;
+    setText('pitch-val', deg.toFixed(1) + '\u00b0');
+    pitchHistory.push(deg);
+    if (pitchHistory.length > PITCH_HISTORY_LEN) pitchHistory.shift();
+
+    var cv = document.getElementById('pitch-plot');
+    if (!cv) return;
+    var g = cv.getContext('2d');
+    var w = cv.width, h = cv.height;
+    g.clearRect(0, 0, w, h);
+    // Grid: 0 (level) and -90 (nose-down setpoint), range -180..180
+    g.strokeStyle = '#2a2d37';
+    g.beginPath();
+    g.moveTo(0, h / 2); g.lineTo(w, h / 2);
+    g.moveTo(0, h * 0.75); g.lineTo(w, h * 0.75);
+    g.stroke();
+    g.strokeStyle = '#4caf50';
+    g.beginPath();
+    for (var i = 0; i < pitchHistory.length; i++) {
+      var x = i * w / (PITCH_HISTORY_LEN - 1);
+      var y = h / 2 - (pitchHistory[i] / 180) * (h / 2);
+      if (i === 0) g.moveTo(x, y); else g.lineTo(x, y);
+    }
+    g.stroke();
+  }
+
   function updateUI(d) {
     if (d.wifi) {
       setText('wifi-ssid', d.wifi.ssid || '--');
@@ -668,9 +832,10 @@ static const char WEB_UI_HTML[] PROGMEM = R"rawliteral(
     return b + ' B';
   }
 
-  // Poll at 4Hz
-  setInterval(poll, 250);
+  // Live stream over /ws; fall back to 4Hz /status polling while it's down
+  setInterval(function() { if (!wsOpen) poll(); }, 250);
   poll();
+  connectWs();
 })();
 </script>
 </body>
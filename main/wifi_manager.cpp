@@ -95,6 +95,15 @@ String WiFiManager::getIP() const {
     return "0.0.0.0";
 }
 
+void WiFiManager::formatIP(char* out, size_t size) const {
+    if (isConnected()) {
+        IPAddress ip = WiFi.localIP();
+        snprintf(out, size, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    } else {
+        snprintf(out, size, "0.0.0.0");
+    }
+}
+
 int WiFiManager::getRSSI() const {
     if (isConnected()) {
         return WiFi.RSSI();
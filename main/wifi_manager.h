@@ -31,6 +31,9 @@ public:
     // Returns the current IP address as a string (or "0.0.0.0" if not connected).
     String getIP() const;
 
+    // Same as getIP(), formatted into a caller buffer (no heap allocation).
+    void formatIP(char* out, size_t size) const;
+
     // Returns the WiFi RSSI (signal strength) in dBm.
     // Returns 0 if not connected.
     int getRSSI() const;
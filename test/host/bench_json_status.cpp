@@ -0,0 +1,378 @@
+// =============================================================================
+// /status serialization benchmark: JsonWriter vs ArduinoJson
+// =============================================================================
+// Serializes the /status document from a fixed fixture (one connected
+// controller out of CONTROLLER_MAX_COUNT, two motors) both ways and reports
+// bytes, time per document and heap churn per document:
+//
+//   - JsonWriter into a static buffer, as writeStatusJson() in web_server.cpp
+//   - ArduinoJson 7 JsonDocument + String output, as the old
+//     buildStatusJson() did (serialized(String(v, n)) for fixed decimals)
+//
+// The ArduinoJson half is built when the library is found (see
+// CMakeLists.txt; PlatformIO keeps it in .pio/libdeps after a firmware
+// build). Then the two outputs must also be byte-identical.
+//
+// Heap churn counts every operator new and every ArduinoJson allocator call.
+// std::string stands in for Arduino's String; both keep short strings inline.
+//
+// Usage: bench_json_status [iterations]
+// Exit code is non-zero if JsonWriter overflowed or allocated, or the
+// outputs differ.
+// =============================================================================
+
+#include "config.h"
+#include "json_writer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+#if HAVE_ARDUINOJSON
+#include <ArduinoJson.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// Heap accounting
+// -----------------------------------------------------------------------------
+
+static size_t s_allocCount = 0;
+static size_t s_allocBytes = 0;
+
+void* operator new(size_t size) {
+    s_allocCount++;
+    s_allocBytes += size;
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// -----------------------------------------------------------------------------
+// Fixture -- the values writeStatusJson() reads from the managers
+// -----------------------------------------------------------------------------
+
+struct FixtureController {
+    bool connected;
+    const char* model;
+    int16_t lx, ly, rx, ry, l2, r2;
+    uint16_t buttons;
+    uint8_t dpad;
+};
+
+struct FixtureMotor {
+    uint8_t id;
+    const char* role;
+    float position, velocity, torque, temperature, voltage;
+    uint8_t mode, runMode;
+    bool enabled;
+    uint8_t errorCode;
+    bool hasFault, stale;
+    float ppSpeed, ppAccel, limitSpd, limitCur;
+    uint32_t intervalUs, jitterUs, rttUs;
+};
+
+struct Fixture {
+    const char* ssid;
+    const char* ip;
+    int rssi;
+    FixtureController controllers[CONTROLLER_MAX_COUNT];
+    uint16_t leftPulse, rightPulse;
+    float leftDrive, rightDrive;
+    FixtureMotor motors[2];
+    int motorCount;
+    bool canRunning;
+    uint8_t leftId, rightId;
+    unsigned long uptimeS, freeHeap, freePsram;
+};
+
+static const Fixture FIXTURE = {
+    "JumpRope-AP", "192.168.4.1", -58,
+    {
+        {true, "8BitDo Ultimate 2C", -12, 340, 0, -511, 0, 1023, 0x0204, 0x01},
+        {false, "", 0, 0, 0, 0, 0, 0, 0, 0},
+        {false, "", 0, 0, 0, 0, 0, 0, 0, 0},
+        {false, "", 0, 0, 0, 0, 0, 0, 0, 0},
+    },
+    1623, 1377, 0.4567f, -0.8123f,
+    {
+        {11, "L", -1.7912f, 0.125f, -0.43f, 38.25f, 24.1f, 2, 1, true, 0, false, false,
+         3.5f, 20.0f, 10.0f, 6.5f, 10012, 143, 412},
+        {12, "R", 1.7934f, -0.118f, 0.39f, 37.8f, 24.0f, 2, 1, true, 0, false, false,
+         3.5f, 20.0f, 10.0f, 6.5f, 9987, 151, 398},
+    },
+    2, true, 11, 12, 5321, 25755, 4128400,
+};
+
+// -----------------------------------------------------------------------------
+// JsonWriter path (keep in step with writeStatusJson() in web_server.cpp)
+// -----------------------------------------------------------------------------
+
+static char s_jsonBuf[WEB_JSON_BUFFER_SIZE];
+
+static size_t writeStatusJson(const Fixture& f, bool* overflowed) {
+    JsonWriter w(s_jsonBuf, sizeof(s_jsonBuf));
+    w.beginObject();
+
+    w.beginObject("wifi");
+    w.field("ssid", f.ssid);
+    w.field("ip", f.ip);
+    w.field("rssi", f.rssi);
+    w.endObject();
+
+    w.beginArray("controllers");
+    for (int i = 0; i < CONTROLLER_MAX_COUNT; i++) {
+        const FixtureController& c = f.controllers[i];
+        w.beginObject();
+        w.field("id", i);
+        w.field("connected", c.connected);
+        if (c.connected) {
+            w.field("model", c.model);
+            w.field("lx", c.lx);
+            w.field("ly", c.ly);
+            w.field("rx", c.rx);
+            w.field("ry", c.ry);
+            w.field("l2", c.l2);
+            w.field("r2", c.r2);
+            w.field("buttons", c.buttons);
+            w.field("dpad", c.dpad);
+        }
+        w.endObject();
+    }
+    w.endArray();
+
+    w.beginObject("drive");
+    w.field("left", f.leftPulse);
+    w.field("right", f.rightPulse);
+    w.field("leftDrive", f.leftDrive, 2);
+    w.field("rightDrive", f.rightDrive, 2);
+    w.endObject();
+
+    w.beginArray("motors");
+    for (int i = 0; i < f.motorCount; i++) {
+        const FixtureMotor& m = f.motors[i];
+        w.beginObject();
+        w.field("id", m.id);
+        w.field("role", m.role);
+        w.field("position", m.position, 3);
+        w.field("velocity", m.velocity, 2);
+        w.field("torque", m.torque, 2);
+        w.field("temperature", m.temperature, 1);
+        w.field("voltage", m.voltage, 1);
+        w.field("mode", m.mode);
+        w.field("runMode", m.runMode);
+        w.field("enabled", m.enabled);
+        w.field("errorCode", m.errorCode);
+        w.field("hasFault", m.hasFault);
+        w.field("stale", m.stale);
+        w.field("ppSpeed", m.ppSpeed, 2);
+        w.field("ppAccel", m.ppAccel, 1);
+        w.field("limitSpd", m.limitSpd, 2);
+        w.field("limitCur", m.limitCur, 2);
+        w.field("intervalUs", (unsigned long)m.intervalUs);
+        w.field("jitterUs", (unsigned long)m.jitterUs);
+        w.field("rttUs", (unsigned long)m.rttUs);
+        w.endObject();
+    }
+    w.endArray();
+    w.field("canRunning", f.canRunning);
+
+    w.beginObject("motorConfig");
+    w.field("leftId", f.leftId);
+    w.field("rightId", f.rightId);
+    w.endObject();
+
+    w.beginObject("system");
+    w.field("uptime_s", f.uptimeS);
+    w.field("free_heap", f.freeHeap);
+    w.field("free_psram", f.freePsram);
+    w.endObject();
+
+    w.endObject();
+    *overflowed = w.overflowed();
+    return w.length();
+}
+
+// -----------------------------------------------------------------------------
+// ArduinoJson path (the pre-JsonWriter buildStatusJson())
+// -----------------------------------------------------------------------------
+
+#if HAVE_ARDUINOJSON
+
+class CountingAllocator : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override {
+        s_allocCount++;
+        s_allocBytes += size;
+        return malloc(size);
+    }
+    void deallocate(void* ptr) override { free(ptr); }
+    void* reallocate(void* ptr, size_t newSize) override {
+        s_allocCount++;
+        s_allocBytes += newSize;
+        return realloc(ptr, newSize);
+    }
+};
+
+static CountingAllocator s_allocator;
+
+// String(v, decimals)
+static std::string fixed(float v, int decimals) {
+    char tmp[24];
+    snprintf(tmp, sizeof(tmp), "%.*f", decimals, (double)v);
+    return std::string(tmp);
+}
+
+static std::string buildStatusArduinoJson(const Fixture& f) {
+    JsonDocument doc(&s_allocator);
+
+    JsonObject wifi = doc["wifi"].to<JsonObject>();
+    wifi["ssid"] = f.ssid;
+    wifi["ip"] = std::string(f.ip);       // getIP() returned a String
+    wifi["rssi"] = f.rssi;
+
+    JsonArray controllers = doc["controllers"].to<JsonArray>();
+    for (int i = 0; i < CONTROLLER_MAX_COUNT; i++) {
+        const FixtureController& c = f.controllers[i];
+        JsonObject ctrl = controllers.add<JsonObject>();
+        ctrl["id"] = i;
+        ctrl["connected"] = c.connected;
+        if (c.connected) {
+            ctrl["model"] = c.model;
+            ctrl["lx"] = c.lx;
+            ctrl["ly"] = c.ly;
+            ctrl["rx"] = c.rx;
+            ctrl["ry"] = c.ry;
+            ctrl["l2"] = c.l2;
+            ctrl["r2"] = c.r2;
+            ctrl["buttons"] = c.buttons;
+            ctrl["dpad"] = c.dpad;
+        }
+    }
+
+    JsonObject drive = doc["drive"].to<JsonObject>();
+    drive["left"] = f.leftPulse;
+    drive["right"] = f.rightPulse;
+    drive["leftDrive"] = serialized(fixed(f.leftDrive, 2));
+    drive["rightDrive"] = serialized(fixed(f.rightDrive, 2));
+
+    JsonArray motors = doc["motors"].to<JsonArray>();
+    for (int i = 0; i < f.motorCount; i++) {
+        const FixtureMotor& m = f.motors[i];
+        JsonObject motor = motors.add<JsonObject>();
+        motor["id"] = m.id;
+        motor["role"] = m.role;
+        motor["position"] = serialized(fixed(m.position, 3));
+        motor["velocity"] = serialized(fixed(m.velocity, 2));
+        motor["torque"] = serialized(fixed(m.torque, 2));
+        motor["temperature"] = serialized(fixed(m.temperature, 1));
+        motor["voltage"] = serialized(fixed(m.voltage, 1));
+        motor["mode"] = m.mode;
+        motor["runMode"] = m.runMode;
+        motor["enabled"] = m.enabled;
+        motor["errorCode"] = m.errorCode;
+        motor["hasFault"] = m.hasFault;
+        motor["stale"] = m.stale;
+        motor["ppSpeed"] = serialized(fixed(m.ppSpeed, 2));
+        motor["ppAccel"] = serialized(fixed(m.ppAccel, 1));
+        motor["limitSpd"] = serialized(fixed(m.limitSpd, 2));
+        motor["limitCur"] = serialized(fixed(m.limitCur, 2));
+        motor["intervalUs"] = m.intervalUs;
+        motor["jitterUs"] = m.jitterUs;
+        motor["rttUs"] = m.rttUs;
+    }
+    doc["canRunning"] = f.canRunning;
+
+    JsonObject motorConfig = doc["motorConfig"].to<JsonObject>();
+    motorConfig["leftId"] = f.leftId;
+    motorConfig["rightId"] = f.rightId;
+
+    JsonObject sys = doc["system"].to<JsonObject>();
+    sys["uptime_s"] = f.uptimeS;
+    sys["free_heap"] = f.freeHeap;
+    sys["free_psram"] = f.freePsram;
+
+    std::string output;
+    serializeJson(doc, output);
+    return output;
+}
+
+#endif  // HAVE_ARDUINOJSON
+
+// -----------------------------------------------------------------------------
+
+struct BenchResult {
+    size_t bytes;
+    double nsPerDoc;
+    double allocsPerDoc;
+    double heapBytesPerDoc;
+};
+
+template <typename Fn>
+static BenchResult run(int iterations, Fn fn) {
+    BenchResult r = {};
+    r.bytes = fn();                                 // Warm-up
+    size_t count0 = s_allocCount;
+    size_t bytes0 = s_allocBytes;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        r.bytes = fn();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    r.nsPerDoc = ns / iterations;
+    r.allocsPerDoc = (double)(s_allocCount - count0) / iterations;
+    r.heapBytesPerDoc = (double)(s_allocBytes - bytes0) / iterations;
+    return r;
+}
+
+static void print(const char* name, const BenchResult& r) {
+    printf("%-12s %6zu B  %9.0f ns/doc  %6.1f allocs/doc  %8.0f heap B/doc\n",
+           name, r.bytes, r.nsPerDoc, r.allocsPerDoc, r.heapBytesPerDoc);
+}
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 100000;
+    if (iterations < 1) {
+        iterations = 1;
+    }
+    int failures = 0;
+
+    bool overflowed = false;
+    BenchResult writer = run(iterations, [&] { return writeStatusJson(FIXTURE, &overflowed); });
+    print("JsonWriter", writer);
+    if (overflowed) {
+        printf("JsonWriter overflowed WEB_JSON_BUFFER_SIZE (%d)\n", WEB_JSON_BUFFER_SIZE);
+        failures++;
+    }
+    if (writer.allocsPerDoc != 0.0) {
+        printf("JsonWriter allocated\n");
+        failures++;
+    }
+
+#if HAVE_ARDUINOJSON
+    std::string reference;
+    BenchResult aj = run(iterations, [&] {
+        reference = buildStatusArduinoJson(FIXTURE);
+        return reference.size();
+    });
+    print("ArduinoJson", aj);
+    printf("speedup %.1fx, %zu fewer bytes\n", aj.nsPerDoc / writer.nsPerDoc,
+           aj.bytes - writer.bytes);
+    if (reference != std::string(s_jsonBuf)) {
+        printf("Outputs differ:\n  JsonWriter:  %s\n  ArduinoJson: %s\n", s_jsonBuf, reference.c_str());
+        failures++;
+    }
+#else
+    printf("ArduinoJson not found -- JsonWriter only (configure with -DARDUINOJSON_DIR=...)\n");
+#endif
+
+    return failures == 0 ? 0 : 1;
+}
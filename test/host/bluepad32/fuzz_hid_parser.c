@@ -0,0 +1,71 @@
+// =============================================================================
+// libFuzzer entry point for the HID parser layer
+// =============================================================================
+// Input: descriptor length (2 bytes, little endian), the descriptor, then
+// reports as a length byte plus that many bytes (see hid_capture.h). The
+// descriptor goes through uni_hid_parser_compile_plan() and every report
+// through uni_hid_parse_input_report() with the 8BitDo callbacks, the same
+// path a paired controller drives on the robot. Each report is also checked
+// against the descriptor walk (hid_equiv.h); a difference aborts.
+//
+// Inputs whose descriptor doesn't compile into a plan are skipped: the
+// descriptor-walk fallback is BTstack's parser, which reads past the end of
+// reports that are shorter than the descriptor says, and would only report
+// that known issue over and over.
+//
+// Built as "fuzz_hid_parser" with Clang (-fsanitize=fuzzer). Other
+// compilers link fuzz_main.c instead, which runs the same entry point over
+// the captures and mutations of them.
+// =============================================================================
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hid_equiv.h"
+#include "parser/uni_hid_parser_8bitdo.h"
+#include "uni_hid_device.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static uni_hid_device_t device;
+
+    if (size < 2)
+        return 0;
+    size_t descriptor_len = data[0] | (data[1] << 8);
+    if (descriptor_len > HID_MAX_DESCRIPTOR_LEN || descriptor_len > size - 2)
+        return 0;
+
+    memset(&device, 0, sizeof(device));
+    memcpy(device.hid_descriptor, data + 2, descriptor_len);
+    device.hid_descriptor_len = descriptor_len;
+    device.report_parser.init_report = uni_hid_parser_8bitdo_init_report;
+    device.report_parser.parse_usage = uni_hid_parser_8bitdo_parse_usage;
+    uni_hid_parser_compile_plan(&device.report_plan, device.hid_descriptor, device.hid_descriptor_len);
+    if (!device.report_plan.valid)
+        return 0;
+
+    // Each report in its own allocation, so that a read past its end is
+    // caught by the sanitizer instead of landing in the next one
+    size_t pos = 2 + descriptor_len;
+    while (pos < size) {
+        size_t len = data[pos++];
+        if (len > size - pos)
+            len = size - pos;
+        uint8_t* report = malloc(len ? len : 1);
+        memcpy(report, data + pos, len);
+        uni_hid_parse_input_report(&device, report, len);
+
+        char why[256];
+        if (hid_equiv_check(&device, report, len, why, sizeof(why)) == HID_EQUIV_DIFFERENT) {
+            fprintf(stderr, "plan and descriptor walk differ: %s\n", why);
+            abort();
+        }
+        free(report);
+        pos += len;
+    }
+    return 0;
+}
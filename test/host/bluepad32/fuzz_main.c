@@ -0,0 +1,89 @@
+// =============================================================================
+// Standalone driver for LLVMFuzzerTestOneInput (no libFuzzer)
+// =============================================================================
+// Runs the fuzz entry point over each capture and a fixed number of
+// deterministic mutations of it (byte flips, truncation, inserted bytes),
+// so compilers without -fsanitize=fuzzer still exercise it under ASan/UBSan
+// as part of ctest.
+//
+//   fuzz_hid_parser <iterations> <capture.hid>...
+// =============================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hid_capture.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static uint32_t s_rng = 0x9e3779b9u;
+
+static uint32_t next_random(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// Mutates "buf" in place (within "capacity"). Returns the new length.
+static size_t mutate(uint8_t* buf, size_t len, size_t capacity) {
+    int edits = 1 + next_random() % 4;
+    for (int i = 0; i < edits && len > 2; i++) {
+        size_t at = 2 + next_random() % (len - 2);
+        switch (next_random() % 4) {
+            case 0:  // Flip bits
+                buf[at] ^= (uint8_t)(1u << (next_random() % 8));
+                break;
+            case 1:  // Random byte
+                buf[at] = (uint8_t)next_random();
+                break;
+            case 2:  // Insert a byte
+                if (len < capacity) {
+                    memmove(buf + at + 1, buf + at, len - at);
+                    buf[at] = (uint8_t)next_random();
+                    len++;
+                }
+                break;
+            default:  // Truncate
+                len = at;
+                break;
+        }
+    }
+    return len;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: fuzz_hid_parser <iterations> <capture.hid>...\n");
+        return 2;
+    }
+    long iterations = atol(argv[1]);
+
+    static uint8_t seed[1 << 16];
+    static uint8_t input[sizeof(seed)];
+    for (int f = 2; f < argc; f++) {
+        hid_capture_t cap;
+        if (hid_capture_load(&cap, argv[f]) != 0)
+            return 1;
+        size_t seed_len = hid_capture_to_fuzz_input(&cap, seed, sizeof(seed));
+        hid_capture_free(&cap);
+        if (seed_len == 0) {
+            fprintf(stderr, "%s: too large for a fuzzer input\n", argv[f]);
+            return 1;
+        }
+
+        LLVMFuzzerTestOneInput(seed, seed_len);
+        for (long i = 0; i < iterations; i++) {
+            memcpy(input, seed, seed_len);
+            size_t len = mutate(input, seed_len, sizeof(input));
+            // Exact-size copy so reads past the end are caught
+            uint8_t* exact = malloc(len);
+            memcpy(exact, input, len);
+            LLVMFuzzerTestOneInput(exact, len);
+            free(exact);
+        }
+        printf("%s: %ld inputs ok\n", argv[f], iterations + 1);
+    }
+    return 0;
+}
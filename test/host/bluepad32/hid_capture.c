@@ -0,0 +1,102 @@
+#include "hid_capture.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Parses the hex bytes after the line prefix. Returns the count, or -1.
+static int parse_hex(const char* s, uint8_t* out, int max) {
+    int n = 0;
+    for (;;) {
+        while (isspace((unsigned char)*s))
+            s++;
+        if (*s == '\0')
+            return n;
+        if (!isxdigit((unsigned char)s[0]) || !isxdigit((unsigned char)s[1]) || n == max)
+            return -1;
+        char byte[3] = {s[0], s[1], '\0'};
+        out[n++] = (uint8_t)strtoul(byte, NULL, 16);
+        s += 2;
+    }
+}
+
+int hid_capture_load(hid_capture_t* cap, const char* path) {
+    memset(cap, 0, sizeof(*cap));
+
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    int capacity = 0;
+    int line_no = 0;
+    char line[4096];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        line_no++;
+        if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+            continue;
+
+        int n;
+        if (line[0] == 'd' && line[1] == ' ') {
+            n = parse_hex(line + 2, cap->descriptor + cap->descriptor_len,
+                          HID_MAX_DESCRIPTOR_LEN - cap->descriptor_len);
+            if (n >= 0)
+                cap->descriptor_len += n;
+        } else if (line[0] == 'r' && line[1] == ' ') {
+            if (cap->report_count == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                cap->reports = realloc(cap->reports, capacity * sizeof(*cap->reports));
+            }
+            hid_capture_report_t* r = &cap->reports[cap->report_count];
+            n = parse_hex(line + 2, r->data, HID_CAPTURE_MAX_REPORT_LEN);
+            if (n > 0) {
+                r->len = n;
+                cap->report_count++;
+            }
+        } else {
+            n = -1;
+        }
+        if (n <= 0) {
+            fprintf(stderr, "%s:%d: bad line\n", path, line_no);
+            fclose(f);
+            hid_capture_free(cap);
+            return -1;
+        }
+    }
+    fclose(f);
+
+    if (cap->descriptor_len == 0) {
+        fprintf(stderr, "%s: no descriptor\n", path);
+        hid_capture_free(cap);
+        return -1;
+    }
+    return 0;
+}
+
+void hid_capture_free(hid_capture_t* cap) {
+    free(cap->reports);
+    cap->reports = NULL;
+    cap->report_count = 0;
+}
+
+size_t hid_capture_to_fuzz_input(const hid_capture_t* cap, uint8_t* out, size_t size) {
+    size_t pos = 0;
+    if (size < 2u + cap->descriptor_len)
+        return 0;
+    out[pos++] = cap->descriptor_len & 0xff;
+    out[pos++] = cap->descriptor_len >> 8;
+    memcpy(out + pos, cap->descriptor, cap->descriptor_len);
+    pos += cap->descriptor_len;
+
+    for (int i = 0; i < cap->report_count; i++) {
+        const hid_capture_report_t* r = &cap->reports[i];
+        if (pos + 1 + r->len > size)
+            return 0;
+        out[pos++] = (uint8_t)r->len;
+        memcpy(out + pos, r->data, r->len);
+        pos += r->len;
+    }
+    return pos;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// =============================================================================
+// HID capture files
+// =============================================================================
+// A captured descriptor plus input-report stream, as text:
+//
+//   # comment
+//   d 05 01 09 05 a1 01 85 03 ...      descriptor bytes (lines concatenate)
+//   r 03 80 80 80 80 0f 00 00 00 00    one input report, report ID first
+//
+// The hex is what BTstack's printf_hexdump() prints, so a capture is the
+// descriptor and report dumps from the device with "d "/"r " prefixed.
+//
+// The same data packs into the libFuzzer input format used by
+// fuzz_hid_parser.c: descriptor length (2 bytes, little endian), the
+// descriptor, then each report as a length byte plus its bytes.
+// =============================================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "uni_hid_device.h"
+
+#define HID_CAPTURE_MAX_REPORT_LEN 255
+
+typedef struct {
+    uint16_t len;
+    uint8_t data[HID_CAPTURE_MAX_REPORT_LEN];
+} hid_capture_report_t;
+
+typedef struct {
+    uint8_t descriptor[HID_MAX_DESCRIPTOR_LEN];
+    uint16_t descriptor_len;
+    hid_capture_report_t* reports;
+    int report_count;
+} hid_capture_t;
+
+// Returns 0 on success. Errors are printed with the file name and line.
+int hid_capture_load(hid_capture_t* cap, const char* path);
+void hid_capture_free(hid_capture_t* cap);
+
+// Packs the capture as a fuzzer input. Returns the bytes written, or 0 if
+// "out" is too small.
+size_t hid_capture_to_fuzz_input(const hid_capture_t* cap, uint8_t* out, size_t size);
@@ -0,0 +1,138 @@
+#include "hid_equiv.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_CALLS 512
+#define MAX_REPORT_LEN 1024
+
+typedef struct {
+    hid_globals_t globals;
+    uint16_t usage_page;
+    uint16_t usage;
+    int32_t value;
+} usage_call_t;
+
+typedef struct {
+    usage_call_t calls[MAX_CALLS];
+    int count;
+} call_log_t;
+
+static call_log_t* s_log;
+static report_parse_usage_fn_t s_forward;
+
+static void record_usage(struct uni_hid_device_s* d,
+                         const hid_globals_t* globals,
+                         uint16_t usage_page,
+                         uint16_t usage,
+                         int32_t value) {
+    if (s_log->count < MAX_CALLS) {
+        usage_call_t* c = &s_log->calls[s_log->count];
+        memset(c, 0, sizeof(*c));
+        c->globals.logical_minimum = globals->logical_minimum;
+        c->globals.logical_maximum = globals->logical_maximum;
+        c->globals.usage_page = globals->usage_page;
+        c->globals.report_size = globals->report_size;
+        c->globals.report_count = globals->report_count;
+        c->globals.report_id = globals->report_id;
+        c->usage_page = usage_page;
+        c->usage = usage;
+        c->value = value;
+    }
+    s_log->count++;
+    s_forward(d, globals, usage_page, usage, value);
+}
+
+// Bytes the plan reads for this report: the end of its last field. -1 if a
+// field is 32 bits wide or spans 5 bytes: BTstack shifts by 32 for those,
+// which is undefined.
+static int plan_bytes_needed(const uni_hid_report_plan_t* plan, const uint8_t* report) {
+    int needed = 0;
+    for (int i = 0; i < plan->entry_count; i++) {
+        const uni_hid_report_plan_entry_t* entry = &plan->entries[i];
+        if (entry->report_id != HID_REPORT_ID_UNDEFINED && entry->report_id != report[0])
+            continue;
+        for (int j = 0; j < entry->op_count; j++) {
+            const uni_hid_report_op_t* op = &plan->ops[entry->first_op + j];
+            if (op->size >= 32 || (op->bit_pos & 7) + op->size > 32)
+                return -1;
+            int end = (op->bit_pos + op->size + 7) / 8;
+            if (end > needed)
+                needed = end;
+        }
+    }
+    return needed;
+}
+
+void hid_equiv_parse_walk(uni_hid_device_t* d, const uint8_t* report, uint16_t report_len) {
+    bool valid = d->report_plan.valid;
+    d->report_plan.valid = false;
+    uni_hid_parse_input_report(d, report, report_len);
+    d->report_plan.valid = valid;
+}
+
+static void parse_logged(uni_hid_device_t* d,
+                         const uint8_t* report,
+                         uint16_t report_len,
+                         bool walk,
+                         call_log_t* log,
+                         uni_controller_t* state) {
+    s_log = log;
+    s_log->count = 0;
+    s_forward = d->report_parser.parse_usage;
+    d->report_parser.parse_usage = record_usage;
+    if (walk)
+        hid_equiv_parse_walk(d, report, report_len);
+    else
+        uni_hid_parse_input_report(d, report, report_len);
+    d->report_parser.parse_usage = s_forward;
+    *state = d->controller;
+}
+
+hid_equiv_result_t hid_equiv_check(uni_hid_device_t* d,
+                                   const uint8_t* report,
+                                   uint16_t report_len,
+                                   char* why,
+                                   size_t why_size) {
+    static call_log_t plan_log, walk_log;
+    static uint8_t padded[MAX_REPORT_LEN + 8];
+
+    if (!d->report_plan.valid || report_len == 0 || report_len > sizeof(padded) - 8)
+        return HID_EQUIV_NOT_COMPARABLE;
+    int needed = plan_bytes_needed(&d->report_plan, report);
+    if (needed < 0 || needed > report_len)
+        return HID_EQUIV_NOT_COMPARABLE;
+
+    // BTstack reads up to a byte past a field that ends on the last byte
+    memset(padded, 0, sizeof(padded));
+    memcpy(padded, report, report_len);
+
+    uni_controller_t plan_state, walk_state;
+    parse_logged(d, padded, report_len, false, &plan_log, &plan_state);
+    parse_logged(d, padded, report_len, true, &walk_log, &walk_state);
+
+    if (plan_log.count != walk_log.count) {
+        snprintf(why, why_size, "%d parse_usage calls with the plan, %d with the walk", plan_log.count,
+                 walk_log.count);
+        return HID_EQUIV_DIFFERENT;
+    }
+    int logged = plan_log.count < MAX_CALLS ? plan_log.count : MAX_CALLS;
+    for (int i = 0; i < logged; i++) {
+        const usage_call_t* p = &plan_log.calls[i];
+        const usage_call_t* w = &walk_log.calls[i];
+        if (memcmp(p, w, sizeof(*p)) != 0) {
+            snprintf(why, why_size,
+                     "call %d: plan page=%04x usage=%04x value=%d min=%d max=%d, "
+                     "walk page=%04x usage=%04x value=%d min=%d max=%d",
+                     i, p->usage_page, p->usage, (int)p->value, (int)p->globals.logical_minimum,
+                     (int)p->globals.logical_maximum, w->usage_page, w->usage, (int)w->value,
+                     (int)w->globals.logical_minimum, (int)w->globals.logical_maximum);
+            return HID_EQUIV_DIFFERENT;
+        }
+    }
+    if (memcmp(&plan_state, &walk_state, sizeof(plan_state)) != 0) {
+        snprintf(why, why_size, "same calls, different controller state");
+        return HID_EQUIV_DIFFERENT;
+    }
+    return HID_EQUIV_SAME;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// =============================================================================
+// Report plan vs descriptor walk
+// =============================================================================
+// Parses one report both ways -- through the compiled uni_hid_report_plan_t
+// and through BTstack's descriptor walk -- and checks that the device's
+// parse_usage callback saw the same calls (usage page, usage, value and
+// globals, in order) and left the same controller state.
+//
+// Only reports that hold every field of their report ID are comparable:
+// the plan skips fields past the end of a short report, the walk reads
+// them from beyond it (here from zero padding). Reports with fields that
+// are 32 bits wide or span 5 bytes aren't compared either: BTstack's
+// extraction is undefined for them.
+// =============================================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "uni_hid_device.h"
+
+typedef enum {
+    HID_EQUIV_SAME,
+    HID_EQUIV_DIFFERENT,
+    HID_EQUIV_NOT_COMPARABLE,  // No plan, short report or too-wide field
+} hid_equiv_result_t;
+
+// "d" needs its descriptor, plan and report_parser set. On
+// HID_EQUIV_DIFFERENT, "why" describes the first difference.
+hid_equiv_result_t hid_equiv_check(uni_hid_device_t* d,
+                                   const uint8_t* report,
+                                   uint16_t report_len,
+                                   char* why,
+                                   size_t why_size);
+
+// Parses the report with the descriptor walk only
+void hid_equiv_parse_walk(uni_hid_device_t* d, const uint8_t* report, uint16_t report_len);
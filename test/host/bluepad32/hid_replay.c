@@ -0,0 +1,218 @@
+// =============================================================================
+// Bluepad32 HID parser replay
+// =============================================================================
+// Feeds a captured descriptor and input-report stream (see hid_capture.h)
+// through the parser layer the way the BTstack thread does on the robot:
+// uni_hid_parser_compile_plan() once, then uni_hid_parse_input_report() per
+// report, with the 8BitDo parser's callbacks. Prints the decoded gamepad
+// state after every report.
+//
+//   hid_replay <capture.hid>                    print the decoded reports
+//   hid_replay <capture.hid> --golden <file>    compare with a golden output
+//   hid_replay <capture.hid> --equiv <copies>   check the compiled plan against
+//                                               the descriptor walk, on the
+//                                               reports and random copies
+//   hid_replay <capture.hid> --bench <passes>   parse the stream repeatedly with
+//                                               the plan and with the walk,
+//                                               print reports/s
+//   hid_replay <capture.hid> --fuzz-seed <out>  write it as a fuzzer input
+//
+// Regenerate a golden file after an intended change with
+//   hid_replay x.hid > x.golden
+// =============================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hid_capture.h"
+#include "hid_equiv.h"
+#include "parser/uni_hid_parser_8bitdo.h"
+#include "uni_hid_device.h"
+
+static uni_hid_device_t s_device;
+
+static void device_init(const hid_capture_t* cap) {
+    memset(&s_device, 0, sizeof(s_device));
+    memcpy(s_device.hid_descriptor, cap->descriptor, cap->descriptor_len);
+    s_device.hid_descriptor_len = cap->descriptor_len;
+    s_device.report_parser.init_report = uni_hid_parser_8bitdo_init_report;
+    s_device.report_parser.parse_usage = uni_hid_parser_8bitdo_parse_usage;
+    uni_hid_parser_compile_plan(&s_device.report_plan, s_device.hid_descriptor, s_device.hid_descriptor_len);
+}
+
+static void print_state(FILE* out, int index, const hid_capture_report_t* r) {
+    const uni_controller_t* ctl = &s_device.controller;
+    const uni_gamepad_t* gp = &ctl->gamepad;
+    fprintf(out,
+            "%4d id=%02x len=%-3u dpad=%x buttons=%04x misc=%02x axis=%d,%d,%d,%d "
+            "brake=%d throttle=%d battery=%u\n",
+            index, r->data[0], r->len, gp->dpad, gp->buttons, gp->misc_buttons, (int)gp->axis_x, (int)gp->axis_y,
+            (int)gp->axis_rx, (int)gp->axis_ry, (int)gp->brake, (int)gp->throttle, ctl->battery);
+}
+
+static void replay(const hid_capture_t* cap, FILE* out) {
+    fprintf(out, "plan: %s, %d fields, %d report IDs\n", s_device.report_plan.valid ? "compiled" : "descriptor walk",
+            s_device.report_plan.op_count, s_device.report_plan.entry_count);
+    for (int i = 0; i < cap->report_count; i++) {
+        const hid_capture_report_t* r = &cap->reports[i];
+        uni_hid_parse_input_report(&s_device, r->data, r->len);
+        print_state(out, i, r);
+    }
+}
+
+// Line-by-line comparison, reporting the first difference
+static int compare_golden(const char* actual, const char* golden_path) {
+    FILE* f = fopen(golden_path, "r");
+    if (f == NULL) {
+        perror(golden_path);
+        return 1;
+    }
+    int line_no = 0;
+    char expected[512];
+    const char* p = actual;
+    while (fgets(expected, sizeof(expected), f) != NULL) {
+        line_no++;
+        size_t len = strcspn(p, "\n");
+        if (*p == '\0' || strncmp(p, expected, len) != 0 || expected[len] != '\n') {
+            fprintf(stderr, "%s:%d: differs\n  expected: %s  actual:   %.*s\n", golden_path, line_no, expected,
+                    (int)len, *p ? p : "(end of output)");
+            fclose(f);
+            return 1;
+        }
+        p += len + 1;
+    }
+    fclose(f);
+    if (*p != '\0') {
+        fprintf(stderr, "%s: output has more lines than the golden file\n", golden_path);
+        return 1;
+    }
+    printf("%s: %d lines match\n", golden_path, line_no);
+    return 0;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Every report, then "copies" copies of each with random field values
+static int check_equivalence(const hid_capture_t* cap, int copies) {
+    if (!s_device.report_plan.valid) {
+        fprintf(stderr, "descriptor didn't compile into a plan\n");
+        return 1;
+    }
+
+    uint32_t rng = 1;
+    int same = 0;
+    int skipped = 0;
+    for (int i = 0; i < cap->report_count; i++) {
+        hid_capture_report_t r = cap->reports[i];
+        for (int copy = 0; copy <= copies; copy++) {
+            if (copy > 0) {
+                // Keep the report ID, randomize the rest
+                for (int j = 1; j < r.len; j++) {
+                    rng = rng * 1664525u + 1013904223u;
+                    r.data[j] = rng >> 24;
+                }
+            }
+            char why[256];
+            switch (hid_equiv_check(&s_device, r.data, r.len, why, sizeof(why))) {
+                case HID_EQUIV_SAME:
+                    same++;
+                    break;
+                case HID_EQUIV_NOT_COMPARABLE:
+                    skipped++;
+                    break;
+                case HID_EQUIV_DIFFERENT:
+                    fprintf(stderr, "report %d, copy %d: %s\n", i, copy, why);
+                    return 1;
+            }
+        }
+    }
+    printf("plan and descriptor walk agree on %d reports (%d short or unknown ID, not compared)\n", same, skipped);
+    return 0;
+}
+
+// Time whole passes over the stream, after one to warm up
+static double time_passes(const hid_capture_t* cap, int passes, bool walk) {
+    double start = 0;
+    for (int pass = -1; pass < passes; pass++) {
+        if (pass == 0)
+            start = now_seconds();
+        for (int i = 0; i < cap->report_count; i++) {
+            if (walk)
+                hid_equiv_parse_walk(&s_device, cap->reports[i].data, cap->reports[i].len);
+            else
+                uni_hid_parse_input_report(&s_device, cap->reports[i].data, cap->reports[i].len);
+        }
+    }
+    return now_seconds() - start;
+}
+
+static void bench(const hid_capture_t* cap, int passes) {
+    double reports = (double)passes * cap->report_count;
+    double plan = time_passes(cap, passes, false);
+    double walk = time_passes(cap, passes, true);
+    printf("%.0f reports per mode\n", reports);
+    printf("  plan: %10.0f reports/s, %7.1f ns/report\n", reports / plan, plan * 1e9 / reports);
+    printf("  walk: %10.0f reports/s, %7.1f ns/report\n", reports / walk, walk * 1e9 / reports);
+    printf("  plan is %.1fx faster\n", walk / plan);
+}
+
+static int write_fuzz_seed(const hid_capture_t* cap, const char* path) {
+    static uint8_t buf[1 << 20];
+    size_t len = hid_capture_to_fuzz_input(cap, buf, sizeof(buf));
+    FILE* f = fopen(path, "wb");
+    if (len == 0 || f == NULL || fwrite(buf, 1, len, f) != len) {
+        fprintf(stderr, "%s: can't write fuzzer seed\n", path);
+        if (f != NULL)
+            fclose(f);
+        return 1;
+    }
+    fclose(f);
+    return 0;
+}
+
+static int usage(void) {
+    fprintf(stderr,
+            "usage: hid_replay <capture.hid> "
+            "[--golden <file> | --equiv <copies> | --bench <passes> | --fuzz-seed <out>]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 4)
+        return usage();
+
+    hid_capture_t cap;
+    if (hid_capture_load(&cap, argv[1]) != 0)
+        return 1;
+    device_init(&cap);
+
+    int result = 0;
+    if (argc == 2) {
+        replay(&cap, stdout);
+    } else if (strcmp(argv[2], "--golden") == 0) {
+        char* text = NULL;
+        size_t text_len = 0;
+        FILE* out = open_memstream(&text, &text_len);
+        replay(&cap, out);
+        fclose(out);
+        result = compare_golden(text, argv[3]);
+        free(text);
+    } else if (strcmp(argv[2], "--equiv") == 0) {
+        result = check_equivalence(&cap, atoi(argv[3]));
+    } else if (strcmp(argv[2], "--bench") == 0) {
+        bench(&cap, atoi(argv[3]));
+    } else if (strcmp(argv[2], "--fuzz-seed") == 0) {
+        result = write_fuzz_seed(&cap, argv[3]);
+    } else {
+        result = usage();
+    }
+
+    hid_capture_free(&cap);
+    return result;
+}
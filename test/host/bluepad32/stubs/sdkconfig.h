@@ -0,0 +1,6 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF generated sdkconfig.h: Bluepad32's own
+// POSIX target, logging off (uni_log.h defaults to level 0).
+
+#define CONFIG_TARGET_POSIX 1
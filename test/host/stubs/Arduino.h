@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stand-in for <Arduino.h>: only what the modules built by the host
+// tests actually use.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
@@ -0,0 +1,21 @@
+// =============================================================================
+// Host log sink
+// =============================================================================
+// debugLogWrite() for the host tests. Records are not formatted (the format
+// arguments are packed LogArgs); the tag and format string are printed when
+// HOST_LOG is set in the environment, which is enough to see what a module
+// reported.
+// =============================================================================
+
+#include "debug_log.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+void debugLogWrite(int level, const char* tag, const char* format,
+                   const LogArg* args, int argCount) {
+    static const bool enabled = getenv("HOST_LOG") != nullptr;
+    if (enabled) {
+        fprintf(stderr, "  [%d %-10s] %s\n", level, tag, format);
+    }
+}
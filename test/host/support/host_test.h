@@ -0,0 +1,56 @@
+#pragma once
+
+// =============================================================================
+// Host test helpers
+// =============================================================================
+// No framework: each test is a plain executable whose exit code CTest
+// checks. CHECK* macros record a failure and keep going so one run reports
+// every broken expectation.
+//
+// Usage:
+//   static void testSomething() { CHECK_NEAR(f(1.0f), 2.0f, 1e-3f); }
+//   int main() { RUN_TEST(testSomething); return hostTestResult(); }
+// =============================================================================
+
+#include <cmath>
+#include <cstdio>
+
+inline int& hostTestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n",                    \
+                    __FILE__, __LINE__, #cond);                             \
+            hostTestFailures()++;                                           \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tol)                                   \
+    do {                                                                    \
+        double a_ = (double)(actual);                                       \
+        double e_ = (double)(expected);                                     \
+        if (!(std::fabs(a_ - e_) <= (double)(tol))) {                       \
+            fprintf(stderr, "%s:%d: %s = %g, expected %g +- %g\n",          \
+                    __FILE__, __LINE__, #actual, a_, e_, (double)(tol));    \
+            hostTestFailures()++;                                           \
+        }                                                                   \
+    } while (0)
+
+#define RUN_TEST(fn)                                                        \
+    do {                                                                    \
+        int before_ = hostTestFailures();                                   \
+        fn();                                                               \
+        printf("%-40s %s\n", #fn, hostTestFailures() == before_ ? "ok" : "FAILED"); \
+    } while (0)
+
+inline int hostTestResult() {
+    if (hostTestFailures() != 0) {
+        printf("%d check(s) failed\n", hostTestFailures());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+// =============================================================================
+// AttitudeEstimator host test
+// =============================================================================
+// Drives the complementary filter with synthetic IMU traces at the balance
+// task's rate: a known true pitch, the accel/gyro readings it would produce
+// (plus noise, gyro bias and arm-jolt spikes), and checks the fused pitch
+// against the truth. docs/balance.log only has ~2 Hz IMU log lines, too
+// sparse to replay, so the traces are generated here.
+// =============================================================================
+
+#include "attitude_estimator.h"
+#include "config.h"
+#include "host_test.h"
+
+#include <cmath>
+#include <cstdint>
+
+static const float DT = IMU_UPDATE_MS / 1000.0f;
+static const float DEG = 3.14159265f / 180.0f;
+
+// Deterministic noise in [-amp, amp]
+static uint32_t s_rng = 12345;
+static float noise(float amp) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return amp * (2.0f * (float)(s_rng >> 8) / 16777216.0f - 1.0f);
+}
+
+// Angle difference the short way round (rad)
+static float angleDiff(float a, float b) {
+    float d = a - b;
+    while (d > 3.14159265f) { d -= 6.28318531f; }
+    while (d <= -3.14159265f) { d += 6.28318531f; }
+    return d;
+}
+
+// One IMU sample for a robot at `pitch` (rad) turning at `rateDps`.
+// Axis mapping as in BalanceManager::readImu: X = vertical, Y = forward,
+// pitch gyro on Z. jolt adds a non-gravity acceleration (g) along Y/Z.
+struct ImuSample {
+    float ax, ay, az, gyroDps;
+};
+
+static ImuSample sample(float pitch, float rateDps, float biasDps,
+                        float joltY = 0.0f, float joltZ = 0.0f) {
+    ImuSample s;
+    s.ax = cosf(pitch) + noise(0.01f);
+    s.ay = -sinf(pitch) + joltY + noise(0.01f);
+    s.az = joltZ + noise(0.01f);
+    s.gyroDps = rateDps + biasDps + noise(0.3f);
+    return s;
+}
+
+static float feed(AttitudeEstimator& est, const ImuSample& s) {
+    return est.update(s.ax, s.ay, s.az, s.gyroDps, DT);
+}
+
+// Calibrate with the robot still and the given gyro bias
+static void calibrate(AttitudeEstimator& est, float biasDps) {
+    for (int i = 0; i < ATTITUDE_GYRO_CAL_SAMPLES; i++) {
+        est.addCalibrationSample(biasDps + noise(0.3f));
+    }
+    est.finishCalibration();
+}
+
+// -----------------------------------------------------------------------------
+
+static void testCalibrationMeasuresBias() {
+    AttitudeEstimator est;
+    for (int i = 0; i < ATTITUDE_GYRO_CAL_SAMPLES; i++) {
+        est.addCalibrationSample(2.0f + noise(0.3f));
+    }
+    CHECK(est.finishCalibration());
+    CHECK_NEAR(est.getGyroBias() / DEG, 2.0f, 0.1f);
+}
+
+static void testCalibrationRejectsMotion() {
+    AttitudeEstimator est;
+    for (int i = 0; i < ATTITUDE_GYRO_CAL_SAMPLES; i++) {
+        est.addCalibrationSample(10.0f * i / ATTITUDE_GYRO_CAL_SAMPLES);
+    }
+    CHECK(!est.finishCalibration());
+}
+
+static void testStillPitchHeld() {
+    AttitudeEstimator est;
+    calibrate(est, 1.5f);
+    const float truth = -25.0f * DEG;
+    float maxErr = 0.0f;
+    for (int i = 0; i < (int)(10.0f / DT); i++) {
+        float p = feed(est, sample(truth, 0.0f, 1.5f));
+        if (i > (int)(1.0f / DT)) {
+            maxErr = fmaxf(maxErr, fabsf(angleDiff(p, truth)));
+        }
+    }
+    CHECK(maxErr < 0.5f * DEG);
+}
+
+// Arm swings: large non-gravity accelerations for a few ticks at a time.
+// The raw accel pitch jumps by tens of degrees; the fused pitch must not.
+static void testArmJoltRejected() {
+    AttitudeEstimator est;
+    calibrate(est, 0.0f);
+    const float truth = -30.0f * DEG;
+    for (int i = 0; i < (int)(3.0f / DT); i++) {
+        feed(est, sample(truth, 0.0f, 0.0f));
+    }
+
+    float maxErr = 0.0f;
+    float maxAccelErr = 0.0f;
+    int rejected = 0;
+    for (int i = 0; i < (int)(3.0f / DT); i++) {
+        // 50 ms jolt every 500 ms, alternating direction
+        int phase = i % 50;
+        bool jolt = phase < 5;
+        float sign = ((i / 50) & 1) ? -1.0f : 1.0f;
+        ImuSample s = jolt ? sample(truth, 0.0f, 0.0f, 1.5f * sign, 0.6f)
+                           : sample(truth, 0.0f, 0.0f);
+        float p = feed(est, s);
+        maxErr = fmaxf(maxErr, fabsf(angleDiff(p, truth)));
+        maxAccelErr = fmaxf(maxAccelErr, fabsf(angleDiff(est.getAccelPitch(), truth)));
+        if (jolt && !est.isAccelTrusted()) {
+            rejected++;
+        }
+    }
+    CHECK(maxAccelErr > 20.0f * DEG);   // The spikes really are there
+    CHECK(rejected == 6 * 5);           // Every jolt sample gated out
+    CHECK(maxErr < 0.5f * DEG);
+}
+
+// No boot calibration: the bias is learnt from the accelerometer error
+static void testBiasConvergesOnline() {
+    AttitudeEstimator est;
+    const float truth = -10.0f * DEG;
+    const float biasDps = 1.5f;
+    // The bias loop time constant is 1 / (ATTITUDE_BIAS_GAIN * ATTITUDE_TAU_S)
+    const float seconds = 6.0f / (ATTITUDE_BIAS_GAIN * ATTITUDE_TAU_S);
+    float p = 0.0f;
+    for (int i = 0; i < (int)(seconds / DT); i++) {
+        p = feed(est, sample(truth, 0.0f, biasDps));
+    }
+    CHECK_NEAR(est.getGyroBias() / DEG, biasDps, 0.1f);
+    CHECK_NEAR(angleDiff(p, truth) / DEG, 0.0f, 0.2f);
+    CHECK_NEAR(est.getPitchRate() / DEG, 0.0f, 0.5f);
+}
+
+// Tip from level to -60 deg at 60 deg/s, then hold
+static void testTracksRotation() {
+    AttitudeEstimator est;
+    calibrate(est, 0.8f);
+    float truth = 0.0f;
+    for (int i = 0; i < (int)(1.0f / DT); i++) {
+        feed(est, sample(truth, 0.0f, 0.8f));
+    }
+    float maxErr = 0.0f;
+    for (int i = 0; i < (int)(2.0f / DT); i++) {
+        float rateDps = (truth > -60.0f * DEG) ? -60.0f : 0.0f;
+        truth += rateDps * DEG * DT;
+        float p = feed(est, sample(truth, rateDps, 0.8f));
+        maxErr = fmaxf(maxErr, fabsf(angleDiff(p, truth)));
+    }
+    CHECK(maxErr < 1.0f * DEG);
+}
+
+// Upside-down: rotate through +-180 deg. The estimate must cross the wrap
+// the short way and stay in (-pi, pi].
+static void testWrapThroughPi() {
+    AttitudeEstimator est;
+    calibrate(est, 0.0f);
+    float truth = 170.0f * DEG;
+    for (int i = 0; i < (int)(2.0f / DT); i++) {
+        feed(est, sample(truth, 0.0f, 0.0f));
+    }
+    float maxErr = 0.0f;
+    bool inRange = true;
+    for (int i = 0; i < (int)(2.0f / DT); i++) {
+        truth += 20.0f * DEG * DT;
+        if (truth > 3.14159265f) {
+            truth -= 6.28318531f;
+        }
+        float p = feed(est, sample(truth, 20.0f, 0.0f));
+        maxErr = fmaxf(maxErr, fabsf(angleDiff(p, truth)));
+        inRange = inRange && p > -3.14159265f && p <= 3.14159265f;
+    }
+    CHECK(truth < -140.0f * DEG);       // Really went through the wrap
+    CHECK(inRange);
+    CHECK(maxErr < 1.0f * DEG);
+}
+
+static void testResetRestartsFromAccel() {
+    AttitudeEstimator est;
+    calibrate(est, 0.0f);
+    for (int i = 0; i < 100; i++) {
+        feed(est, sample(0.0f, 0.0f, 0.0f));
+    }
+    est.reset();
+    float p = feed(est, sample(-45.0f * DEG, 0.0f, 0.0f));
+    CHECK_NEAR(p / DEG, -45.0f, 1.5f);
+}
+
+int main() {
+    RUN_TEST(testCalibrationMeasuresBias);
+    RUN_TEST(testCalibrationRejectsMotion);
+    RUN_TEST(testStillPitchHeld);
+    RUN_TEST(testArmJoltRejected);
+    RUN_TEST(testBiasConvergesOnline);
+    RUN_TEST(testTracksRotation);
+    RUN_TEST(testWrapThroughPi);
+    RUN_TEST(testResetRestartsFromAccel);
+    return hostTestResult();
+}
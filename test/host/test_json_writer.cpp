@@ -0,0 +1,267 @@
+// =============================================================================
+// JsonWriter host test
+// =============================================================================
+// Checks the serializer's output byte for byte, and that everything it
+// writes parses as JSON (small validator below), including after overflow
+// is flagged.
+// =============================================================================
+
+#include "json_writer.h"
+#include "host_test.h"
+
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+// -----------------------------------------------------------------------------
+// Minimal JSON validator (RFC 8259 grammar, no semantic checks)
+// -----------------------------------------------------------------------------
+
+static bool parseValue(const char*& p, int depth);
+
+static void skipWs(const char*& p) {
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') { p++; }
+}
+
+static bool parseString(const char*& p) {
+    if (*p != '"') { return false; }
+    p++;
+    while (*p != '"') {
+        unsigned char c = (unsigned char)*p;
+        if (c == '\0' || c < 0x20) { return false; }
+        if (c == '\\') {
+            p++;
+            if (*p == 'u') {
+                for (int i = 1; i <= 4; i++) {
+                    if (!isxdigit((unsigned char)p[i])) { return false; }
+                }
+                p += 4;
+            } else if (!strchr("\"\\/bfnrt", *p) || *p == '\0') {
+                return false;
+            }
+        }
+        p++;
+    }
+    p++;
+    return true;
+}
+
+static bool parseNumber(const char*& p) {
+    if (*p == '-') { p++; }
+    if (*p == '0') {
+        p++;
+    } else if (isdigit((unsigned char)*p)) {
+        while (isdigit((unsigned char)*p)) { p++; }
+    } else {
+        return false;
+    }
+    if (*p == '.') {
+        p++;
+        if (!isdigit((unsigned char)*p)) { return false; }
+        while (isdigit((unsigned char)*p)) { p++; }
+    }
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        if (*p == '+' || *p == '-') { p++; }
+        if (!isdigit((unsigned char)*p)) { return false; }
+        while (isdigit((unsigned char)*p)) { p++; }
+    }
+    return true;
+}
+
+static bool parseContainer(const char*& p, int depth, char close, bool object) {
+    p++;
+    skipWs(p);
+    if (*p == close) { p++; return true; }
+    for (;;) {
+        skipWs(p);
+        if (object) {
+            if (!parseString(p)) { return false; }
+            skipWs(p);
+            if (*p != ':') { return false; }
+            p++;
+        }
+        if (!parseValue(p, depth + 1)) { return false; }
+        skipWs(p);
+        if (*p == ',') { p++; continue; }
+        if (*p == close) { p++; return true; }
+        return false;
+    }
+}
+
+static bool parseValue(const char*& p, int depth) {
+    if (depth > 64) { return false; }
+    skipWs(p);
+    switch (*p) {
+        case '{': return parseContainer(p, depth, '}', true);
+        case '[': return parseContainer(p, depth, ']', false);
+        case '"': return parseString(p);
+        case 't': if (strncmp(p, "true", 4) == 0)  { p += 4; return true; } return false;
+        case 'f': if (strncmp(p, "false", 5) == 0) { p += 5; return true; } return false;
+        case 'n': if (strncmp(p, "null", 4) == 0)  { p += 4; return true; } return false;
+        default:  return parseNumber(p);
+    }
+}
+
+static bool isValidJson(const char* s) {
+    const char* p = s;
+    if (!parseValue(p, 0)) { return false; }
+    skipWs(p);
+    return *p == '\0';
+}
+
+// -----------------------------------------------------------------------------
+
+static void testNestingAndCommas() {
+    char buf[256];
+    JsonWriter w(buf, sizeof(buf));
+    w.beginObject();
+    w.field("a", 1);
+    w.beginArray("list");
+    w.value(1);
+    w.beginObject();
+    w.endObject();
+    w.beginArray();
+    w.endArray();
+    w.value("x");
+    w.endArray();
+    w.beginObject("o");
+    w.field("b", true);
+    w.key("n");
+    w.null();
+    w.endObject();
+    w.endObject();
+    CHECK(!w.overflowed());
+    CHECK(strcmp(w.c_str(), "{\"a\":1,\"list\":[1,{},[],\"x\"],\"o\":{\"b\":true,\"n\":null}}") == 0);
+    CHECK(w.length() == strlen(w.c_str()));
+    CHECK(isValidJson(w.c_str()));
+}
+
+static void testIntegers() {
+    char buf[256];
+    JsonWriter w(buf, sizeof(buf));
+    w.beginArray();
+    w.value(0);
+    w.value(-1);
+    w.value(INT_MIN);
+    w.value(UINT_MAX);
+    w.value(LONG_MIN);
+    w.value(ULONG_MAX);
+    w.endArray();
+    char expected[256];
+    snprintf(expected, sizeof(expected), "[0,-1,%d,%u,%ld,%lu]",
+             INT_MIN, UINT_MAX, LONG_MIN, ULONG_MAX);
+    CHECK(strcmp(w.c_str(), expected) == 0);
+    CHECK(isValidJson(w.c_str()));
+}
+
+static void testFloats() {
+    char buf[256];
+    JsonWriter w(buf, sizeof(buf));
+    w.beginArray();
+    w.value(1.2345f, 3);
+    w.value(-0.5f, 2);
+    w.value(-0.001f, 2);        // Rounds to zero: no "-0.00"
+    w.value(2.999f, 2);         // Carries into the integer part
+    w.value(42.0f, 0);
+    w.value(NAN, 2);
+    w.value(INFINITY, 2);
+    w.value(3e12f, 2);          // Too large for fixed point
+    w.endArray();
+    CHECK(strcmp(w.c_str(), "[1.235,-0.50,0.00,3.00,42,null,null,3.00000005e+12]") == 0);
+    CHECK(isValidJson(w.c_str()));
+}
+
+// Decimal output must match printf("%.*f") across the range the firmware uses
+static void testFloatsMatchPrintf() {
+    char buf[64];
+    char expected[64];
+    int mismatches = 0;
+    for (int i = -200000; i <= 200000; i += 7) {
+        float v = (float)i / 997.0f;
+        for (int decimals = 0; decimals <= 3; decimals++) {
+            JsonWriter w(buf, sizeof(buf));
+            w.value(v, decimals);
+            snprintf(expected, sizeof(expected), "%.*f", decimals, (double)v);
+            if (strcmp(expected, "-0") == 0 || strncmp(expected, "-0.0", 4) == 0) {
+                // printf keeps the sign of a value that rounds to zero
+                bool allZero = strspn(expected + 1, "0.") == strlen(expected + 1);
+                if (allZero) { memmove(expected, expected + 1, strlen(expected)); }
+            }
+            if (strcmp(w.c_str(), expected) != 0) {
+                if (mismatches++ < 5) {
+                    fprintf(stderr, "  %.9g/%d: got %s, printf %s\n", v, decimals, w.c_str(), expected);
+                }
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+static void testStringEscapes() {
+    char buf[256];
+    JsonWriter w(buf, sizeof(buf));
+    w.beginObject();
+    w.field("q\"k", "a\"b\\c\nd\re\tf\x01g");
+    w.field("null", (const char*)nullptr);
+    w.endObject();
+    CHECK(strcmp(w.c_str(), "{\"q\\\"k\":\"a\\\"b\\\\c\\nd\\re\\tf\\u0001g\",\"null\":null}") == 0);
+    CHECK(isValidJson(w.c_str()));
+}
+
+// Every buffer size up to the full length: either the whole document or a
+// flagged, NUL-terminated prefix -- never a write past the end
+static void testOverflowAtEverySize() {
+    char full[256];
+    JsonWriter ref(full, sizeof(full));
+    ref.beginObject();
+    ref.field("name", "motor \"L\"");
+    ref.beginArray("v");
+    for (int i = 0; i < 5; i++) { ref.value(i * 1.5f, 2); }
+    ref.endArray();
+    ref.endObject();
+    CHECK(!ref.overflowed());
+    size_t fullLen = ref.length();
+
+    bool ok = true;
+    for (size_t size = 0; size <= fullLen + 1; size++) {
+        char buf[260];
+        memset(buf, 0x7E, sizeof(buf));
+        JsonWriter w(buf, size);
+        w.beginObject();
+        w.field("name", "motor \"L\"");
+        w.beginArray("v");
+        for (int i = 0; i < 5; i++) { w.value(i * 1.5f, 2); }
+        w.endArray();
+        w.endObject();
+
+        bool fits = size >= fullLen + 1;
+        if (w.overflowed() == fits) { ok = false; }
+        if (buf[size] != 0x7E) { ok = false; }                 // Guard byte intact
+        if (size > 0 && strlen(buf) != w.length()) { ok = false; }
+        if (size > 0 && strncmp(buf, full, w.length()) != 0) { ok = false; }
+        if (fits && strcmp(buf, full) != 0) { ok = false; }
+    }
+    CHECK(ok);
+}
+
+static void testDepthLimit() {
+    char buf[256];
+    JsonWriter w(buf, sizeof(buf));
+    for (int i = 0; i < 17; i++) {
+        w.beginArray();
+    }
+    CHECK(w.overflowed());
+}
+
+int main() {
+    RUN_TEST(testNestingAndCommas);
+    RUN_TEST(testIntegers);
+    RUN_TEST(testFloats);
+    RUN_TEST(testFloatsMatchPrintf);
+    RUN_TEST(testStringEscapes);
+    RUN_TEST(testOverflowAtEverySize);
+    RUN_TEST(testDepthLimit);
+    return hostTestResult();
+}
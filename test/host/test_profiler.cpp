@@ -0,0 +1,125 @@
+// =============================================================================
+// LatencyHistogram host test
+// =============================================================================
+// Percentiles from known sample sets, and the window totals with the writer
+// running on another thread while the reader drains windows, as the drive
+// task and the loop do on the robot.
+// =============================================================================
+
+#include "profiler.h"
+#include "host_test.h"
+
+#include <atomic>
+#include <thread>
+
+static void testPercentiles() {
+    LatencyHistogram h;
+    for (uint32_t us = 1; us <= 100; us++) {
+        h.record(us * 10);
+    }
+    ProfileStats s;
+    h.getStats(&s);
+    CHECK(s.count == 100);
+    CHECK(s.max == 1000);
+    // Reported as the top of the bucket holding the rank (<= 25% wide)
+    CHECK(s.p50 >= 500 && s.p50 <= 500 * 5 / 4);
+    CHECK(s.p90 >= 900 && s.p90 <= 1000);
+    CHECK(s.p99 >= 990 && s.p99 <= 1000);
+}
+
+// Sub-microsecond stages record 0; that is a real percentile, not "unset"
+static void testZeroPercentiles() {
+    LatencyHistogram h;
+    for (int i = 0; i < 95; i++) {
+        h.record(0);
+    }
+    for (int i = 0; i < 5; i++) {
+        h.record(1000);
+    }
+    ProfileStats s;
+    h.getStats(&s);
+    CHECK(s.p50 == 0);
+    CHECK(s.p90 == 0);
+    CHECK(s.p99 >= 1000);
+}
+
+static void testResetAppliedByWriter() {
+    LatencyHistogram h;
+    h.record(50);
+    h.reset();
+    ProfileStats s;
+    h.getStats(&s);
+    CHECK(s.count == 0);
+    h.record(7);
+    h.getStats(&s);
+    CHECK(s.count == 1);
+    CHECK(s.max == 7);
+}
+
+static void testWindowMaxRestarts() {
+    LatencyHistogram h;
+    h.record(100);
+    h.record(900);
+    ProfileWindow w = h.takeWindow();
+    CHECK(w.count == 2);
+    CHECK(w.sumUs == 1000);
+    CHECK(w.maxUs == 900);
+
+    w = h.takeWindow();
+    CHECK(w.count == 0);
+    CHECK(w.maxUs == 0);
+
+    h.record(30);
+    h.record(20);
+    w = h.takeWindow();
+    CHECK(w.count == 2);
+    CHECK(w.sumUs == 50);
+    CHECK(w.maxUs == 30);
+}
+
+// Writer and reader on different threads: every sample lands in exactly one
+// window, and no window reports a max it cannot have seen
+static void testWindowsUnderConcurrentWriter() {
+    LatencyHistogram h;
+    const uint32_t samples = 2000000;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (uint32_t i = 0; i < samples; i++) {
+            h.record(1 + (i % 64));
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    bool maxOk = true;
+    for (;;) {
+        bool last = done.load(std::memory_order_acquire);
+        ProfileWindow w = h.takeWindow();
+        count += w.count;
+        sum += w.sumUs;
+        maxOk = maxOk && w.maxUs <= 64;
+        if (last) {
+            break;
+        }
+    }
+    writer.join();
+
+    uint64_t expectedSum = 0;
+    for (uint32_t i = 0; i < samples; i++) {
+        expectedSum += 1 + (i % 64);
+    }
+    CHECK(count == samples);
+    CHECK(sum == expectedSum);
+    CHECK(maxOk);
+}
+
+int main() {
+    RUN_TEST(testPercentiles);
+    RUN_TEST(testZeroPercentiles);
+    RUN_TEST(testResetAppliedByWriter);
+    RUN_TEST(testWindowMaxRestarts);
+    RUN_TEST(testWindowsUnderConcurrentWriter);
+    return hostTestResult();
+}
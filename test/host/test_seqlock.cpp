@@ -0,0 +1,148 @@
+// =============================================================================
+// SeqLock host test
+// =============================================================================
+// One writer thread publishing while a reader thread copies, over a struct
+// whose fields all carry the publish number: any copy mixing two publishes
+// shows up as a field that disagrees. Covers store()/load() and the in-place
+// beginWrite()/endWrite() with read(fn), as the balance task, the display
+// snapshot and the motor table use them on the robot.
+//
+// The writer and the reader yield halfway through their copies, so that
+// even on a single core the other side runs while a slot is half-written
+// or half-read.
+// =============================================================================
+
+#include "seqlock.h"
+#include "host_test.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+static const int FIELDS = 64;
+static const uint32_t READS = 200000;
+
+struct Sample {
+    uint32_t seq;               // Publish number, 1-based
+    uint32_t fields[FIELDS];    // seq * 1000 + index
+};
+
+static void fill(Sample* s, uint32_t seq, bool yieldHalfway) {
+    s->seq = seq;
+    for (int i = 0; i < FIELDS; i++) {
+        if (yieldHalfway && i == FIELDS / 2) {
+            std::this_thread::yield();
+        }
+        s->fields[i] = seq * 1000 + i;
+    }
+}
+
+static bool coherent(const Sample& s) {
+    for (int i = 0; i < FIELDS; i++) {
+        if (s.fields[i] != s.seq * 1000 + i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testInitialAndSequential() {
+    SeqLock<Sample> lock;
+    Sample s = lock.load();
+    CHECK(lock.sequence() == 0);
+    CHECK(s.seq == 0 && s.fields[0] == 0);
+
+    Sample v;
+    fill(&v, 1, false);
+    lock.store(v);
+    CHECK(lock.sequence() == 1);
+    CHECK(lock.load(&s) == 1);
+    CHECK(s.seq == 1 && coherent(s));
+
+    // In place: the back slot holds the value from two publishes ago, so
+    // every field has to be rewritten
+    Sample* back = lock.beginWrite();
+    CHECK(back->seq == 0);
+    fill(back, 2, false);
+    lock.endWrite();
+    CHECK(lock.sequence() == 2);
+    uint32_t got = lock.read([&](const Sample& value) { s = value; });
+    CHECK(got == 2);
+    CHECK(s.seq == 2 && coherent(s));
+}
+
+// Writer alternates store() and beginWrite()/endWrite() until the reader is
+// done; the reader alternates load() and read(fn). Every copy must be one
+// whole publish, match the sequence number returned with it, and never go
+// backwards.
+static void testConcurrentWriterAndReader() {
+    SeqLock<Sample> lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> published{0};
+
+    std::thread writer([&] {
+        Sample v;
+        for (uint32_t seq = 1; !done.load(std::memory_order_acquire); seq++) {
+            bool yieldHalfway = (seq % 16) == 0;
+            if (seq & 1) {
+                fill(&v, seq, yieldHalfway);
+                lock.store(v);
+            } else {
+                fill(lock.beginWrite(), seq, yieldHalfway);
+                lock.endWrite();
+            }
+            published.store(seq, std::memory_order_relaxed);
+        }
+    });
+
+    uint32_t reads = 0;
+    uint32_t passes = 0;
+    uint32_t torn = 0;
+    uint32_t mismatched = 0;
+    uint32_t backwards = 0;
+    uint32_t last = 0;
+    while (reads < READS) {
+        Sample s;
+        uint32_t seq;
+        if (reads & 1) {
+            seq = lock.load(&s);
+            passes++;
+        } else {
+            // Yield on the first pass only: the writer publishes during the
+            // yield, so yielding on every pass would retry forever
+            bool yieldHalfway = (reads % 16) == 0;
+            seq = lock.read([&](const Sample& value) {
+                passes++;
+                s.seq = value.seq;
+                for (int i = 0; i < FIELDS; i++) {
+                    if (i == FIELDS / 2 && yieldHalfway) {
+                        yieldHalfway = false;
+                        std::this_thread::yield();
+                    }
+                    s.fields[i] = value.fields[i];
+                }
+            });
+        }
+        reads++;
+        torn += coherent(s) ? 0 : 1;
+        mismatched += (s.seq == seq) ? 0 : 1;
+        backwards += (seq < last) ? 1 : 0;
+        last = seq;
+    }
+    done.store(true, std::memory_order_release);
+    writer.join();
+
+    printf("  %u reads of %u publishes, %u read(fn) retries\n", reads, published.load(), passes - reads);
+    CHECK(torn == 0);
+    CHECK(mismatched == 0);
+    CHECK(backwards == 0);
+    CHECK(lock.sequence() == published.load());
+    CHECK(lock.load().seq == published.load());
+}
+
+int main() {
+    RUN_TEST(testInitialAndSequential);
+    RUN_TEST(testConcurrentWriterAndReader);
+    return hostTestResult();
+}
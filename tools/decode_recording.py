@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Decode a JumpRopeStick flight recording (/recording.bin) to CSV.
+
+Usage:
+    curl -o recording.bin http://<robot-ip>/recording.bin
+    python3 tools/decode_recording.py recording.bin > recording.csv
+    python3 tools/decode_recording.py recording.bin -o recording.csv
+
+Layout matches FlightRecordingHeader / FlightRecord in main/flight_recorder.h
+(version 1, little-endian). Angles are written in radians as recorded; the
+right-arm feedback columns are in the raw motor frame (negated vs. target).
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+MAGIC = 0x5246524A  # "JRFR"
+VERSION = 1
+
+HEADER = struct.Struct("<IHHII")
+RECORD = struct.Struct("<II16fHHB3x")
+
+FIELDS = [
+    "seq", "timestamp_us",
+    "pitch", "accel_pitch", "pitch_rate", "dt",
+    "error", "pid_out", "integral", "ramp",
+    "left_target", "right_target",
+    "left_pos", "right_pos", "left_vel", "right_vel", "left_torque", "right_torque",
+    "left_fb_age_us", "right_fb_age_us",
+    "flags",
+]
+
+FLAG_NAMES = [
+    (0x01, "balancing"),
+    (0x02, "upside_down"),
+    (0x04, "accel_trusted"),
+    (0x08, "trigger"),
+]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="recording.bin downloaded from the robot")
+    parser.add_argument("-o", "--output", help="CSV file (default: stdout)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    if len(data) < HEADER.size:
+        sys.exit("file too short for a header")
+    magic, version, record_size, count, period_us = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        sys.exit("bad magic 0x%08x (not a flight recording)" % magic)
+    if version != VERSION or record_size != RECORD.size:
+        sys.exit("unsupported recording: version %d, %d-byte records (expected %d, %d)"
+                 % (version, record_size, VERSION, RECORD.size))
+
+    body = data[HEADER.size:]
+    n = len(body) // RECORD.size
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(["t_s"] + FIELDS + [name for _, name in FLAG_NAMES])
+
+    t0 = None
+    prev_seq = None
+    gaps = 0
+    for i in range(n):
+        row = RECORD.unpack_from(body, i * RECORD.size)
+        seq, ts = row[0], row[1]
+        if prev_seq is not None and seq != prev_seq + 1:
+            gaps += 1
+        prev_seq = seq
+        if t0 is None:
+            t0 = ts
+        t = ((ts - t0) & 0xFFFFFFFF) / 1e6
+        flags = row[-1]
+        writer.writerow(["%.6f" % t] + list(row) + [1 if flags & bit else 0 for bit, _ in FLAG_NAMES])
+
+    if out is not sys.stdout:
+        out.close()
+    print("%d records (header said %d), period %d us, %d gap(s)" % (n, count, period_us, gaps),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()